@@ -45,7 +45,11 @@ inline void addPipelineConvertToQIR(mlir::PassManager &pm,
 
 void addLowerToCCPipeline(mlir::OpPassManager &pm);
 
-void addPipelineTranslateToOpenQASM(mlir::PassManager &pm);
+/// \brief Pipeline builder to prepare Quake for the OpenQASM translation.
+/// \p statePrepOptions configure the synthesis of the state initializations.
+void addPipelineTranslateToOpenQASM(
+    mlir::PassManager &pm,
+    const StatePreparationOptions &statePrepOptions = {});
 void addPipelineTranslateToIQMJson(mlir::PassManager &pm);
 
 } // namespace cudaq::opt
@@ -10,6 +10,8 @@
 
 #include "cudaq/ADT/GraphCSR.h"
 #include "cudaq/Support/Graph.h"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/Support/MemoryBuffer.h"
 
 namespace cudaq {
@@ -75,7 +77,6 @@ public:
       }
     }
 
-    device.computeAllPairShortestPaths();
     return device;
   }
 
@@ -91,7 +92,6 @@ public:
       device.topology.createNode();
       device.topology.addEdge(Qubit(i - 1), Qubit(i));
     }
-    device.computeAllPairShortestPaths();
     return device;
   }
 
@@ -109,7 +109,6 @@ public:
         device.topology.createNode();
       device.topology.addEdge(Qubit(i), Qubit((i + 1) % numQubits));
     }
-    device.computeAllPairShortestPaths();
     return device;
   }
 
@@ -135,7 +134,6 @@ public:
       if (i != centerQubit)
         device.topology.addEdge(Qubit(centerQubit), Qubit(i));
 
-    device.computeAllPairShortestPaths();
     return device;
   }
 
@@ -161,7 +159,6 @@ public:
           device.topology.addEdge(q0, Qubit(base + width));
       }
     }
-    device.computeAllPairShortestPaths();
     return device;
   }
 
@@ -205,19 +202,26 @@ public:
         device.topology.addEdge(Qubit(row), Qubit(col), /*undirected=*/false);
     }
 
-    device.computeAllPairShortestPaths();
     return device;
   }
 
-  /// TODO: Implement a method to load device info from a file.
-
   /// Returns the number of physical qubits in the device.
   unsigned getNumQubits() const { return topology.getNumNodes(); }
 
   /// Returns the distance between two qubits.
   unsigned getDistance(Qubit src, Qubit dst) const {
-    unsigned pairID = getPairID(src.index, dst.index);
-    return src == dst ? 0 : shortestPaths[pairID].size() - 1;
+    if (src == dst)
+      return 0;
+    // Distances are symmetric, so on large devices reuse a cached tree rooted
+    // at either end, or else grow one from `src`, which callers (e.g. SABRE
+    // cost functions) tend to query repeatedly.
+    if (getNumQubits() > denseTableMaxQubits) {
+      if (auto iter = lazySlotOf.find(dst.index); iter != lazySlotOf.end())
+        return lazyDistances[iter->second * getNumQubits() + src.index];
+      return getShortestPathTree(src.index).distances[dst.index];
+    }
+    auto [root, other] = std::minmax(src.index, dst.index);
+    return getShortestPathTree(root).distances[other];
   }
 
   mlir::ArrayRef<Qubit> getNeighbours(Qubit src) const {
@@ -225,15 +229,27 @@ public:
   }
 
   bool areConnected(Qubit q0, Qubit q1) const {
-    return getDistance(q0, q1) == 1;
+    return llvm::is_contained(getNeighbours(q0), q1) ||
+           llvm::is_contained(getNeighbours(q1), q0);
   }
 
   /// Returns a shortest path between two qubits.
   Path getShortestPath(Qubit src, Qubit dst) const {
-    unsigned pairID = getPairID(src.index, dst.index);
-    if (src.index > dst.index)
-      return Path(llvm::reverse(shortestPaths[pairID]));
-    return Path(shortestPaths[pairID]);
+    auto [root, other] = std::minmax(src.index, dst.index);
+    auto tree = getShortestPathTree(root);
+    // Walk from `other` towards `root` following the next-hop table. This
+    // yields the path in `dst -> src` order when `src` is the root.
+    Path path;
+    path.reserve(tree.distances[other] + 1);
+    Qubit q(other);
+    path.push_back(q);
+    while (q != Qubit(root)) {
+      q = tree.nextHop[q.index];
+      path.push_back(q);
+    }
+    if (src.index == root)
+      std::reverse(path.begin(), path.end());
+    return path;
   }
 
   void dump(llvm::raw_ostream &os = llvm::errs()) const {
@@ -249,51 +265,112 @@ public:
       }
   }
 
-private:
-  using PathRef = mlir::ArrayRef<Qubit>;
-
-  /// Returns a unique id for a pair of values (`u` and `v`). `getPairID(u, v)`
-  /// will be equal to `getPairID(v, u)`.
-  unsigned getPairID(unsigned u, unsigned v) const {
-    if (u > v)
-      std::swap(u, v);
-    return (u * getNumQubits()) - (((u - 1) * u) / 2) + v - u;
+  /// Returns the number of BFS trees currently held, in the dense table or in
+  /// the bounded cache.
+  unsigned getNumShortestPathTrees() const {
+    if (getNumQubits() <= denseTableMaxQubits)
+      return denseRowComputed.count();
+    return lazyRoots.size();
   }
 
-  /// Compute the shortest path between every qubit. This assumes that there
-  /// exists at least one path between every source and destination pair. I.e.
-  /// the graph cannot be bipartite.
-  void computeAllPairShortestPaths() {
-    std::size_t numNodes = topology.getNumNodes();
-    shortestPaths.resize(numNodes * (numNodes + 1) / 2);
-    mlir::SmallVector<Qubit> path(numNodes);
-    for (unsigned n = 0; n < numNodes; ++n) {
-      auto parents = getShortestPathsBFS(topology, Qubit(n));
-      // Reconstruct the paths
-      for (auto m = n + 1; m < numNodes; ++m) {
-        path.clear();
-        path.push_back(Qubit(m));
-        auto p = parents[m];
-        while (p != Qubit(n)) {
-          path.push_back(p);
-          p = parents[p.index];
-        }
-        path.push_back(Qubit(n));
-        pathsData.append(path.rbegin(), path.rend());
-        shortestPaths[getPairID(n, m)] =
-            PathRef(pathsData.end() - path.size(), pathsData.end());
+  /// Devices with at most this many qubits keep a dense `N x N` distance and
+  /// next-hop table (filled one row at a time, on demand). Larger devices use
+  /// a bounded cache of per-source BFS trees instead.
+  static constexpr unsigned denseTableMaxQubits = 2048;
+
+  /// Maximum number of BFS trees kept alive at any time for devices larger
+  /// than `denseTableMaxQubits`.
+  static constexpr unsigned lazyCacheMaxTrees = 256;
+
+private:
+  /// The BFS tree rooted at some qubit `r`. `nextHop[q]` is the next qubit on a
+  /// shortest path from `q` to `r` and `distances[q]` the number of hops.
+  struct ShortestPathTree {
+    mlir::ArrayRef<Qubit> nextHop;
+    mlir::ArrayRef<unsigned> distances;
+  };
+
+  /// Returns the BFS tree rooted at \p root, computing it if needed. This
+  /// assumes that there exists at least one path between every source and
+  /// destination pair. I.e. the graph must be connected.
+  ///
+  /// Distances are symmetric and we always root the tree at the smaller of the
+  /// two qubit indices, so that `getShortestPath(u, v)` is the reverse of
+  /// `getShortestPath(v, u)`.
+  ///
+  /// Note: the tables are filled lazily through a `const` interface, so a
+  /// `Device` must not be queried concurrently from multiple threads.
+  ShortestPathTree getShortestPathTree(unsigned root) const {
+    const std::size_t numNodes = getNumQubits();
+    assert(root < numNodes && "Invalid qubit");
+    if (numNodes <= denseTableMaxQubits) {
+      if (denseNextHop.empty()) {
+        denseNextHop.resize(numNodes * numNodes);
+        denseDistances.resize(numNodes * numNodes);
+        denseRowComputed.resize(numNodes);
+      }
+      mlir::MutableArrayRef<Qubit> nextHop(&denseNextHop[root * numNodes],
+                                           numNodes);
+      mlir::MutableArrayRef<unsigned> distances(
+          &denseDistances[root * numNodes], numNodes);
+      if (!denseRowComputed.test(root)) {
+        getShortestPathsBFS(topology, Qubit(root), nextHop, distances,
+                            bfsQueue);
+        denseRowComputed.set(root);
+      }
+      return {nextHop, distances};
+    }
+
+    // Sparse/large device: look up the tree in the cache, evicting the oldest
+    // entry (FIFO) when the cache is full.
+    auto iter = lazySlotOf.find(root);
+    unsigned slot;
+    if (iter != lazySlotOf.end()) {
+      slot = iter->second;
+    } else {
+      if (lazyRoots.size() < lazyCacheMaxTrees) {
+        slot = lazyRoots.size();
+        lazyRoots.push_back(root);
+        lazyNextHop.resize(lazyRoots.size() * numNodes);
+        lazyDistances.resize(lazyRoots.size() * numNodes);
+      } else {
+        slot = lazyNextEvict;
+        lazyNextEvict = (lazyNextEvict + 1) % lazyCacheMaxTrees;
+        lazySlotOf.erase(lazyRoots[slot]);
+        lazyRoots[slot] = root;
       }
+      lazySlotOf[root] = slot;
+      getShortestPathsBFS(
+          topology, Qubit(root),
+          mlir::MutableArrayRef<Qubit>(&lazyNextHop[slot * numNodes], numNodes),
+          mlir::MutableArrayRef<unsigned>(&lazyDistances[slot * numNodes],
+                                          numNodes),
+          bfsQueue);
     }
+    return {mlir::ArrayRef<Qubit>(&lazyNextHop[slot * numNodes], numNodes),
+            mlir::ArrayRef<unsigned>(&lazyDistances[slot * numNodes],
+                                     numNodes)};
   }
 
   /// Device nodes (qubits) and edges (connections)
   GraphCSR topology;
 
-  /// List of shortest path from/to every source/destination
-  mlir::SmallVector<PathRef> shortestPaths;
-
-  /// Storage for `PathRef`'s in `shortestPaths`
-  mlir::SmallVector<Qubit> pathsData;
+  /// Dense row-major `N x N` tables for small devices. Row `r` holds the BFS
+  /// tree rooted at qubit `r`.
+  mutable mlir::SmallVector<Qubit, 0> denseNextHop;
+  mutable mlir::SmallVector<unsigned, 0> denseDistances;
+  mutable llvm::BitVector denseRowComputed;
+
+  /// Bounded cache of BFS trees for large devices. `lazyRoots[s]` is the root
+  /// of the tree stored in slot `s`.
+  mutable mlir::SmallVector<Qubit, 0> lazyNextHop;
+  mutable mlir::SmallVector<unsigned, 0> lazyDistances;
+  mutable mlir::SmallVector<unsigned> lazyRoots;
+  mutable llvm::DenseMap<unsigned, unsigned> lazySlotOf;
+  mutable unsigned lazyNextEvict = 0;
+
+  /// Scratch space for the BFS.
+  mutable mlir::SmallVector<Qubit, 0> bfsQueue;
 };
 
 } // namespace cudaq
@@ -9,6 +9,8 @@
 #pragma once
 
 #include "cudaq/ADT/GraphCSR.h"
+#include <algorithm>
+#include <limits>
 
 namespace cudaq {
 
@@ -16,8 +18,8 @@ namespace cudaq {
 /// \p graph. The return vector `vec[i]` contains the next node in path to
 /// `src`. If `vec[i] == src`, then it is either an immediate neighbor, or there
 /// is no path to get there (i.e. the graph is bipartite).
-mlir::SmallVector<GraphCSR::Node> getShortestPathsBFS(const GraphCSR &graph,
-                                                      GraphCSR::Node src) {
+inline mlir::SmallVector<GraphCSR::Node>
+getShortestPathsBFS(const GraphCSR &graph, GraphCSR::Node src) {
   assert(src.isValid() && "Invalid source node");
   mlir::SmallVector<bool> discovered(graph.getNumNodes(), false);
   mlir::SmallVector<GraphCSR::Node> parents(graph.getNumNodes(), src);
@@ -38,4 +40,35 @@ mlir::SmallVector<GraphCSR::Node> getShortestPathsBFS(const GraphCSR &graph,
   return parents;
 }
 
+/// Same as above, but writes the result into caller-provided storage and also
+/// records the hop count from \p src in \p distances. Nodes that cannot be
+/// reached from \p src are left with a distance of `UINT_MAX`. Both \p parents
+/// and \p distances must have `graph.getNumNodes()` elements. \p queue is
+/// scratch space that can be reused across calls to avoid reallocations.
+inline void getShortestPathsBFS(const GraphCSR &graph, GraphCSR::Node src,
+                                mlir::MutableArrayRef<GraphCSR::Node> parents,
+                                mlir::MutableArrayRef<unsigned> distances,
+                                mlir::SmallVectorImpl<GraphCSR::Node> &queue) {
+  assert(src.isValid() && "Invalid source node");
+  assert(parents.size() == graph.getNumNodes() &&
+         distances.size() == graph.getNumNodes() && "Invalid output storage");
+  std::fill(parents.begin(), parents.end(), src);
+  std::fill(distances.begin(), distances.end(),
+            std::numeric_limits<unsigned>::max());
+  distances[src.index] = 0;
+  queue.clear();
+  queue.push_back(src);
+  std::size_t begin = 0;
+  while (begin < queue.size()) {
+    auto node = queue[begin++];
+    for (auto neighbour : graph.getNeighbours(node)) {
+      if (distances[neighbour.index] != std::numeric_limits<unsigned>::max())
+        continue;
+      parents[neighbour.index] = node;
+      distances[neighbour.index] = distances[node.index] + 1;
+      queue.push_back(neighbour);
+    }
+  }
+}
+
 } // namespace cudaq
@@ -41,14 +41,15 @@ void cudaq::opt::commonPipelineConvertToQIR(
   pm.addPass(createConvertToQIR());
 }
 
-void cudaq::opt::addPipelineTranslateToOpenQASM(PassManager &pm) {
+void cudaq::opt::addPipelineTranslateToOpenQASM(
+    PassManager &pm, const StatePreparationOptions &statePrepOptions) {
   pm.addPass(createCanonicalizerPass());
   pm.addPass(createCSEPass());
   pm.addNestedPass<func::FuncOp>(createClassicalMemToReg());
   pm.addPass(createLoopUnroll());
   pm.addPass(createCanonicalizerPass());
   pm.addPass(createLiftArrayAlloc());
-  pm.addPass(createStatePreparation());
+  pm.addPass(createStatePreparation(statePrepOptions));
 }
 
 void cudaq::opt::addPipelineTranslateToIQMJson(PassManager &pm) {
@@ -88,22 +88,27 @@ std::vector<double> convertAngles(const std::span<double> alphas) {
   // N.B: The paper does fails to explicitly define what is the dot operator in
   // the exponent of -1. Ref. 3 solves the mystery: its the bitwise inner
   // product.
-  auto bitwiseInnerProduct = [](std::size_t a, std::size_t b) {
-    auto product = a & b;
-    auto sumOfProducts = 0;
-    while (product) {
-      sumOfProducts += product & 0b1 ? 1 : 0;
-      product = product >> 1;
-    }
-    return sumOfProducts;
-  };
-  std::vector<double> thetas(alphas.size(), 0);
-  for (std::size_t i = 0u; i < alphas.size(); ++i) {
-    for (std::size_t j = 0u; j < alphas.size(); ++j)
-      thetas[i] +=
-          bitwiseInnerProduct(j, ((i >> 1) ^ i)) & 0b1 ? -alphas[j] : alphas[j];
-    thetas[i] /= alphas.size();
-  }
+  //
+  // Hence, `thetas[i] = 2^-k * sum_j (-1)^(j . g_i) alphas[j]`, where `g_i` is
+  // the i-th Gray code. The sums over `j` for every mask `g` are exactly the
+  // Walsh-Hadamard transform of `alphas`, which we compute with in-place
+  // butterflies in O(k 2^k) instead of the O(4^k) direct summation, and then
+  // permute into Gray-code order.
+  const std::size_t size = alphas.size();
+  assert((size & (size - 1)) == 0 && "expected a power of two");
+  std::vector<double> transform(alphas.begin(), alphas.end());
+  for (std::size_t half = 1; half < size; half <<= 1)
+    for (std::size_t block = 0; block < size; block += 2 * half)
+      for (std::size_t j = block; j < block + half; ++j) {
+        double a = transform[j];
+        double b = transform[j + half];
+        transform[j] = a + b;
+        transform[j + half] = a - b;
+      }
+
+  std::vector<double> thetas(size);
+  for (std::size_t i = 0u; i < size; ++i)
+    thetas[i] = transform[(i >> 1) ^ i] / size;
   return thetas;
 }
 
@@ -201,9 +206,9 @@ private:
 class StateDecomposer {
 public:
   StateDecomposer(StateGateBuilder &b, std::span<std::complex<double>> a,
-                  double t)
+                  double t, double r)
       : builder(b), amplitudes(a), numQubits(log2(a.size())),
-        phaseThreshold(t) {}
+        phaseThreshold(t), rotationThreshold(r) {}
 
   /// @brief Decompose the input state vector data to a set of controlled
   /// operations and rotations. This function takes as input a `OpBuilder`
@@ -265,22 +270,47 @@ private:
 
     auto thetas = cudaq::details::convertAngles(alphas);
     if (numControls == 0) {
-      builder.applyRotationOp<Op>(thetas[0], qubitIndex(target));
+      if (!isNegligible(thetas[0]))
+        builder.applyRotationOp<Op>(thetas[0], qubitIndex(target));
       return;
     }
 
+    // The multiplexor is the sequence `R(theta_0) CX(c_0) R(theta_1) CX(c_1)
+    // ...`. All the CNOTs share the same target, so they commute with each
+    // other and two CNOTs with the same control cancel. When a rotation is
+    // dropped, we can therefore merge the CNOTs around it and only emit, for
+    // each control, the parity of the pending CNOTs before the next rotation.
     auto controlIndices = cudaq::details::getControlIndices(numControls);
     assert(thetas.size() == controlIndices.size());
+    std::vector<bool> pendingX(numControls, false);
+    auto flushPendingX = [&]() {
+      for (std::size_t c = 0; c < numControls; ++c)
+        if (pendingX[c]) {
+          builder.applyX(qubitIndex(c), qubitIndex(target));
+          pendingX[c] = false;
+        }
+    };
     for (auto [i, c] : llvm::enumerate(controlIndices)) {
-      builder.applyRotationOp<Op>(thetas[i], qubitIndex(target));
-      builder.applyX(qubitIndex(c), qubitIndex(target));
+      if (!isNegligible(thetas[i])) {
+        flushPendingX();
+        builder.applyRotationOp<Op>(thetas[i], qubitIndex(target));
+      }
+      pendingX[c] = !pendingX[c];
     }
+    flushPendingX();
+  }
+
+  /// @brief Rotations whose angle magnitude is below `rotationThreshold` are
+  /// not emitted.
+  bool isNegligible(double theta) const {
+    return std::abs(theta) < rotationThreshold;
   }
 
   StateGateBuilder &builder;
   std::span<std::complex<double>> amplitudes;
   std::size_t numQubits;
   double phaseThreshold;
+  double rotationThreshold;
 };
 
 /// Replace a qubit initialization from vectors with quantum gates.
@@ -328,7 +358,7 @@ private:
 namespace {
 
 LogicalResult transform(ModuleOp module, func::FuncOp funcOp,
-                        double phaseThreshold) {
+                        double phaseThreshold, double rotationThreshold) {
   if (funcOp.empty())
     return success();
   auto builder = OpBuilder::atBlockBegin(&funcOp.getBody().front());
@@ -360,7 +390,8 @@ LogicalResult transform(ModuleOp module, func::FuncOp funcOp,
 
             // Prepare state from vector data.
             auto gateBuilder = StateGateBuilder(builder, loc, qubits);
-            auto decomposer = StateDecomposer(gateBuilder, vec, phaseThreshold);
+            auto decomposer = StateDecomposer(gateBuilder, vec, phaseThreshold,
+                                              rotationThreshold);
             decomposer.decompose();
 
             initOp.replaceAllUsesWith(qubits);
@@ -401,7 +432,8 @@ public:
         continue;
       std::string kernelName = funcOp.getName().str();
 
-      auto result = transform(module, funcOp, phaseThreshold);
+      auto result =
+          transform(module, funcOp, phaseThreshold, rotationThreshold);
       if (result.failed()) {
         funcOp.emitOpError("Failed to prepare state for '" + kernelName);
         signalPassFailure();
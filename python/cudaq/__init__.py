@@ -110,6 +110,7 @@ BitFlipChannel = cudaq_runtime.BitFlipChannel
 # Functions
 sample_async = cudaq_runtime.sample_async
 observe_async = cudaq_runtime.observe_async
+observe_sweep = cudaq_runtime.observe_sweep
 get_state = cudaq_runtime.get_state
 get_state_async = cudaq_runtime.get_state_async
 SampleResult = cudaq_runtime.SampleResult
@@ -1519,7 +1519,6 @@ class PyKernel(object):
                     f"Invalid runtime argument type ({type(arg)} provided, {mlirTypeToPyType(self.mlirArgTypes[i])} required)"
                 )
 
-            # Convert `numpy` arrays to lists
             if cc.StdvecType.isinstance(mlirType):
                 # Validate that the length of this argument is
                 # greater than or equal to the number of unique
@@ -1528,12 +1527,9 @@ class PyKernel(object):
                     emitFatalError(
                         f"Invalid runtime list argument - {len(arg)} elements in list but kernel code has at least {len(self.arguments[i].knownUniqueExtractions)} known unique extractions."
                     )
-                if hasattr(arg, "tolist"):
-                    processedArgs.append(arg.tolist())
-                else:
-                    processedArgs.append(arg)
-            else:
-                processedArgs.append(arg)
+            # Note: `numpy` arrays are passed as is, the runtime reads them in
+            # place when possible and converts them to lists otherwise.
+            processedArgs.append(arg)
 
         cudaq_runtime.pyAltLaunchKernel(self.name, self.module, *processedArgs)
 
@@ -483,15 +483,14 @@ class PyKernelDecorator(object):
                                             disableEntryPointTag=True)
                     tmpBridge.visit(globalAstRegistry[arg.name][0])
 
-            # Convert `numpy` arrays to lists
+            # Note: `numpy` arrays are passed as is, the runtime reads them in
+            # place when possible and converts them to lists otherwise.
             if cc.StdvecType.isinstance(mlirType) and hasattr(arg, "tolist"):
                 if arg.ndim != 1:
                     emitFatalError(
                         f"CUDA-Q kernels only support array arguments from NumPy that are one dimensional (input argument {i} has shape = {arg.shape})."
                     )
-                processedArgs.append(arg.tolist())
-            else:
-                processedArgs.append(arg)
+            processedArgs.append(arg)
 
         if self.returnType == None:
             cudaq_runtime.pyAltLaunchKernel(self.name,
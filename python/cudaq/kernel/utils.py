@@ -310,7 +310,7 @@ def mlirTypeFromPyType(argType, ctx, **kwargs):
 
         if isinstance(argInstance[0], bool):
             return cc.StdvecType.get(ctx, mlirTypeFromPyType(bool, ctx))
-        if isinstance(argInstance[0], int):
+        if isinstance(argInstance[0], (int, np.int64)):
             return cc.StdvecType.get(ctx, mlirTypeFromPyType(int, ctx))
         if isinstance(argInstance[0], (float, np.float64)):
             return cc.StdvecType.get(ctx, mlirTypeFromPyType(float, ctx))
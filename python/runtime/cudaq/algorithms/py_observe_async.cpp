@@ -17,6 +17,7 @@
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 
 #include <fmt/core.h>
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 
 namespace py = pybind11;
@@ -89,8 +90,11 @@ async_observe_result pyObserveAsync(py::object &kernel, spin_op &spin_operator,
   // The provided kernel is a builder or MLIR kernel
   auto *argData = new cudaq::OpaqueArguments();
   args = simplifiedValidateInputArguments(args);
-  cudaq::packArgs(*argData, args, kernelFunc,
-                  [](OpaqueArguments &, py::object &) { return false; });
+  // The kernel runs after this call returns, hence arrays are copied.
+  cudaq::packArgs(
+      *argData, args, kernelFunc,
+      [](OpaqueArguments &, py::object &) { return false; },
+      /*startingArgIdx=*/0, /*copyArrays=*/true);
 
   // Launch the asynchronous execution.
   py::gil_scoped_release release;
@@ -165,6 +169,73 @@ observe_result pyObservePar(const PyParType &type, py::object &kernel,
   return observe_result(globalExpVal, spin_operator);
 }
 
+/// @brief Compute the expectation value of `spin_operator` for every row of
+/// the 2-D `parameters` array in a single native call. The kernel must take a
+/// single `list[float]` argument, or one `float` argument per column.
+py::array_t<double> pyObserveSweep(
+    py::object &kernel, spin_op &spin_operator,
+    py::array_t<double, py::array::c_style | py::array::forcecast> parameters,
+    int shots) {
+  if (py::hasattr(kernel, "compile"))
+    kernel.attr("compile")();
+
+  if (parameters.ndim() != 2)
+    throw std::runtime_error(
+        "observe_sweep requires a 2-D array of parameters (one row per "
+        "evaluation).");
+
+  auto kernelName = kernel.attr("name").cast<std::string>();
+  auto kernelMod = kernel.attr("module").cast<MlirModule>();
+  auto kernelFunc = getKernelFuncOp(kernelMod, kernelName);
+  const std::size_t numRows = parameters.shape(0);
+  const std::size_t numCols = parameters.shape(1);
+
+  auto argTys = kernelFunc.getArgumentTypes();
+  const bool vectorArg = [&]() {
+    if (argTys.size() != 1)
+      return false;
+    auto vecTy = dyn_cast<cudaq::cc::StdvecType>(argTys[0]);
+    return vecTy && isa<Float64Type>(vecTy.getElementType());
+  }();
+  const bool scalarArgs =
+      argTys.size() == numCols &&
+      llvm::all_of(argTys, [](Type ty) { return isa<Float64Type>(ty); });
+  if (!vectorArg && !scalarArgs)
+    throw std::runtime_error(
+        "observe_sweep requires a kernel taking a single `list[float]` "
+        "argument or one `float` argument per column of the parameters.");
+
+  auto &platform = cudaq::get_platform();
+  const double *data = parameters.data();
+  py::array_t<double> results(numRows);
+  double *expectations = results.mutable_data();
+
+  // Should only have C++ going on here, safe to release the GIL
+  py::gil_scoped_release release;
+  details::distributeOverQpus(
+      numRows, platform.num_qpus(), platform,
+      [&](std::size_t qpuId, std::size_t i, std::size_t counter,
+          std::size_t N) {
+        const double *row = data + i * numCols;
+        OpaqueArguments argData;
+        if (vectorArg)
+          addArgument(argData, std::vector<double>(row, row + numCols));
+        else
+          for (std::size_t j = 0; j < numCols; ++j)
+            addArgument(argData, double(row[j]));
+        expectations[i] =
+            details::runObservation(
+                [&]() {
+                  pyAltLaunchKernel(kernelName, kernelMod, argData, {});
+                },
+                spin_operator, platform, shots, kernelName, qpuId, nullptr,
+                counter, N)
+                .value()
+                .expectation();
+      });
+  return results;
+}
+
 void bindObserveAsync(py::module &mod) {
   auto parallelSubmodule = mod.def_submodule("parallel");
   py::class_<cudaq::parallel::mpi>(
@@ -208,6 +279,28 @@ Returns:
 
   mod.def("isValidObserveKernel", &isValidObserveKernel);
 
+  mod.def("observe_sweep", &pyObserveSweep, py::arg("kernel"),
+          py::arg("spin_operator"), py::arg("parameters"), py::kw_only(),
+          py::arg("shots_count") = defaultShotsValue,
+          R"#(Compute the expected value of the `spin_operator` with respect to 
+the `kernel` for every row of the 2-D `parameters` array, e.g., for a 
+landscape scan. The whole sweep runs natively, with the rows distributed 
+across the available QPUs.
+
+Args:
+  kernel (:class:`Kernel`): The :class:`Kernel` to evaluate the 
+    expectation value with respect to. It must take a single `list[float]` 
+    argument, or one `float` argument per column of `parameters`.
+  spin_operator (:class:`SpinOperator`): The Hermitian spin operator to 
+    calculate the expectation of.
+  parameters (`numpy.ndarray`): The parameters, one row per evaluation.
+  shots_count (Optional[int]): The number of shots to use for QPU 
+    execution. Defaults to -1 implying no shots-based sampling. Key-word only.
+
+Returns:
+  `numpy.ndarray`: 
+  The expectation value for each row of `parameters`.)#");
+
   mod.def(
       "observe_parallel",
       [&](py::object kernel, spin_op &spin_operator, py::args arguments,
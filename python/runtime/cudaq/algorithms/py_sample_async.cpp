@@ -61,8 +61,11 @@ for more information on this programming pattern.)#")
 
         args = simplifiedValidateInputArguments(args);
         auto *argData = new cudaq::OpaqueArguments();
-        cudaq::packArgs(*argData, args, kernelFunc,
-                        [](OpaqueArguments &, py::object &) { return false; });
+        // The kernel runs after this call returns, hence arrays are copied.
+        cudaq::packArgs(
+            *argData, args, kernelFunc,
+            [](OpaqueArguments &, py::object &) { return false; },
+            /*startingArgIdx=*/0, /*copyArrays=*/true);
 
         // The function below will be executed multiple times
         // if the kernel has conditional feedback. In that case,
@@ -75,25 +75,19 @@ public:
     this->kernelName = in_kernelName;
   }
 
-  void execute() const override {
-    if (!state) {
-      auto &platform = cudaq::get_platform();
-      // Create an execution context, indicate this is for
-      // extracting the state representation
-      ExecutionContext context("extract-state");
-      // Perform the usual pattern set the context,
-      // execute and then reset
-      platform.set_exec_ctx(&context);
-      // Note: in Python, the platform QPU (`PyRemoteSimulatorQPU`) expects an
-      // ModuleOp pointer as the first element in the args array in StreamLined
-      // mode.
-      auto args = argsData->getArgs();
-      args.insert(args.begin(),
-                  const_cast<void *>(static_cast<const void *>(&kernelMod)));
-      platform.launchKernel(kernelName, args);
-      platform.reset_exec_ctx();
-      state = std::move(context.simulationState);
-    }
+  void launchKernel(ExecutionContext &context) const override {
+    auto &platform = cudaq::get_platform();
+    // Perform the usual pattern set the context,
+    // execute and then reset
+    platform.set_exec_ctx(&context);
+    // Note: in Python, the platform QPU (`PyRemoteSimulatorQPU`) expects an
+    // ModuleOp pointer as the first element in the args array in StreamLined
+    // mode.
+    auto args = argsData->getArgs();
+    args.insert(args.begin(),
+                const_cast<void *>(static_cast<const void *>(&kernelMod)));
+    platform.launchKernel(kernelName, args);
+    platform.reset_exec_ctx();
   }
 
   std::pair<std::string, std::vector<void *>> getKernelInfo() const override {
@@ -130,7 +124,9 @@ state pyGetStateRemote(py::object kernel, py::args args) {
   auto kernelName = kernel.attr("name").cast<std::string>();
   args = simplifiedValidateInputArguments(args);
   auto kernelMod = kernel.attr("module").cast<MlirModule>();
-  auto *argData = toOpaqueArgs(args, kernelMod, kernelName);
+  // The state is evaluated lazily, hence arrays are copied.
+  auto *argData =
+      toOpaqueArgs(args, kernelMod, kernelName, /*copyArrays=*/true);
   auto [argWrapper, size, returnOffset] =
       pyCreateNativeKernel(kernelName, kernelMod, *argData);
   return state(new PyRemoteSimulationState(kernelName, argWrapper, argData,
@@ -699,8 +695,11 @@ for more information on this programming pattern.)#")
 
         // The provided kernel is a builder or MLIR kernel
         auto *argData = new cudaq::OpaqueArguments();
-        cudaq::packArgs(*argData, args, kernelFunc,
-                        [](OpaqueArguments &, py::object &) { return false; });
+        // The kernel runs after this call returns, hence arrays are copied.
+        cudaq::packArgs(
+            *argData, args, kernelFunc,
+            [](OpaqueArguments &, py::object &) { return false; },
+            /*startingArgIdx=*/0, /*copyArrays=*/true);
 
         // Launch the asynchronous execution.
         py::gil_scoped_release release;
@@ -536,7 +536,10 @@ MlirModule synthesizeKernel(const std::string &name, MlirModule module,
   if (!isSimulator) {
     pm.addPass(cudaq::opt::createConstPropComplex());
     pm.addPass(cudaq::opt::createLiftArrayAlloc());
-    pm.addPass(cudaq::opt::createStatePreparation());
+    cudaq::opt::StatePreparationOptions statePrepOptions;
+    statePrepOptions.rotationThreshold =
+        getEnvDouble("CUDAQ_STATE_PREP_ROTATION_THRESHOLD", 0.0);
+    pm.addPass(cudaq::opt::createStatePreparation(statePrepOptions));
   }
   pm.addPass(createCanonicalizerPass());
   pm.addPass(cudaq::opt::createExpandMeasurementsPass());
@@ -617,7 +620,10 @@ std::string getASM(const std::string &name, MlirModule module,
 
   PassManager pm(context);
   pm.addPass(cudaq::opt::createLambdaLiftingPass());
-  cudaq::opt::addPipelineTranslateToOpenQASM(pm);
+  cudaq::opt::StatePreparationOptions statePrepOptions;
+  statePrepOptions.rotationThreshold =
+      getEnvDouble("CUDAQ_STATE_PREP_ROTATION_THRESHOLD", 0.0);
+  cudaq::opt::addPipelineTranslateToOpenQASM(pm, statePrepOptions);
 
   if (failed(pm.run(cloned)))
     throw std::runtime_error("getASM: code generation failed.");
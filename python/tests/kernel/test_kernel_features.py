@@ -949,6 +949,58 @@ def test_no_valueerror_np_array():
     test(np.array([1., 2.]))
 
 
+def test_np_array_args():
+
+    @cudaq.kernel
+    def rotations(angles: list[float], flips: list[int]):
+        q = cudaq.qvector(len(angles))
+        for i in range(len(angles)):
+            ry(angles[i], q[i])
+        for i in flips:
+            x(q[i])
+
+    # Contiguous `float64` and `int64` arrays are read in place, others are
+    # converted to lists.
+    angles = np.array([np.pi, 0., np.pi, 0.])
+    flips = np.array([1, 2], dtype=np.int64)
+    for args in [(angles, flips), (angles[::-1].copy(), flips),
+                 (np.array([np.pi, 0., 0., 0., np.pi, 0., 0., 0.])[::2],
+                  flips), (angles.astype(np.float32), flips)]:
+        counts = cudaq.sample(rotations, *args)
+        assert len(counts) == 1
+    assert '1100' in cudaq.sample(rotations, angles, flips)
+
+    @cudaq.kernel
+    def init(amplitudes: list[complex]):
+        q = cudaq.qvector(amplitudes)
+
+    amplitudes = np.array([0., 0., 0., 1.], dtype=np.complex128)
+    counts = cudaq.sample(init, amplitudes)
+    assert len(counts) == 1 and '11' in counts
+
+
+def test_np_array_args_async():
+
+    @cudaq.kernel
+    def rotations(angles: list[float]):
+        q = cudaq.qvector(len(angles))
+        for i in range(len(angles)):
+            ry(angles[i], q[i])
+
+    # Asynchronous launches copy the arrays, so changing them after the launch
+    # does not change the result.
+    angles = np.array([np.pi, 0., np.pi])
+    future = cudaq.sample_async(rotations, angles)
+    angles[:] = 0.
+    counts = future.get()
+    assert len(counts) == 1 and '101' in counts
+
+    angles = np.array([np.pi, 0., np.pi])
+    future = cudaq.observe_async(rotations, spin.z(0), angles)
+    angles[:] = 0.
+    assert np.isclose(future.get().expectation(), -1.)
+
+
 def test_draw():
 
     @cudaq.kernel
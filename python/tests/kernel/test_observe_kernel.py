@@ -212,6 +212,40 @@ def test_broadcast_py39Plus():
     assert len(energies) == 50
 
 
+@skipIfPythonLessThan39
+def test_observe_sweep():
+
+    hamiltonian = 5.907 - 2.1433 * spin.x(0) * spin.x(1) - 2.1433 * spin.y(
+        0) * spin.y(1) + .21829 * spin.z(0) - 6.125 * spin.z(1)
+
+    @cudaq.kernel
+    def ansatz(angle: float):
+        q = cudaq.qvector(2)
+        x(q[0])
+        ry(angle, q[1])
+        x.ctrl(q[1], q[0])
+
+    @cudaq.kernel
+    def vec_ansatz(angles: list[float]):
+        q = cudaq.qvector(2)
+        x(q[0])
+        ry(angles[0], q[1])
+        x.ctrl(q[1], q[0])
+
+    angles = np.linspace(-np.pi, np.pi, 50).reshape(50, 1)
+    expected = np.array([
+        r.expectation()
+        for r in cudaq.observe(ansatz, hamiltonian, angles.flatten())
+    ])
+    for kernel in [ansatz, vec_ansatz]:
+        energies = cudaq.observe_sweep(kernel, hamiltonian, angles)
+        assert energies.shape == (50,)
+        assert np.allclose(energies, expected)
+
+    with pytest.raises(RuntimeError):
+        cudaq.observe_sweep(ansatz, hamiltonian, np.zeros((4, 2)))
+
+
 def test_observe_list():
     """Test that we can observe a list of spin_ops."""
     hamiltonianList = [
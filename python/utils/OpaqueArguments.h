@@ -25,6 +25,7 @@
 #include <functional>
 #include <future>
 #include <pybind11/complex.h>
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <vector>
 
@@ -77,6 +78,20 @@ public:
   }
 };
 
+/// @brief Return true if \p arg is a one-dimensional, C-contiguous NumPy array
+/// of an element type that kernels can read in place: `float64`, `complex128`
+/// or `int64`.
+inline bool isZeroCopyArray(py::handle arg) {
+  if (!py::isinstance<py::array>(arg))
+    return false;
+  auto array = py::reinterpret_borrow<py::array>(arg);
+  if (array.ndim() != 1 || !(array.flags() & py::array::c_style))
+    return false;
+  return py::isinstance<py::array_t<double>>(array) ||
+         py::isinstance<py::array_t<std::complex<double>>>(array) ||
+         py::isinstance<py::array_t<std::int64_t>>(array);
+}
+
 /// @brief This function modifies input arguments to convert them into valid
 /// CUDA-Q argument types. Future work should make this function perform more
 /// checks, we probably want to take the Kernel MLIR argument Types as input and
@@ -99,7 +114,10 @@ inline py::args simplifiedValidateInputArguments(py::args &args) {
       if (shape.size() != 1)
         throw std::runtime_error("Cannot pass ndarray with shape != (N,).");
 
-      arg = args[i].attr("tolist")();
+      // Arrays that can be read in place are kept as is, see
+      // `addArrayArgument`.
+      if (!isZeroCopyArray(args[i]))
+        arg = args[i].attr("tolist")();
     } else if (py::isinstance<py::str>(arg)) {
       arg = cudaq::pauli_word(py::cast<std::string>(arg));
     } else if (py::isinstance<py::list>(arg)) {
@@ -182,6 +200,72 @@ inline void valueArgument(OpaqueArguments &argData, T *arg) {
   argData.emplace_back(static_cast<void *>(arg), [](void *) {});
 }
 
+/// @brief Drop a reference to \p obj. `OpaqueArguments` may be destroyed on a
+/// thread that doesn't hold the GIL (e.g., for asynchronous launches), in
+/// which case the interpreter drops the reference at its next opportunity.
+inline void releasePyObject(PyObject *obj) {
+  if (!Py_IsInitialized())
+    return;
+  if (PyGILState_Check()) {
+    Py_DECREF(obj);
+    return;
+  }
+  auto decref = [](void *ptr) -> int {
+    Py_DECREF(static_cast<PyObject *>(ptr));
+    return 0;
+  };
+  if (Py_AddPendingCall(decref, obj) != 0) {
+    py::gil_scoped_acquire gil;
+    Py_DECREF(obj);
+  }
+}
+
+/// @brief Pass the NumPy array \p arg as a `std::vector<T>` argument that
+/// points into the array's buffer, rather than a copy of its elements. The
+/// argument keeps the array alive until \p argData is destroyed. Returns false
+/// if \p arg is not a contiguous one-dimensional array of `T`.
+///
+/// The kernel reads the array when it is launched. Launches that may run after
+/// the caller regains control (asynchronous launches, lazily evaluated states)
+/// must set \p copy, so that later changes to the array are not observed. The
+/// elements are then copied straight from the buffer.
+template <typename T>
+inline bool addArrayArgument(OpaqueArguments &argData, py::handle arg,
+                             bool copy) {
+  if (!isZeroCopyArray(arg) || !py::isinstance<py::array_t<T>>(arg))
+    return false;
+  auto array = py::reinterpret_borrow<py::array>(arg);
+  const auto *data = static_cast<const T *>(array.data());
+  const auto size = static_cast<std::size_t>(array.size());
+  if (copy) {
+    addArgument(argData, std::vector<T>(data, data + size));
+    return true;
+  }
+  // Same layout as `std::vector<T>`: begin, end and end of storage.
+  auto *span = new std::array<const T *, 3>{data, data + size, data + size};
+  PyObject *owner = array.release().ptr();
+  argData.emplace_back(span, [owner](void *ptr) {
+    delete static_cast<std::array<const T *, 3> *>(ptr);
+    releasePyObject(owner);
+  });
+  return true;
+}
+
+/// @brief Pass the NumPy array \p arg without converting it to a list if its
+/// element type matches the kernel's vector element type \p eleTy.
+inline bool addArrayArgument(OpaqueArguments &argData, py::handle arg,
+                             mlir::Type eleTy, bool copy) {
+  if (isa<Float64Type>(eleTy))
+    return addArrayArgument<double>(argData, arg, copy);
+  if (auto complexTy = dyn_cast<ComplexType>(eleTy))
+    if (isa<Float64Type>(complexTy.getElementType()))
+      return addArrayArgument<std::complex<double>>(argData, arg, copy);
+  // Note: `list[int]` arguments are always 64 bits wide (see `packArgs`).
+  if (isa<IntegerType>(eleTy) && eleTy.getIntOrFloatBitWidth() == 64)
+    return addArrayArgument<std::int64_t>(argData, arg, copy);
+  return false;
+}
+
 inline std::string mlirTypeToString(mlir::Type ty) {
   std::string msg;
   {
@@ -272,11 +356,14 @@ inline void handleStructMemberVariable(void *data, std::size_t offset,
       });
 }
 
+/// @brief Pack the Python arguments \p args of the kernel \p kernelFuncOp
+/// into \p argData. Set \p copyArrays if the kernel may be launched after the
+/// caller regains control, see `addArrayArgument`.
 inline void packArgs(OpaqueArguments &argData, py::args args,
                      mlir::func::FuncOp kernelFuncOp,
                      const std::function<bool(OpaqueArguments &argData,
                                               py::object &arg)> &backupHandler,
-                     std::size_t startingArgIdx = 0) {
+                     std::size_t startingArgIdx = 0, bool copyArrays = false) {
   if (kernelFuncOp.getNumArguments() != args.size())
     throw std::runtime_error("Invalid runtime arguments - kernel expected " +
                              std::to_string(kernelFuncOp.getNumArguments()) +
@@ -359,9 +446,14 @@ inline void packArgs(OpaqueArguments &argData, py::args args,
           argData.emplace_back(allocatedArg, [](void *ptr) { std::free(ptr); });
         })
         .Case([&](cudaq::cc::StdvecType ty) {
+          auto eleTy = ty.getElementType();
+          if (py::isinstance<py::array>(arg)) {
+            if (addArrayArgument(argData, arg, eleTy, copyArrays))
+              return;
+            arg = arg.attr("tolist")();
+          }
           checkArgumentType<py::list>(arg, i);
           auto casted = py::cast<py::list>(arg);
-          auto eleTy = ty.getElementType();
           if (casted.empty()) {
             // Handle boolean different since C++ library implementation
             // for vectors of bool is different than other types.
@@ -505,12 +597,15 @@ inline bool isBroadcastRequest(kernel_builder<> &builder, py::args &args) {
 /// @brief Create a new OpaqueArguments pointer and pack the
 /// python arguments in it. Clients must delete the memory.
 inline OpaqueArguments *toOpaqueArgs(py::args &args, MlirModule mod,
-                                     const std::string &name) {
+                                     const std::string &name,
+                                     bool copyArrays = false) {
   auto kernelFunc = getKernelFuncOp(mod, name);
   auto *argData = new cudaq::OpaqueArguments();
   args = simplifiedValidateInputArguments(args);
-  cudaq::packArgs(*argData, args, kernelFunc,
-                  [](OpaqueArguments &, py::object &) { return false; });
+  cudaq::packArgs(
+      *argData, args, kernelFunc,
+      [](OpaqueArguments &, py::object &) { return false; },
+      /*startingArgIdx=*/0, copyArrays);
   return argData;
 }
 
@@ -13,6 +13,7 @@
 #include "common/ExecutionContext.h"
 #include "common/Executor.h"
 #include "common/FmtCore.h"
+#include "common/LateBinding.h"
 #include "common/Logger.h"
 #include "common/RestClient.h"
 #include "common/RuntimeMLIR.h"
@@ -49,12 +50,17 @@
 #include "mlir/Pass/PassRegistry.h"
 #include "mlir/Tools/mlir-translate/Translation.h"
 #include "mlir/Transforms/Passes.h"
+#include <cctype>
+#include <cerrno>
+#include <deque>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <netinet/in.h>
 #include <regex>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <unordered_map>
 
 namespace cudaq {
 
@@ -112,6 +118,34 @@ protected:
   /// to be printed. This is similar to `-mlir-pass-statistics` in `cudaq-opt`
   bool enablePassStatistics = false;
 
+  /// @brief Flag indicating whether floating-point kernel arguments should be
+  /// kept symbolic through the lowering pipeline and bound right before code
+  /// generation. The lowered (unbound) code is cached, so that launching the
+  /// same kernel with new parameter values does not rerun the pipeline.
+  bool lateBinding = false;
+
+  /// @brief A kernel lowered with its late-bound arguments left symbolic.
+  struct StructuralCompileResult {
+    /// The module(s) to bind and translate, as MLIR text, with their names.
+    std::vector<std::pair<std::string, std::string>> modules;
+    /// The qubit mapping reordering of the kernel.
+    std::vector<std::size_t> mappingReorderIdx;
+    /// Positions of the scalar late-bound arguments in the original kernel.
+    std::vector<unsigned> scalarArgs;
+    /// Positions and lengths of the vector late-bound arguments.
+    std::vector<std::pair<unsigned, std::size_t>> vectorArgs;
+  };
+
+  /// @brief Cache of structural compile results, keyed on everything but the
+  /// values of the late-bound arguments. The least recently used entry is
+  /// evicted once the cache is full.
+  static constexpr std::size_t maxStructuralCacheSize = 64;
+  std::unordered_map<std::string,
+                     std::shared_ptr<const StructuralCompileResult>>
+      structuralCache;
+  std::deque<std::string> structuralCacheOrder;
+  std::mutex structuralCacheMutex;
+
   /// @brief If we are emulating locally, keep track
   /// of JIT engines for invoking the kernels.
   std::vector<mlir::ExecutionEngine *> jitEngines;
@@ -248,6 +282,12 @@ public:
     // Print the IR if requested
     printIR = getEnvBool("CUDAQ_DUMP_JIT_IR", printIR);
 
+    // Compile once and bind floating-point arguments late if requested
+    lateBinding = getEnvBool("CUDAQ_REMOTE_LATE_BINDING", lateBinding);
+    if (auto iter = backendConfig.find("late_binding");
+        iter != backendConfig.end())
+      lateBinding = iter->second == "true";
+
     // Get additional debug values
     disableMLIRthreading =
         getEnvBool("CUDAQ_MLIR_DISABLE_THREADING", disableMLIRthreading);
@@ -313,6 +353,21 @@ public:
                   passPipelineConfig);
     }
 
+    // Forward the rotation threshold of the state preparation synthesis to
+    // the `state-prep` pass of the lowering pipeline.
+    const double rotationThreshold =
+        cudaq::getEnvDouble("CUDAQ_STATE_PREP_ROTATION_THRESHOLD", 0.0);
+    if (rotationThreshold > 0.0) {
+      std::regex statePrep("state-prep(?=,|$)");
+      passPipelineConfig = std::regex_replace(
+          passPipelineConfig, statePrep,
+          fmt::format("state-prep{{rotation-threshold={}}}",
+                      rotationThreshold));
+      cudaq::info("CUDAQ_STATE_PREP_ROTATION_THRESHOLD set, so updated "
+                  "lowering pipeline to {}",
+                  passPipelineConfig);
+    }
+
     // Set the qpu name
     qpuName = mutableBackend;
 
@@ -323,6 +378,24 @@ public:
 
     // Give the server helper to the executor
     executor->setServerHelper(serverHelper.get());
+
+    // Limit the number of jobs that are posted concurrently if requested.
+    // This is common to all targets, so it is not left to the server helpers.
+    if (auto iter = backendConfig.find("max_concurrent_submissions");
+        iter != backendConfig.end()) {
+      const std::string &valueStr = iter->second;
+      char *endptr = nullptr;
+      errno = 0;
+      const auto value = std::strtoul(valueStr.c_str(), &endptr, 10);
+      if (valueStr.empty() || !std::isdigit(valueStr[0]) || *endptr != '\0' ||
+          errno != 0 || value == 0)
+        throw std::runtime_error(
+            "Invalid max_concurrent_submissions setting. Expected a positive "
+            "integer. Got: " +
+            valueStr);
+      cudaq::info("Posting at most {} jobs concurrently.", value);
+      executor->setMaxConcurrentSubmissions(value);
+    }
   }
 
   /// @brief Conditionally form an output_names JSON object if this was for QIR
@@ -368,6 +441,285 @@ public:
     return lowerQuakeCode(kernelName, nullptr, rawArgs);
   }
 
+  /// @brief Apply the MLIR pass pipeline \p pipeline to \p moduleOp.
+  void runPassPipeline(const std::string &kernelName,
+                       const std::string &pipeline, mlir::ModuleOp moduleOp) {
+    mlir::PassManager pm(moduleOp.getContext());
+    std::string errMsg;
+    llvm::raw_string_ostream os(errMsg);
+    cudaq::info("Pass pipeline for {} = {}", kernelName, pipeline);
+    if (failed(parsePassPipeline(pipeline, pm, os)))
+      throw std::runtime_error(
+          "Remote rest platform failed to add passes to pipeline (" + errMsg +
+          ").");
+    if (disableMLIRthreading || enablePrintMLIREachPass)
+      moduleOp.getContext()->disableMultithreading();
+    if (enablePrintMLIREachPass)
+      pm.enableIRPrinting();
+    if (failed(pm.run(moduleOp)))
+      throw std::runtime_error("Remote rest platform Quake lowering failed.");
+  }
+
+  /// @brief Substitute the arguments \p args into the kernel \p kernelName of
+  /// \p moduleOp with argument synthesis. Arguments in \p exclusions are left
+  /// as block arguments.
+  void
+  synthesizeArguments(const std::string &kernelName, mlir::ModuleOp moduleOp,
+                      const std::vector<void *> &args,
+                      const std::unordered_set<unsigned> &exclusions = {}) {
+    cudaq::info("Run Argument Synth.\n");
+    opt::ArgumentConverter argCon(kernelName, moduleOp, false);
+    argCon.gen(args, exclusions);
+    std::string kernName = cudaq::runtime::cudaqGenPrefixName + kernelName;
+    mlir::SmallVector<mlir::StringRef> kernels = {kernName};
+    std::string substBuff;
+    llvm::raw_string_ostream ss(substBuff);
+    ss << argCon.getSubstitutionModule();
+    mlir::SmallVector<mlir::StringRef> substs = {substBuff};
+    mlir::PassManager pm(moduleOp.getContext());
+    pm.addNestedPass<mlir::func::FuncOp>(
+        opt::createArgumentSynthesisPass(kernels, substs));
+    pm.addPass(mlir::createCanonicalizerPass());
+    if (disableMLIRthreading || enablePrintMLIREachPass)
+      moduleOp.getContext()->disableMultithreading();
+    if (enablePrintMLIREachPass)
+      pm.enableIRPrinting();
+    if (failed(pm.run(moduleOp)))
+      throw std::runtime_error("Could not successfully apply quake-synth.");
+  }
+
+  /// @brief Read the qubit mapping reordering of the kernel entry point, if
+  /// the mapper ran.
+  std::vector<std::size_t> getMappingReorderIdx(const std::string &kernelName,
+                                                mlir::ModuleOp moduleOp) {
+    auto entryPointFunc = moduleOp.lookupSymbol<mlir::func::FuncOp>(
+        std::string(cudaq::runtime::cudaqGenPrefixName) + kernelName);
+    std::vector<std::size_t> mapping_reorder_idx;
+    if (auto mappingAttr = dyn_cast_if_present<mlir::ArrayAttr>(
+            entryPointFunc->getAttr("mapping_reorder_idx"))) {
+      mapping_reorder_idx.resize(mappingAttr.size());
+      std::transform(mappingAttr.begin(), mappingAttr.end(),
+                     mapping_reorder_idx.begin(), [](mlir::Attribute attr) {
+                       return mlir::cast<mlir::IntegerAttr>(attr).getInt();
+                     });
+    }
+    return mapping_reorder_idx;
+  }
+
+  /// @brief Produce the module(s) to execute from the lowered \p moduleOp: the
+  /// module itself, or one module per spin_op term with the measurement basis
+  /// changes applied when observing.
+  std::vector<std::pair<std::string, mlir::ModuleOp>>
+  buildExecutionModules(const std::string &kernelName,
+                        mlir::ModuleOp moduleOp) {
+    std::vector<std::pair<std::string, mlir::ModuleOp>> modules;
+    if (!executionContext || executionContext->name != "observe") {
+      modules.emplace_back(kernelName, moduleOp);
+      return modules;
+    }
+
+    auto *context = moduleOp.getContext();
+    mlir::OpBuilder builder(context);
+    runPassPipeline(kernelName, "canonicalize,cse", moduleOp);
+    cudaq::spin_op &spin = *executionContext->spin.value();
+    for (const auto &term : spin) {
+      if (term.is_identity())
+        continue;
+
+      // Get the ansatz
+      auto ansatz = moduleOp.lookupSymbol<mlir::func::FuncOp>(
+          std::string(cudaq::runtime::cudaqGenPrefixName) + kernelName);
+
+      // Create a new Module to clone the ansatz into it
+      auto tmpModuleOp = builder.create<mlir::ModuleOp>(moduleOp.getLoc());
+      tmpModuleOp.push_back(ansatz.clone());
+      moduleOp.walk([&](quake::WireSetOp wireSetOp) {
+        tmpModuleOp.push_back(wireSetOp.clone());
+      });
+
+      // Extract the binary symplectic encoding
+      auto [binarySymplecticForm, coeffs] = term.get_raw_data();
+
+      // Create the pass manager, add the quake observe ansatz pass
+      // and run it followed by the canonicalizer
+      mlir::PassManager pm(context);
+      pm.addNestedPass<mlir::func::FuncOp>(
+          cudaq::opt::createObserveAnsatzPass(binarySymplecticForm[0]));
+      if (disableMLIRthreading || enablePrintMLIREachPass)
+        tmpModuleOp.getContext()->disableMultithreading();
+      if (enablePrintMLIREachPass)
+        pm.enableIRPrinting();
+      if (failed(pm.run(tmpModuleOp)))
+        throw std::runtime_error("Could not apply measurements to ansatz.");
+      // The full pass pipeline was run above, but the ansatz pass can
+      // introduce gates that aren't supported by the backend, so we need to
+      // re-run the gate set mapping if that existed in the original pass
+      // pipeline.
+      auto csvSplit = cudaq::split(passPipelineConfig, ',');
+      for (auto &pass : csvSplit)
+        if (pass.ends_with("-gate-set-mapping"))
+          runPassPipeline(kernelName, pass, tmpModuleOp);
+      modules.emplace_back(term.to_string(false), tmpModuleOp);
+    }
+    return modules;
+  }
+
+  /// @brief Lower \p moduleOp while keeping the floating-point arguments in
+  /// \p args symbolic, caching the result, and bind them afterwards. On
+  /// success, fill \p modules (owned by \p moduleOp's context) and
+  /// \p mapping_reorder_idx and return true. Return false if the kernel
+  /// signature does not lend itself to late binding.
+  bool lowerWithLateBinding(
+      const std::string &kernelName, mlir::ModuleOp moduleOp,
+      const std::vector<void *> &args,
+      std::vector<std::pair<std::string, mlir::ModuleOp>> &modules,
+      std::vector<std::size_t> &mapping_reorder_idx) {
+    auto *context = moduleOp.getContext();
+    auto kernelFunc = moduleOp.lookupSymbol<mlir::func::FuncOp>(
+        std::string(cudaq::runtime::cudaqGenPrefixName) + kernelName);
+    auto funcTy = kernelFunc.getFunctionType();
+    if (funcTy.getNumInputs() != args.size())
+      return false;
+    auto deferred = opt::getLateBoundArguments(funcTy);
+
+    // Sort the late-bound arguments into scalars and (non-empty) vectors. An
+    // empty vector has nothing to bind, so it is synthesized with the rest.
+    std::vector<unsigned> scalarArgs;
+    std::vector<std::pair<unsigned, std::size_t>> vectorArgs;
+    for (unsigned i = 0; i < args.size(); ++i) {
+      if (!deferred.contains(i))
+        continue;
+      auto vecTy = dyn_cast<cudaq::cc::StdvecType>(funcTy.getInput(i));
+      if (!vecTy) {
+        scalarArgs.push_back(i);
+        continue;
+      }
+      auto eleSize = vecTy.getElementType().getIntOrFloatBitWidth() / 8;
+      auto *triple = static_cast<const char *const *>(args[i]);
+      std::size_t size = (triple[1] - triple[0]) / eleSize;
+      if (size == 0)
+        deferred.erase(i);
+      else
+        vectorArgs.emplace_back(i, size);
+    }
+    if (deferred.empty())
+      return false;
+
+    // The structural key is everything that determines the lowered code other
+    // than the values of the late-bound arguments.
+    std::string key = kernelName + '\n';
+    if (executionContext) {
+      key += executionContext->name + '\n';
+      if (executionContext->name == "observe")
+        key += executionContext->spin.value()->to_string(false) + '\n';
+    }
+    for (auto [pos, size] : vectorArgs)
+      key += std::to_string(pos) + ':' + std::to_string(size) + '\n';
+    {
+      opt::ArgumentConverter argCon(kernelName, moduleOp, false);
+      argCon.gen(args, deferred);
+      llvm::raw_string_ostream ss(key);
+      ss << argCon.getSubstitutionModule();
+    }
+
+    std::unique_lock<std::mutex> lock(structuralCacheMutex);
+    std::shared_ptr<const StructuralCompileResult> cached;
+    if (auto iter = structuralCache.find(key); iter != structuralCache.end()) {
+      cached = iter->second;
+      // Mark the entry as the most recently used one.
+      structuralCacheOrder.erase(std::find(structuralCacheOrder.begin(),
+                                           structuralCacheOrder.end(), key));
+      structuralCacheOrder.push_back(key);
+    }
+    if (!cached) {
+      lock.unlock();
+      cudaq::info("Late binding: compiling structure of {}.", kernelName);
+      // Work on a clone so that we can fall back to the regular flow if
+      // argument synthesis does not leave exactly the late-bound arguments.
+      auto structural = moduleOp.clone();
+      synthesizeArguments(kernelName, structural, args, deferred);
+      auto structuralFunc = structural.lookupSymbol<mlir::func::FuncOp>(
+          std::string(cudaq::runtime::cudaqGenPrefixName) + kernelName);
+      std::vector<mlir::Type> expectedTys;
+      for (unsigned i = 0; i < args.size(); ++i)
+        if (deferred.contains(i))
+          expectedTys.push_back(funcTy.getInput(i));
+      if (structuralFunc.getArgumentTypes() !=
+          mlir::ArrayRef<mlir::Type>(expectedTys)) {
+        cudaq::info("Late binding: unsupported signature for {}.", kernelName);
+        structural->erase();
+        return false;
+      }
+
+      // Replace the vectors by one scalar argument per element. At this point
+      // the remaining arguments are the deferred ones, in order.
+      std::vector<std::pair<unsigned, std::size_t>> localVectorArgs;
+      for (auto [pos, size] : vectorArgs) {
+        unsigned rank =
+            std::count_if(deferred.begin(), deferred.end(),
+                          [pos = pos](unsigned i) { return i < pos; });
+        localVectorArgs.emplace_back(rank, size);
+      }
+      opt::scalarizeVectorArguments(structuralFunc, localVectorArgs);
+
+      runPassPipeline(kernelName, passPipelineConfig, structural);
+      opt::recordStructuralCompile();
+      auto entry = std::make_shared<StructuralCompileResult>();
+      entry->mappingReorderIdx = getMappingReorderIdx(kernelName, structural);
+      entry->scalarArgs = scalarArgs;
+      entry->vectorArgs = vectorArgs;
+      for (auto &[name, module] :
+           buildExecutionModules(kernelName, structural)) {
+        std::string text;
+        llvm::raw_string_ostream os(text);
+        os << module;
+        entry->modules.emplace_back(name, std::move(os.str()));
+        if (module != structural)
+          module->erase();
+      }
+      structural->erase();
+
+      cached = entry;
+      lock.lock();
+      if (structuralCache.emplace(key, cached).second) {
+        structuralCacheOrder.push_back(std::move(key));
+        if (structuralCacheOrder.size() > maxStructuralCacheSize) {
+          structuralCache.erase(structuralCacheOrder.front());
+          structuralCacheOrder.pop_front();
+        }
+      }
+    } else {
+      cudaq::info("Late binding: reusing structure of {}.", kernelName);
+    }
+    lock.unlock();
+    // The entry is shared, so it stays valid even if it gets evicted.
+    const StructuralCompileResult &entry = *cached;
+
+    // Bind: the scalars come first, followed by the vector elements.
+    std::vector<void *> boundArgs;
+    for (auto pos : entry.scalarArgs)
+      boundArgs.push_back(args[pos]);
+    for (auto [pos, size] : entry.vectorArgs) {
+      auto eleTy =
+          cast<cudaq::cc::StdvecType>(funcTy.getInput(pos)).getElementType();
+      auto eleSize = eleTy.getIntOrFloatBitWidth() / 8;
+      auto *data = static_cast<char *const *>(args[pos])[0];
+      for (std::size_t i = 0; i < size; ++i)
+        boundArgs.push_back(data + i * eleSize);
+    }
+
+    mapping_reorder_idx = entry.mappingReorderIdx;
+    for (auto &[name, text] : entry.modules) {
+      auto module = mlir::parseSourceString<mlir::ModuleOp>(text, context);
+      if (!module)
+        throw std::runtime_error("Late binding: could not parse cached code.");
+      synthesizeArguments(kernelName, *module, boundArgs);
+      runPassPipeline(kernelName, "lift-array-value,canonicalize,cse", *module);
+      modules.emplace_back(name, module.release());
+    }
+    return true;
+  }
+
   /// @brief Extract the Quake representation for the given kernel name and
   /// lower it to the code format required for the specific backend. The
   /// lowering process is controllable via the configuration file in the
@@ -405,64 +757,47 @@ public:
         moduleOp.push_back(globalOp.clone());
     }
 
-    // Lambda to apply a specific pipeline to the given ModuleOp
-    auto runPassPipeline = [&](const std::string &pipeline,
-                               mlir::ModuleOp moduleOpIn) {
-      mlir::PassManager pm(&context);
-      std::string errMsg;
-      llvm::raw_string_ostream os(errMsg);
-      cudaq::info("Pass pipeline for {} = {}", kernelName, pipeline);
-      if (failed(parsePassPipeline(pipeline, pm, os)))
-        throw std::runtime_error(
-            "Remote rest platform failed to add passes to pipeline (" + errMsg +
-            ").");
-      if (disableMLIRthreading || enablePrintMLIREachPass)
-        moduleOpIn.getContext()->disableMultithreading();
-      if (enablePrintMLIREachPass)
-        pm.enableIRPrinting();
-      if (failed(pm.run(moduleOpIn)))
-        throw std::runtime_error("Remote rest platform Quake lowering failed.");
-    };
+    std::vector<std::pair<std::string, mlir::ModuleOp>> modules;
+    std::vector<std::size_t> mapping_reorder_idx;
 
-    if (!rawArgs.empty() || updatedArgs) {
-      mlir::PassManager pm(&context);
+    // With late binding, the packed argument buffer is decoded so that both
+    // launch paths go through argument synthesis.
+    bool lateBound = false;
+    if (lateBinding) {
+      std::vector<void *> unpackedArgs;
+      std::deque<std::array<const char *, 3>> vectorStorage;
+      const std::vector<void *> *args = &rawArgs;
+      if (rawArgs.empty() && updatedArgs &&
+          opt::unpackArguments(moduleOp.lookupSymbol<mlir::func::FuncOp>(
+                                   std::string(
+                                       cudaq::runtime::cudaqGenPrefixName) +
+                                   kernelName),
+                               updatedArgs, unpackedArgs, vectorStorage))
+        args = &unpackedArgs;
+      if (!args->empty())
+        lateBound = lowerWithLateBinding(kernelName, moduleOp, *args, modules,
+                                         mapping_reorder_idx);
+    }
+
+    if (!lateBound) {
       if (!rawArgs.empty()) {
-        cudaq::info("Run Argument Synth.\n");
-        opt::ArgumentConverter argCon(kernelName, moduleOp, false);
-        argCon.gen(rawArgs);
-        std::string kernName = cudaq::runtime::cudaqGenPrefixName + kernelName;
-        mlir::SmallVector<mlir::StringRef> kernels = {kernName};
-        std::string substBuff;
-        llvm::raw_string_ostream ss(substBuff);
-        ss << argCon.getSubstitutionModule();
-        mlir::SmallVector<mlir::StringRef> substs = {substBuff};
-        pm.addNestedPass<mlir::func::FuncOp>(
-            opt::createArgumentSynthesisPass(kernels, substs));
+        synthesizeArguments(kernelName, moduleOp, rawArgs);
       } else if (updatedArgs) {
         cudaq::info("Run Quake Synth.\n");
+        mlir::PassManager pm(&context);
         pm.addPass(cudaq::opt::createQuakeSynthesizer(kernelName, updatedArgs));
+        pm.addPass(mlir::createCanonicalizerPass());
+        if (disableMLIRthreading || enablePrintMLIREachPass)
+          moduleOp.getContext()->disableMultithreading();
+        if (enablePrintMLIREachPass)
+          pm.enableIRPrinting();
+        if (failed(pm.run(moduleOp)))
+          throw std::runtime_error("Could not successfully apply quake-synth.");
       }
-      pm.addPass(mlir::createCanonicalizerPass());
-      if (disableMLIRthreading || enablePrintMLIREachPass)
-        moduleOp.getContext()->disableMultithreading();
-      if (enablePrintMLIREachPass)
-        pm.enableIRPrinting();
-      if (failed(pm.run(moduleOp)))
-        throw std::runtime_error("Could not successfully apply quake-synth.");
-    }
-
-    runPassPipeline(passPipelineConfig, moduleOp);
 
-    auto entryPointFunc = moduleOp.lookupSymbol<mlir::func::FuncOp>(
-        std::string(cudaq::runtime::cudaqGenPrefixName) + kernelName);
-    std::vector<std::size_t> mapping_reorder_idx;
-    if (auto mappingAttr = dyn_cast_if_present<mlir::ArrayAttr>(
-            entryPointFunc->getAttr("mapping_reorder_idx"))) {
-      mapping_reorder_idx.resize(mappingAttr.size());
-      std::transform(mappingAttr.begin(), mappingAttr.end(),
-                     mapping_reorder_idx.begin(), [](mlir::Attribute attr) {
-                       return mlir::cast<mlir::IntegerAttr>(attr).getInt();
-                     });
+      runPassPipeline(kernelName, passPipelineConfig, moduleOp);
+      mapping_reorder_idx = getMappingReorderIdx(kernelName, moduleOp);
+      modules = buildExecutionModules(kernelName, moduleOp);
     }
 
     if (executionContext) {
@@ -471,54 +806,8 @@ public:
       else
         executionContext->reorderIdx.clear();
     }
-
-    std::vector<std::pair<std::string, mlir::ModuleOp>> modules;
-    // Apply observations if necessary
-    if (executionContext && executionContext->name == "observe") {
+    if (executionContext && executionContext->name == "observe")
       mapping_reorder_idx.clear();
-      runPassPipeline("canonicalize,cse", moduleOp);
-      cudaq::spin_op &spin = *executionContext->spin.value();
-      for (const auto &term : spin) {
-        if (term.is_identity())
-          continue;
-
-        // Get the ansatz
-        auto ansatz = moduleOp.lookupSymbol<mlir::func::FuncOp>(
-            std::string(cudaq::runtime::cudaqGenPrefixName) + kernelName);
-
-        // Create a new Module to clone the ansatz into it
-        auto tmpModuleOp = builder.create<mlir::ModuleOp>();
-        tmpModuleOp.push_back(ansatz.clone());
-        moduleOp.walk([&](quake::WireSetOp wireSetOp) {
-          tmpModuleOp.push_back(wireSetOp.clone());
-        });
-
-        // Extract the binary symplectic encoding
-        auto [binarySymplecticForm, coeffs] = term.get_raw_data();
-
-        // Create the pass manager, add the quake observe ansatz pass
-        // and run it followed by the canonicalizer
-        mlir::PassManager pm(&context);
-        pm.addNestedPass<mlir::func::FuncOp>(
-            cudaq::opt::createObserveAnsatzPass(binarySymplecticForm[0]));
-        if (disableMLIRthreading || enablePrintMLIREachPass)
-          tmpModuleOp.getContext()->disableMultithreading();
-        if (enablePrintMLIREachPass)
-          pm.enableIRPrinting();
-        if (failed(pm.run(tmpModuleOp)))
-          throw std::runtime_error("Could not apply measurements to ansatz.");
-        // The full pass pipeline was run above, but the ansatz pass can
-        // introduce gates that aren't supported by the backend, so we need to
-        // re-run the gate set mapping if that existed in the original pass
-        // pipeline.
-        auto csvSplit = cudaq::split(passPipelineConfig, ',');
-        for (auto &pass : csvSplit)
-          if (pass.ends_with("-gate-set-mapping"))
-            runPassPipeline(pass, tmpModuleOp);
-        modules.emplace_back(term.to_string(false), tmpModuleOp);
-      }
-    } else
-      modules.emplace_back(kernelName, moduleOp);
 
     if (emulate) {
       // If we are in emulation mode, we need to first get a
@@ -8,6 +8,9 @@
 
 #include "Environment.h"
 #include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <stdexcept>
 #include <string>
 
 namespace cudaq {
@@ -24,4 +27,20 @@ bool getEnvBool(const char *envName, bool defaultVal = false) {
   return defaultVal;
 }
 
+/// @brief Helper function to get floating point environment variable
+double getEnvDouble(const char *envName, double defaultVal = 0.0) {
+  auto *envVal = std::getenv(envName);
+  if (!envVal)
+    return defaultVal;
+
+  const std::string valueStr(envVal);
+  char *endptr = nullptr;
+  errno = 0; // reset errno to 0 before call
+  const double value = std::strtod(valueStr.c_str(), &endptr);
+  if (endptr == valueStr.c_str() || errno != 0)
+    throw std::runtime_error(std::string("Invalid ") + envName +
+                             " setting. Expected a number. Got: " + valueStr);
+  return value;
+}
+
 } // namespace cudaq
@@ -13,4 +13,7 @@ namespace cudaq {
 /// @brief Helper function to get boolean environment variable
 bool getEnvBool(const char *envName, bool defaultVal);
 
+/// @brief Helper function to get floating point environment variable
+double getEnvDouble(const char *envName, double defaultVal);
+
 } // namespace cudaq
@@ -70,6 +70,17 @@ public:
   // by the executor platform.
   std::optional<std::map<std::vector<int>, std::complex<double>>> amplitudeMaps;
 
+  /// @brief Number of qubits of the simulation state
+  // Set by remote executors that only return part of the state (e.g.,
+  // `amplitudeMaps`), so that clients can address the rest of it.
+  std::optional<std::size_t> stateNumQubits;
+
+  /// @brief Largest state (in number of qubits) to return in full along with
+  /// `amplitudeMaps`
+  // Set by clients that would otherwise retrieve a small state in a separate
+  // execution once they know its size.
+  std::optional<std::size_t> maxFullStateQubits;
+
   /// @brief List of pairs of states to compute the overlap
   std::optional<std::pair<const SimulationState *, const SimulationState *>>
       overlapComputeStates;
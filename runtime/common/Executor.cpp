@@ -8,8 +8,15 @@
 
 #include "Executor.h"
 #include "common/Logger.h"
+#include <atomic>
+#include <future>
 
 namespace cudaq {
+ServerMessage Executor::postJob(const std::string &jobPostPath,
+                                ServerMessage &job, RestHeaders &headers) {
+  return client.post(jobPostPath, "", job, headers);
+}
+
 details::future
 Executor::execute(std::vector<KernelExecution> &codesToExecute) {
 
@@ -24,15 +31,42 @@ Executor::execute(std::vector<KernelExecution> &codesToExecute) {
 
   auto config = serverHelper->getConfig();
 
-  std::vector<details::future::Job> ids;
-  for (std::size_t i = 0; auto &job : jobs) {
+  // Post the jobs, keeping up to `maxInFlight` requests in flight at a time
+  // rather than waiting for each round trip in turn.
+  std::vector<ServerMessage> responses(jobs.size());
+  auto post = [&, &jobPostPath = jobPostPath, &headers = headers,
+               &jobs = jobs](std::size_t i) {
     cudaq::info("Job (name={}) created, posting to {}", codesToExecute[i].name,
                 jobPostPath);
-
-    // Post it, get the response
-    auto response = client.post(jobPostPath, "", job, headers);
+    // Each request gets its own copy of the headers, which `postJob` may modify.
+    RestHeaders jobHeaders = headers;
+    responses[i] = postJob(jobPostPath, jobs[i], jobHeaders);
     cudaq::info("Job (name={}) posted, response was {}", codesToExecute[i].name,
-                response.dump());
+                responses[i].dump());
+  };
+  const std::size_t numJobs = responses.size();
+  auto maxInFlight = std::min(
+      maxConcurrentSubmissions.value_or(
+          serverHelper->getMaxConcurrentSubmissions()),
+      numJobs);
+  if (maxInFlight <= 1) {
+    for (std::size_t i = 0; i < numJobs; ++i)
+      post(i);
+  } else {
+    std::atomic<std::size_t> nextJob = 0;
+    std::vector<std::future<void>> workers;
+    for (std::size_t w = 0; w < maxInFlight; ++w)
+      workers.emplace_back(std::async(std::launch::async, [&]() {
+        for (auto i = nextJob++; i < numJobs; i = nextJob++)
+          post(i);
+      }));
+    for (auto &worker : workers)
+      worker.get();
+  }
+
+  std::vector<details::future::Job> ids;
+  for (std::size_t i = 0; auto &job : jobs) {
+    auto &response = responses[i];
 
     // Add the job id and the job name.
     auto task_id = serverHelper->extractJobId(response);
@@ -10,6 +10,7 @@
 #include "common/ExecutionContext.h"
 #include "common/RestClient.h"
 #include "common/ServerHelper.h"
+#include <optional>
 
 namespace cudaq {
 
@@ -29,6 +30,17 @@ protected:
   /// @brief The number of shots to execute
   std::size_t shots = 100;
 
+  /// @brief The maximum number of jobs to post concurrently, if set with the
+  /// `max_concurrent_submissions` target option. Otherwise, the server helper
+  /// decides.
+  std::optional<std::size_t> maxConcurrentSubmissions;
+
+  /// @brief Post the job message \p job to \p jobPostPath and return the
+  /// server response. This is called concurrently for the jobs of an
+  /// execution.
+  virtual ServerMessage postJob(const std::string &jobPostPath,
+                                ServerMessage &job, RestHeaders &headers);
+
 public:
   Executor() = default;
   virtual ~Executor() = default;
@@ -39,6 +51,12 @@ public:
   /// @brief Set the number of shots to execute
   void setShots(std::size_t s) { shots = s; }
 
+  /// @brief Set the maximum number of jobs that are posted concurrently,
+  /// overriding the default of the server helper.
+  void setMaxConcurrentSubmissions(std::size_t n) {
+    maxConcurrentSubmissions = n;
+  }
+
   /// @brief Execute the provided quantum codes and return a future object
   /// The caller can make this synchronous by just immediately calling .get().
   details::future execute(std::vector<KernelExecution> &codesToExecute);
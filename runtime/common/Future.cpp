@@ -7,11 +7,11 @@
  ******************************************************************************/
 
 #include "Future.h"
+#include "JobPoller.h"
 #include "Logger.h"
 #include "ObserveResult.h"
 #include "RestClient.h"
 #include "ServerHelper.h"
-#include <thread>
 
 namespace cudaq::details {
 
@@ -20,26 +20,45 @@ sample_result future::get() {
     return inFuture.get();
 
 #ifdef CUDAQ_RESTCLIENT_AVAILABLE
-  RestClient client;
   auto serverHelper = registry::get<ServerHelper>(qpuName);
   serverHelper->initialize(serverConfig);
-  auto headers = serverHelper->getHeaders();
 
-  std::vector<ExecutionResult> results;
+  // Hand all jobs to the poller at once, so that they are waited on
+  // concurrently. The jobs are polled through a server helper and a connection
+  // of their own, which the poll functions share ownership of, since they run
+  // on the poller thread.
+  std::shared_ptr<ServerHelper> pollHelper =
+      registry::get<ServerHelper>(qpuName);
+  pollHelper->initialize(serverConfig);
+  auto client = std::make_shared<RestClient>();
+  auto headers = pollHelper->getHeaders();
+  std::vector<std::future<ServerMessage>> pending;
   for (auto &id : jobs) {
     cudaq::info("Future retrieving results for {}.", id.first);
 
-    auto jobGetPath = serverHelper->constructGetJobPath(id.first);
+    auto jobGetPath = pollHelper->constructGetJobPath(id.first);
 
     cudaq::info("Future got job retrieval path as {}.", jobGetPath);
-    auto resultResponse = client.get(jobGetPath, "", headers);
-    while (!serverHelper->jobIsDone(resultResponse)) {
-      auto polling_interval =
-          serverHelper->nextResultPollingInterval(resultResponse);
-      std::this_thread::sleep_for(polling_interval);
-      resultResponse = client.get(jobGetPath, "", headers);
-    }
-    auto c = serverHelper->processResults(resultResponse, id.first);
+    pending.push_back(JobPoller::get().submit(
+        [pollHelper, client, jobGetPath, headers, jobId = id.first]() mutable {
+          JobPoller::PollResult result;
+          result.response = client->get(jobGetPath, "", headers);
+          result.done = pollHelper->jobIsDone(result.response);
+          if (result.done)
+            cudaq::info("Future job {} is done.", jobId);
+          else
+            result.interval =
+                pollHelper->nextResultPollingInterval(result.response);
+          return result;
+        }));
+  }
+
+  // Process the results on this thread, in order.
+  std::vector<ExecutionResult> results;
+  for (std::size_t i = 0; i < jobs.size(); ++i) {
+    auto &id = jobs[i];
+    auto response = pending[i].get();
+    auto c = serverHelper->processResults(response, id.first);
 
     // If there are multiple jobs, this is likely a spin_op.
     // If so, use the job name instead of the global register.
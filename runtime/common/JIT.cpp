@@ -7,6 +7,8 @@
  ******************************************************************************/
 
 #include "JIT.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/ExecutionEngine/JITEventListener.h"
 #include "llvm/ExecutionEngine/ObjectCache.h"
 #include "llvm/ExecutionEngine/Orc/CompileUtils.h"
@@ -19,22 +21,172 @@
 #include "llvm/IRReader/IRReader.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/ErrorOr.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Host.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/PrettyStackTrace.h"
+#include "llvm/Support/SHA1.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/raw_ostream.h"
 #include "mlir/ExecutionEngine/ExecutionEngine.h"
+#include <algorithm>
+#include <cerrno>
 #include <cxxabi.h>
+#include <filesystem>
+#include <vector>
 
 #define DEBUG_TYPE "cudaq-qpud"
 
 namespace cudaq {
-std::unique_ptr<llvm::orc::LLJIT>
-invokeWrappedKernel(std::string_view irString, const std::string &entryPointFn,
-                    void *args, std::uint64_t argsSize, std::size_t numTimes,
-                    std::function<void(std::size_t)> postExecCallback) {
+JITObjectCache::JITObjectCache(std::string cacheDir, std::uint64_t maxSize)
+    : cacheDir(std::move(cacheDir)), maxSize(maxSize) {}
+
+std::string JITObjectCache::getCacheFile(const llvm::Module *module) const {
+  llvm::SmallVector<char, 0> bitcode;
+  llvm::raw_svector_ostream os(bitcode);
+  llvm::WriteBitcodeToFile(*module, os);
+  llvm::SHA1 hasher;
+  hasher.update(llvm::ArrayRef<std::uint8_t>(
+      reinterpret_cast<const std::uint8_t *>(bitcode.data()), bitcode.size()));
+  // The JIT targets the host, so objects are only valid on the same CPU.
+  hasher.update(llvm::sys::getHostCPUName());
+  hasher.update(LLVM_VERSION_STRING);
+  llvm::SmallString<128> path(cacheDir);
+  llvm::sys::path::append(path, llvm::toHex(hasher.final()) + ".o");
+  return std::string(path);
+}
+
+void JITObjectCache::notifyObjectCompiled(const llvm::Module *module,
+                                          llvm::MemoryBufferRef object) {
+  // The object is compiled right after `getObject` missed, which has already
+  // hashed the module.
+  std::string fileName;
+  {
+    std::lock_guard<std::mutex> lock(pendingFilesMutex);
+    auto iter = pendingFiles.find(module);
+    if (iter != pendingFiles.end()) {
+      fileName = std::move(iter->second);
+      pendingFiles.erase(iter);
+    }
+  }
+  if (fileName.empty())
+    fileName = getCacheFile(module);
+  if (auto ec = llvm::sys::fs::create_directories(cacheDir)) {
+    LLVM_DEBUG(llvm::dbgs() << "Cannot create JIT cache directory " << cacheDir
+                            << ": " << ec.message() << '\n');
+    return;
+  }
+  // Write to a temporary file first and rename it, so that concurrent
+  // processes never observe a partially written object.
+  int fd;
+  llvm::SmallString<128> tmpName;
+  if (llvm::sys::fs::createUniqueFile(fileName + ".%%%%%%.tmp", fd, tmpName))
+    return;
+  {
+    llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+    os << object.getBuffer();
+    if (os.has_error()) {
+      os.clear_error();
+      llvm::sys::fs::remove(tmpName);
+      return;
+    }
+  }
+  if (llvm::sys::fs::rename(tmpName, fileName)) {
+    llvm::sys::fs::remove(tmpName);
+    return;
+  }
+  prune();
+}
+
+void JITObjectCache::prune() const {
+  namespace fs = std::filesystem;
+  struct CacheFile {
+    fs::path path;
+    fs::file_time_type lastUse;
+    std::uintmax_t size;
+  };
+  std::vector<CacheFile> files;
+  std::uintmax_t totalSize = 0;
+  const auto staleTime = fs::file_time_type::clock::now() - maxAge;
+  std::error_code ec;
+  for (const auto &entry : fs::directory_iterator(cacheDir, ec)) {
+    if (entry.path().extension() != ".o")
+      continue;
+    std::error_code fileEc;
+    const auto lastUse = entry.last_write_time(fileEc);
+    const auto size = entry.file_size(fileEc);
+    // The file may have been removed by another process in the meantime.
+    if (fileEc)
+      continue;
+    if (lastUse < staleTime) {
+      fs::remove(entry.path(), fileEc);
+      continue;
+    }
+    files.push_back({entry.path(), lastUse, size});
+    totalSize += size;
+  }
+  if (totalSize <= maxSize)
+    return;
+  std::sort(files.begin(), files.end(), [](const auto &a, const auto &b) {
+    return a.lastUse < b.lastUse;
+  });
+  for (const auto &file : files) {
+    if (totalSize <= maxSize)
+      break;
+    LLVM_DEBUG(llvm::dbgs() << "Evicting JIT object " << file.path.string()
+                            << '\n');
+    fs::remove(file.path, ec);
+    totalSize -= file.size;
+  }
+}
+
+std::unique_ptr<llvm::MemoryBuffer>
+JITObjectCache::getObject(const llvm::Module *module) {
+  auto fileName = getCacheFile(module);
+  auto buffer = llvm::MemoryBuffer::getFile(fileName, /*IsText=*/false,
+                                            /*RequiresNullTerminator=*/false);
+  if (!buffer) {
+    std::lock_guard<std::mutex> lock(pendingFilesMutex);
+    pendingFiles[module] = std::move(fileName);
+    return nullptr;
+  }
+  LLVM_DEBUG(llvm::dbgs() << "Loaded JIT object from " << fileName << '\n');
+  // Record the use, so that the least recently used objects are evicted
+  // first.
+  std::error_code ec;
+  std::filesystem::last_write_time(
+      fileName, std::filesystem::file_time_type::clock::now(), ec);
+  return std::move(*buffer);
+}
+
+JITObjectCache *JITObjectCache::get() {
+  static std::unique_ptr<JITObjectCache> cache = []() {
+    const char *cacheDir = std::getenv("CUDAQ_JIT_CACHE_DIR");
+    if (!cacheDir || !*cacheDir)
+      return std::unique_ptr<JITObjectCache>{};
+    std::uint64_t maxSize = defaultMaxSize;
+    if (auto *maxSizeEnvVar = std::getenv("CUDAQ_JIT_CACHE_MAX_SIZE")) {
+      const std::string maxSizeStr(maxSizeEnvVar);
+      const char *nptr = maxSizeStr.data();
+      char *endptr = nullptr;
+      errno = 0; // reset errno to 0 before call
+      const auto value = strtoll(nptr, &endptr, 10);
+      if (nptr == endptr || *endptr != '\0' || errno != 0 || value < 1)
+        throw std::runtime_error("Invalid CUDAQ_JIT_CACHE_MAX_SIZE setting. "
+                                 "Expected a positive number of MB. Got: " +
+                                 maxSizeStr);
+      maxSize = static_cast<std::uint64_t>(value) << 20;
+    }
+    return std::make_unique<JITObjectCache>(cacheDir, maxSize);
+  }();
+  return cache.get();
+}
+
+WrappedKernel compileWrappedKernel(std::string_view irString,
+                                   const std::string &entryPointFn) {
 
   std::unique_ptr<llvm::LLVMContext> ctx(new llvm::LLVMContext);
   // Parse bitcode
@@ -113,11 +265,22 @@ invokeWrappedKernel(std::string_view irString, const std::string &entryPointFn,
     return objectLayer;
   };
 
-  // Create the LLJIT with the object link layer
-  auto jit = llvm::cantFail(
-      llvm::orc::LLJITBuilder()
-          .setObjectLinkingLayerCreator(objectLinkingLayerCreator)
-          .create());
+  // Create the LLJIT with the object link layer, and with the on-disk object
+  // cache, if enabled.
+  llvm::orc::LLJITBuilder jitBuilder;
+  jitBuilder.setObjectLinkingLayerCreator(objectLinkingLayerCreator);
+  if (auto *cache = JITObjectCache::get())
+    jitBuilder.setCompileFunctionCreator(
+        [cache](llvm::orc::JITTargetMachineBuilder jtmb)
+            -> llvm::Expected<
+                std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
+          auto tm = jtmb.createTargetMachine();
+          if (!tm)
+            return tm.takeError();
+          return std::make_unique<llvm::orc::TMOwningSimpleCompiler>(
+              std::move(*tm), cache);
+        });
+  auto jit = llvm::cantFail(jitBuilder.create());
 
   // Add a ThreadSafemodule to the engine and return.
   llvm::orc::ThreadSafeModule tsm(std::move(llvmModule), std::move(ctx));
@@ -130,20 +293,36 @@ invokeWrappedKernel(std::string_view irString, const std::string &entryPointFn,
           dataLayout.getGlobalPrefix())));
 
   // Symbol lookup: kernel and wrapper
+  WrappedKernel result;
   auto kernelSymbolAddr = llvm::cantFail(jit->lookup(mangledKernelNames.first));
-  void *fptr = kernelSymbolAddr.toPtr<void *>();
+  result.kernel = kernelSymbolAddr.toPtr<void *>();
   auto wrapperSymbolAddr =
       llvm::cantFail(jit->lookup(mangledKernelNames.second));
-  auto *fptrWrapper =
+  result.wrapper =
       wrapperSymbolAddr.toPtr<void (*)(const void *, unsigned long, void *)>();
+  result.jit = std::move(jit);
+  return result;
+}
+
+void invokeWrappedKernel(const WrappedKernel &kernel, void *args,
+                         std::uint64_t argsSize, std::size_t numTimes,
+                         std::function<void(std::size_t)> postExecCallback) {
   for (std::size_t i = 0; i < numTimes; ++i) {
     // Invoke the wrapper with serialized data and the kernel.
-    fptrWrapper(args, argsSize, fptr);
+    kernel.wrapper(args, argsSize, kernel.kernel);
     if (postExecCallback) {
       postExecCallback(i);
     }
   }
+}
 
-  return jit;
+std::unique_ptr<llvm::orc::LLJIT>
+invokeWrappedKernel(std::string_view irString, const std::string &entryPointFn,
+                    void *args, std::uint64_t argsSize, std::size_t numTimes,
+                    std::function<void(std::size_t)> postExecCallback) {
+  auto kernel = compileWrappedKernel(irString, entryPointFn);
+  invokeWrappedKernel(kernel, args, argsSize, numTimes,
+                      std::move(postExecCallback));
+  return std::move(kernel.jit);
 }
 } // namespace cudaq
@@ -7,13 +7,79 @@
  ******************************************************************************/
 #pragma once
 
+#include "llvm/ExecutionEngine/ObjectCache.h"
 #include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 namespace cudaq {
+/// An `llvm::ObjectCache` that keeps the machine code of JIT compiled modules
+/// on disk, so that it can be reused across processes. Objects are keyed on
+/// the bitcode of the module (which includes the target triple and data
+/// layout), the host CPU, and the LLVM version.
+///
+/// After each store, the objects that were not used for `maxAge` are removed,
+/// and then the least recently used ones until the cache fits in `maxSize`
+/// bytes.
+class JITObjectCache : public llvm::ObjectCache {
+public:
+  /// Default size bound of the cache, 1 GB.
+  static constexpr std::uint64_t defaultMaxSize = 1ULL << 30;
+  /// Objects that were not used for 30 days are removed.
+  static constexpr std::chrono::hours maxAge{24 * 30};
+
+  explicit JITObjectCache(std::string cacheDir,
+                          std::uint64_t maxSize = defaultMaxSize);
+
+  void notifyObjectCompiled(const llvm::Module *module,
+                            llvm::MemoryBufferRef object) override;
+  std::unique_ptr<llvm::MemoryBuffer>
+  getObject(const llvm::Module *module) override;
+
+  /// Return the process-wide object cache in the directory given by the
+  /// `CUDAQ_JIT_CACHE_DIR` environment variable, or nullptr if it is not set.
+  /// Its size bound is `CUDAQ_JIT_CACHE_MAX_SIZE` MB, if set.
+  static JITObjectCache *get();
+
+private:
+  std::string getCacheFile(const llvm::Module *module) const;
+
+  /// Remove the stale objects, then the least recently used ones until the
+  /// cache fits in `maxSize`.
+  void prune() const;
+
+  std::string cacheDir;
+  std::uint64_t maxSize;
+  /// Cache files of the modules that missed in `getObject`, so that hashing
+  /// the module is not repeated when its object is stored afterwards.
+  std::unordered_map<const llvm::Module *, std::string> pendingFiles;
+  std::mutex pendingFilesMutex;
+};
+
+/// A JIT compiled kernel together with its `invokeCallableWithSerializedArgs`
+/// wrapper. The function pointers are valid as long as `jit` is alive.
+struct WrappedKernel {
+  std::unique_ptr<llvm::orc::LLJIT> jit;
+  void *kernel = nullptr;
+  void (*wrapper)(const void *, unsigned long, void *) = nullptr;
+};
+
+/// Util to JIT compile a wrapped kernel defined by LLVM IR, so that it can be
+/// invoked any number of times.
+WrappedKernel compileWrappedKernel(std::string_view llvmIr,
+                                   const std::string &kernelName);
+
+/// Util to invoke a compiled wrapped kernel with serialized arguments,
+/// optionally a number of times along with a post-execution callback.
+void invokeWrappedKernel(const WrappedKernel &kernel, void *args,
+                         std::uint64_t argsSize, std::size_t numTimes = 1,
+                         std::function<void(std::size_t)> postExecCallback = {});
+
 /// Util to invoke a wrapped kernel defined by LLVM IR with serialized
 /// arguments.
 // Note: We don't use `mlir::ExecutionEngine` to skip unnecessary
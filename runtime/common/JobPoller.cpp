@@ -0,0 +1,80 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "JobPoller.h"
+#include <optional>
+
+namespace cudaq::details {
+
+JobPoller::JobPoller() : worker([this] { run(); }) {}
+
+JobPoller::~JobPoller() {
+  {
+    std::scoped_lock lock(mutex);
+    stopping = true;
+  }
+  wakeUp.notify_one();
+  worker.join();
+}
+
+JobPoller &JobPoller::get() {
+  static JobPoller poller;
+  return poller;
+}
+
+std::future<ServerMessage> JobPoller::submit(PollFunction poll) {
+  PendingJob job{std::move(poll)};
+  auto result = job.result.get_future();
+  {
+    std::scoped_lock lock(mutex);
+    queue.emplace(Clock::now(), std::move(job));
+  }
+  wakeUp.notify_one();
+  return result;
+}
+
+void JobPoller::run() {
+  std::unique_lock lock(mutex);
+  while (true) {
+    wakeUp.wait(lock, [&] { return stopping || !queue.empty(); });
+    if (stopping)
+      return;
+    // Sleep until the earliest job is due, or an earlier one is submitted.
+    auto due = queue.begin()->first;
+    if (due > Clock::now()) {
+      wakeUp.wait_until(lock, due);
+      continue;
+    }
+    auto job = std::move(queue.begin()->second);
+    queue.erase(queue.begin());
+    lock.unlock();
+
+    std::optional<Clock::time_point> nextPoll;
+    try {
+      auto result = job.poll();
+      if (result.done) {
+        job.result.set_value(std::move(result.response));
+      } else {
+        auto interval = std::max(result.interval, minInterval);
+        job.backoff = job.backoff.count() == 0
+                          ? interval
+                          : std::min(2 * job.backoff,
+                                     std::max(interval, maxBackoff));
+        nextPoll = Clock::now() + job.backoff;
+      }
+    } catch (...) {
+      job.result.set_exception(std::current_exception());
+    }
+
+    lock.lock();
+    if (nextPoll)
+      queue.emplace(*nextPoll, std::move(job));
+  }
+}
+
+} // namespace cudaq::details
@@ -0,0 +1,81 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include "ServerHelper.h"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace cudaq::details {
+
+/// @brief Poller for the jobs of REST futures. A single background thread
+/// polls each outstanding job when it is due, and hands the final response of
+/// a job to its waiter as soon as the job is done, irrespective of the order in
+/// which the jobs were submitted. Processing the response is left to the
+/// waiter, so that a slow download of the results of one job does not hold up
+/// the polling of the others. Jobs that are not done are polled again after the
+/// interval requested by the poll, backing off exponentially up to
+/// `maxBackoff` (or the requested interval, if larger).
+class JobPoller {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /// @brief Shortest interval between two polls of the same job, so that a
+  /// provider reporting an interval of 0 does not make the poller spin.
+  static constexpr std::chrono::microseconds minInterval{1000};
+  static constexpr std::chrono::microseconds maxBackoff{1000000};
+
+  /// @brief The outcome of polling a job once.
+  struct PollResult {
+    /// @brief Whether the job is done.
+    bool done = false;
+    /// @brief The response of the poll, which is returned to the waiter once
+    /// the job is done.
+    ServerMessage response;
+    /// @brief The interval after which to poll the job again, if it is not
+    /// done.
+    std::chrono::microseconds interval{0};
+  };
+
+  /// @brief Poll a job once. This is called on the poller thread.
+  using PollFunction = std::function<PollResult()>;
+
+  JobPoller();
+  ~JobPoller();
+
+  /// @brief Return the process-wide poller.
+  static JobPoller &get();
+
+  /// @brief Call \p poll until it reports the job as done, and return the
+  /// final response. Exceptions thrown by \p poll are forwarded to the
+  /// returned future.
+  std::future<ServerMessage> submit(PollFunction poll);
+
+private:
+  struct PendingJob {
+    PollFunction poll;
+    std::chrono::microseconds backoff{0};
+    std::promise<ServerMessage> result;
+  };
+
+  void run();
+
+  std::multimap<Clock::time_point, PendingJob> queue;
+  std::mutex mutex;
+  std::condition_variable wakeUp;
+  bool stopping = false;
+  std::thread worker;
+};
+
+} // namespace cudaq::details
@@ -15,7 +15,12 @@
 #include "cudaq/gradients.h"
 #include "cudaq/optimizers.h"
 #include "cudaq/simulators.h"
+#include "llvm/Support/Base64.h"
+#include "llvm/Support/Error.h"
 #include "nlohmann/json.hpp"
+#include <cstring>
+#include <functional>
+#include <numeric>
 /*! \file
     \brief Utility to support JSON serialization between the client and server.
 */
@@ -77,6 +82,51 @@ inline void from_json(const json &j, ExecutionResult &result) {
   }
 }
 
+// Serialize the amplitudes of a simulation state. If `binary` is set, the
+// amplitudes are sent as base64-encoded `std::complex<double>` values rather
+// than as a JSON array of pairs, which is several times smaller and much faster
+// to produce and parse.
+inline json serializeSimulationData(const SimulationState &state,
+                                    bool binary = false) {
+  json j;
+  if (state.isArrayLike()) {
+    j["dim"] = state.getTensor().extents;
+  } else {
+    // Tensor-network like states: we serialize the flattened state vector.
+    j["dim"] = std::vector<std::size_t>{1ULL << state.getNumQubits()};
+  }
+  const auto hostDataSize = state.isArrayLike() ? state.getNumElements()
+                                                : 1ULL << state.getNumQubits();
+  std::vector<std::complex<double>> hostData;
+  const std::complex<double> *data = nullptr;
+  if (state.getPrecision() == cudaq::SimulationState::precision::fp32) {
+    // Single-precision data, on the device or on the host, is converted.
+    if (state.isDeviceData()) {
+      std::vector<std::complex<float>> fp32Data(hostDataSize);
+      state.toHost(fp32Data.data(), fp32Data.size());
+      hostData.assign(fp32Data.begin(), fp32Data.end());
+    } else {
+      const auto *fp32Data =
+          reinterpret_cast<std::complex<float> *>(state.getTensor().data);
+      hostData.assign(fp32Data, fp32Data + hostDataSize);
+    }
+    data = hostData.data();
+  } else if (state.isDeviceData()) {
+    hostData.resize(hostDataSize);
+    state.toHost(hostData.data(), hostData.size());
+    data = hostData.data();
+  } else {
+    data = reinterpret_cast<std::complex<double> *>(state.getTensor().data);
+  }
+  if (binary)
+    j["binaryData"] = llvm::encodeBase64(
+        llvm::StringRef(reinterpret_cast<const char *>(data),
+                        hostDataSize * sizeof(std::complex<double>)));
+  else
+    j["data"] = std::vector<std::complex<double>>(data, data + hostDataSize);
+  return j;
+}
+
 // `ExecutionContext` serialization.
 inline void to_json(json &j, const ExecutionContext &context) {
   j = json{{"name", context.name},
@@ -105,39 +155,8 @@ inline void to_json(json &j, const ExecutionContext &context) {
   if (context.optResult.has_value())
     j["optResult"] = context.optResult.value();
 
-  if (context.simulationState) {
-    j["simulationData"] = json();
-    if (context.simulationState->isArrayLike()) {
-      j["simulationData"]["dim"] = context.simulationState->getTensor().extents;
-    } else {
-      // Tensor-network like states: we serialize the flattened state vector.
-      j["simulationData"]["dim"] = std::vector<std::size_t>{
-          1ULL << context.simulationState->getNumQubits()};
-    }
-    const auto hostDataSize =
-        context.simulationState->isArrayLike()
-            ? context.simulationState->getNumElements()
-            : 1ULL << context.simulationState->getNumQubits();
-    if (context.simulationState->isDeviceData()) {
-      if (context.simulationState->getPrecision() ==
-          cudaq::SimulationState::precision::fp32) {
-        std::vector<std::complex<float>> hostData(hostDataSize);
-        context.simulationState->toHost(hostData.data(), hostData.size());
-        std::vector<std::complex<double>> converted(hostData.begin(),
-                                                    hostData.end());
-        j["simulationData"]["data"] = converted;
-      } else {
-        std::vector<std::complex<double>> hostData(hostDataSize);
-        context.simulationState->toHost(hostData.data(), hostData.size());
-        j["simulationData"]["data"] = hostData;
-      }
-    } else {
-      auto *ptr = reinterpret_cast<std::complex<double> *>(
-          context.simulationState->getTensor().data);
-      j["simulationData"]["data"] = std::vector<std::complex<double>>(
-          ptr, ptr + context.simulationState->getNumElements());
-    }
-  }
+  if (context.simulationState)
+    j["simulationData"] = serializeSimulationData(*context.simulationState);
 
   if (context.spin.has_value() && context.spin.value() != nullptr) {
     const std::vector<double> spinOpRepr =
@@ -154,10 +173,29 @@ inline void to_json(json &j, const ExecutionContext &context) {
   if (context.amplitudeMaps.has_value())
     j["amplitudeMaps"] = context.amplitudeMaps.value();
 
+  if (context.stateNumQubits.has_value())
+    j["stateNumQubits"] = context.stateNumQubits.value();
+
+  if (context.maxFullStateQubits.has_value())
+    j["maxFullStateQubits"] = context.maxFullStateQubits.value();
+
   if (!context.invocationResultBuffer.empty())
     j["invocationResultBuffer"] = context.invocationResultBuffer;
 }
 
+// Serialize `context` as `to_json` does, except that the simulation state (if
+// any) is encoded in binary. Only use this for peers that support it.
+inline json serializeWithBinaryState(ExecutionContext &context) {
+  if (!context.simulationState)
+    return context;
+  auto state = std::move(context.simulationState);
+  json j = context;
+  context.simulationState = std::move(state);
+  j["simulationData"] =
+      serializeSimulationData(*context.simulationState, /*binary=*/true);
+  return j;
+}
+
 inline void from_json(const json &j, ExecutionContext &context) {
   j.at("shots").get_to(context.shots);
   j.at("hasConditionalsOnMeasureResults")
@@ -187,7 +225,30 @@ inline void from_json(const json &j, ExecutionContext &context) {
     std::vector<std::size_t> stateDim;
     std::vector<std::complex<double>> stateData;
     j["simulationData"]["dim"].get_to(stateDim);
-    j["simulationData"]["data"].get_to(stateData);
+    const std::size_t numElements =
+        stateDim.empty() ? 0
+                         : std::accumulate(stateDim.begin(), stateDim.end(),
+                                           std::size_t(1),
+                                           std::multiplies<std::size_t>());
+    if (j["simulationData"].contains("binaryData")) {
+      std::vector<char> bytes;
+      if (auto err = llvm::decodeBase64(
+              j["simulationData"]["binaryData"].get<std::string>(), bytes))
+        throw std::runtime_error("Invalid binary simulation data: " +
+                                 llvm::toString(std::move(err)));
+      if (bytes.size() != numElements * sizeof(std::complex<double>))
+        throw std::runtime_error(fmt::format(
+            "Invalid binary simulation data: got {} bytes for {} amplitudes.",
+            bytes.size(), numElements));
+      stateData.resize(numElements);
+      std::memcpy(stateData.data(), bytes.data(), bytes.size());
+    } else {
+      j["simulationData"]["data"].get_to(stateData);
+      if (stateData.size() != numElements)
+        throw std::runtime_error(fmt::format(
+            "Invalid simulation data: got {} amplitudes, expected {}.",
+            stateData.size(), numElements));
+    }
 
     // Note: before `SimulationState` was added, `simulationData` contains a
     // flat pair of dimensions and data, whereby an empty dimension array
@@ -218,6 +279,12 @@ inline void from_json(const json &j, ExecutionContext &context) {
   if (j.contains("amplitudeMaps"))
     context.amplitudeMaps = j["amplitudeMaps"];
 
+  if (j.contains("stateNumQubits"))
+    context.stateNumQubits = j["stateNumQubits"];
+
+  if (j.contains("maxFullStateQubits"))
+    context.maxFullStateQubits = j["maxFullStateQubits"];
+
   if (j.contains("invocationResultBuffer"))
     context.invocationResultBuffer = j["invocationResultBuffer"];
 }
@@ -572,7 +639,7 @@ public:
   static constexpr std::size_t REST_PAYLOAD_MINOR_VERSION = 1;
   RestRequest(ExecutionContext &context, int versionNumber)
       : executionContext(context), version(versionNumber),
-        clientVersion(CUDA_QUANTUM_VERSION) {}
+        clientVersion(CUDA_QUANTUM_VERSION), acceptsBinaryData(true) {}
   RestRequest(const json &j)
       : m_deserializedContext(
             std::make_unique<ExecutionContext>(j["executionContext"]["name"])),
@@ -613,6 +680,9 @@ public:
   // subset of Python source code. The server will execute serialized code in
   // this context
   std::optional<SerializedCodeExecutionContext> serializedCodeExecutionContext;
+  // Whether the client can decode binary-encoded simulation data in the
+  // response. Older clients don't set this field, and older servers ignore it.
+  std::optional<bool> acceptsBinaryData;
 
   friend void to_json(json &j, const RestRequest &p) {
     TO_JSON_HELPER(version);
@@ -628,6 +698,7 @@ public:
     TO_JSON_HELPER(passes);
     TO_JSON_HELPER(clientVersion);
     TO_JSON_OPT_HELPER(serializedCodeExecutionContext);
+    TO_JSON_OPT_HELPER(acceptsBinaryData);
   }
 
   friend void from_json(const json &j, RestRequest &p) {
@@ -644,9 +715,18 @@ public:
     FROM_JSON_HELPER(passes);
     FROM_JSON_HELPER(clientVersion);
     FROM_JSON_OPT_HELPER(serializedCodeExecutionContext);
+    FROM_JSON_OPT_HELPER(acceptsBinaryData);
   }
 };
 
+// Serialize the execution context of `request` for the response. The
+// simulation state is encoded in binary only for clients that advertise it.
+inline json serializeResponseContext(RestRequest &request) {
+  if (request.acceptsBinaryData.value_or(false))
+    return serializeWithBinaryState(request.executionContext);
+  return request.executionContext;
+}
+
 /// NVCF function version status
 enum class FunctionStatus { ACTIVE, DEPLOYING, ERROR, INACTIVE, DELETED };
 NLOHMANN_JSON_SERIALIZE_ENUM(FunctionStatus,
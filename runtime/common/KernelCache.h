@@ -0,0 +1,63 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+#pragma once
+
+#include "common/Logger.h"
+#include <deque>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+namespace cudaq {
+
+/// @brief Cache of JIT compiled kernels, keyed on a string that identifies
+/// their code. Once the cache holds `capacity` kernels, the oldest one is
+/// evicted, after being passed to the `onEvict` callback.
+template <typename T>
+class KernelCache {
+public:
+  explicit KernelCache(std::size_t capacity,
+                       std::function<void(T &)> onEvict = {})
+      : capacity(capacity), onEvict(std::move(onEvict)) {}
+
+  /// @brief Return the kernel with the given \p key, compiling it with
+  /// \p compile and inserting it if it is not cached. If \p compile throws,
+  /// the cache is left unchanged.
+  template <typename Compile>
+  T &get(const std::string &key, Compile &&compile) {
+    auto iter = kernels.find(key);
+    if (iter != kernels.end()) {
+      cudaq::info("Reusing cached JIT compiled kernel.");
+      return iter->second;
+    }
+    // Compile before making room, so that a failure does not evict anything
+    // nor leave a key without a kernel behind.
+    T kernel = compile();
+    if (kernels.size() >= capacity) {
+      auto evicted = kernels.find(insertionOrder.front());
+      if (onEvict)
+        onEvict(evicted->second);
+      kernels.erase(evicted);
+      insertionOrder.pop_front();
+    }
+    iter = kernels.emplace(key, std::move(kernel)).first;
+    insertionOrder.push_back(key);
+    return iter->second;
+  }
+
+  /// @brief Return the number of cached kernels.
+  std::size_t size() const { return kernels.size(); }
+
+private:
+  std::size_t capacity;
+  std::function<void(T &)> onEvict;
+  std::unordered_map<std::string, T> kernels;
+  std::deque<std::string> insertionOrder;
+};
+
+} // namespace cudaq
@@ -0,0 +1,118 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "LateBinding.h"
+#include "cudaq/Optimizer/Builder/Factory.h"
+#include "cudaq/Optimizer/Dialect/CC/CCOps.h"
+#include "cudaq/Optimizer/Dialect/CC/CCTypes.h"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/IR/DataLayout.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include <atomic>
+
+using namespace mlir;
+
+static std::atomic<std::size_t> structuralCompileCount = 0;
+
+void cudaq::opt::recordStructuralCompile() { ++structuralCompileCount; }
+
+std::size_t cudaq::opt::getStructuralCompileCount() {
+  return structuralCompileCount;
+}
+
+static bool isLateBindableScalar(Type ty) {
+  return isa<Float32Type, Float64Type>(ty);
+}
+
+std::unordered_set<unsigned>
+cudaq::opt::getLateBoundArguments(FunctionType funcTy) {
+  std::unordered_set<unsigned> result;
+  for (auto iter : llvm::enumerate(funcTy.getInputs())) {
+    Type ty = iter.value();
+    if (auto vecTy = dyn_cast<cc::StdvecType>(ty))
+      ty = vecTy.getElementType();
+    if (isLateBindableScalar(ty))
+      result.insert(iter.index());
+  }
+  return result;
+}
+
+void cudaq::opt::scalarizeVectorArguments(
+    func::FuncOp func, ArrayRef<std::pair<unsigned, std::size_t>> vectors) {
+  if (vectors.empty())
+    return;
+  auto *ctx = func.getContext();
+  auto loc = func.getLoc();
+  Block &entry = func.getBody().front();
+  OpBuilder builder = OpBuilder::atBlockBegin(&entry);
+  for (auto [pos, size] : vectors) {
+    BlockArgument vecArg = entry.getArgument(pos);
+    auto vecTy = cast<cc::StdvecType>(vecArg.getType());
+    auto eleTy = vecTy.getElementType();
+    auto elePtrTy = cc::PointerType::get(eleTy);
+    auto buffer = builder.create<cc::AllocaOp>(
+        loc, cc::ArrayType::get(ctx, eleTy, size));
+    for (std::int32_t i = 0, end = size; i < end; ++i) {
+      unsigned newPos = func.getNumArguments();
+      func.insertArgument(newPos, eleTy, {}, loc);
+      auto atLoc = builder.create<cc::ComputePtrOp>(
+          loc, elePtrTy, buffer, ArrayRef<cc::ComputePtrArg>{i});
+      builder.create<cc::StoreOp>(loc, entry.getArgument(newPos), atLoc);
+    }
+    auto length = builder.create<arith::ConstantIntOp>(loc, size, 64);
+    Value vec = builder.create<cc::StdvecInitOp>(loc, vecTy, buffer, length);
+    vecArg.replaceAllUsesWith(vec);
+  }
+  llvm::BitVector argsToErase(func.getNumArguments());
+  for (auto &vector : vectors)
+    argsToErase.set(vector.first);
+  func.eraseArguments(argsToErase);
+}
+
+bool cudaq::opt::unpackArguments(
+    func::FuncOp func, const void *args, std::vector<void *> &rawArgs,
+    std::deque<std::array<const char *, 3>> &vectorStorage) {
+  FunctionType funcTy = func.getFunctionType();
+  if (!args || funcTy.getNumResults() != 0)
+    return false;
+
+  StringRef dataLayoutSpec = "";
+  if (auto mod = func->getParentOfType<ModuleOp>())
+    if (auto attr =
+            mod->getAttr(cudaq::opt::factory::targetDataLayoutAttrName))
+      dataLayoutSpec = cast<StringAttr>(attr);
+  llvm::DataLayout dataLayout{dataLayoutSpec};
+
+  auto structTy = cudaq::opt::factory::buildInvokeStructType(funcTy);
+  const char *buffer = static_cast<const char *>(args);
+  const char *appendix = buffer + getDataSize(dataLayout, structTy);
+  rawArgs.clear();
+  for (auto iter : llvm::enumerate(funcTy.getInputs())) {
+    Type ty = iter.value();
+    const char *field =
+        buffer + getDataOffset(dataLayout, structTy, iter.index());
+    if (isa<IntegerType, FloatType>(ty)) {
+      rawArgs.push_back(const_cast<char *>(field));
+      continue;
+    }
+    if (auto vecTy = dyn_cast<cc::StdvecType>(ty)) {
+      if (!isa<IntegerType, FloatType, ComplexType>(vecTy.getElementType()))
+        return false;
+      // The buffer holds the size of the vector data in bytes, and the data
+      // itself is in the appendix.
+      auto numBytes = *reinterpret_cast<const std::uint64_t *>(field);
+      auto &triple = vectorStorage.emplace_back();
+      triple = {appendix, appendix + numBytes, appendix + numBytes};
+      rawArgs.push_back(static_cast<void *>(triple.data()));
+      appendix += numBytes;
+      continue;
+    }
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,57 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include <array>
+#include <deque>
+#include <unordered_set>
+
+/// Support for "compile once, bind many" lowering of kernels. Floating-point
+/// arguments (rotation angles and the like) are left symbolic while the kernel
+/// goes through the target's lowering pipeline, and are only substituted with
+/// concrete values right before code generation. All other arguments still
+/// take part in the (structural) synthesis, since they may determine loop
+/// bounds, register sizes, etc.
+
+namespace cudaq::opt {
+
+/// Return the positions of the arguments of \p funcTy that can be bound late:
+/// scalar `f32`/`f64` values and `std::vector` of `f32`/`f64`.
+std::unordered_set<unsigned> getLateBoundArguments(mlir::FunctionType funcTy);
+
+/// Replace each `!cc.stdvec<fN>` argument of \p func, given by position and
+/// (runtime) length in \p vectors, with a stack buffer that is filled from one
+/// new scalar argument per element. The new arguments are appended to the
+/// signature in order, and the vector arguments are erased. Loads from the
+/// buffer fold away once the new arguments are substituted with constants and
+/// `lift-array-value` and `canonicalize` have run.
+void scalarizeVectorArguments(
+    mlir::func::FuncOp func,
+    mlir::ArrayRef<std::pair<unsigned, std::size_t>> vectors);
+
+/// Decode the packed argument buffer \p args of \p func (the layout used by the
+/// kernel thunks and by `quake-synth`) into one pointer per argument, as
+/// expected by `ArgumentConverter`. `std::vector` arguments are decoded as
+/// `{begin, end, end}` triples stored in \p vectorStorage, which must outlive
+/// the returned pointers. Returns false if \p func has an argument type that is
+/// not supported, in which case \p rawArgs is left in an unspecified state.
+bool unpackArguments(mlir::func::FuncOp func, const void *args,
+                     std::vector<void *> &rawArgs,
+                     std::deque<std::array<const char *, 3>> &vectorStorage);
+
+/// Record that the structure of a kernel has been lowered, i.e., that the
+/// late binding cache missed.
+void recordStructuralCompile();
+
+/// Return the number of structural lowerings in this process so far. This is
+/// meant for diagnostics and for testing that lowered code is reused.
+std::size_t getStructuralCompileCount();
+
+} // namespace cudaq::opt
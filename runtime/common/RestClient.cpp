@@ -49,7 +49,9 @@ std::string decompress_gzip(const std::string &data) {
   return decompressed;
 }
 
-RestClient::RestClient() : sslOptions(std::make_unique<cpr::SslOptions>()) {
+RestClient::RestClient()
+    : sslOptions(std::make_unique<cpr::SslOptions>()),
+      getSession(std::make_unique<cpr::Session>()) {
   auto caInfo = [&]() -> std::string {
     if (auto *curlCABundleStr = getenv("CURL_CA_BUNDLE")) {
       if (std::filesystem::exists(curlCABundleStr))
@@ -147,10 +149,12 @@ nlohmann::json RestClient::get(const std::string_view remoteUrl,
   for (auto &kv : headers)
     cprHeaders.insert({kv.first, kv.second});
 
-  cpr::Parameters cprParams;
   auto actualPath = std::string(remoteUrl) + std::string(path);
-  auto r = cpr::Get(cpr::Url{actualPath}, cprHeaders, cprParams,
-                    cpr::VerifySsl(enableSsl), *sslOptions);
+  getSession->SetUrl(cpr::Url{actualPath});
+  getSession->SetHeader(cprHeaders);
+  getSession->SetVerifySsl(cpr::VerifySsl(enableSsl));
+  getSession->SetSslOptions(*sslOptions);
+  auto r = getSession->Get();
 
   if (r.status_code > validHttpCode || r.status_code == 0)
     throw std::runtime_error("HTTP GET Error - status code " +
@@ -13,8 +13,9 @@
 
 // Forward declarations to avoid including CPR header files
 namespace cpr {
+class Session;
 struct SslOptions;
-}
+} // namespace cpr
 
 namespace cudaq {
 
@@ -28,6 +29,10 @@ protected:
   /// SSL options to use for transfers
   std::unique_ptr<cpr::SslOptions> sslOptions;
 
+  /// Session reused across GET requests, so that repeated requests to the
+  /// same server (e.g., polling for job results) keep the connection alive.
+  std::unique_ptr<cpr::Session> getSession;
+
 public:
   /// @brief set verbose printout
   /// @param v
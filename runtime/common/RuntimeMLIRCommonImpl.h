@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include "Environment.h"
+#include "JIT.h"
 #include "Logger.h"
 #include "Timing.h"
 #include "cudaq/Frontend/nvqpp/AttributeNames.h"
@@ -506,7 +508,10 @@ void registerToOpenQASMTranslation() {
           pm.enableIRPrinting();
         if (printStats)
           pm.enableStatistics();
-        cudaq::opt::addPipelineTranslateToOpenQASM(pm);
+        cudaq::opt::StatePreparationOptions statePrepOptions;
+        statePrepOptions.rotationThreshold = cudaq::getEnvDouble(
+            "CUDAQ_STATE_PREP_ROTATION_THRESHOLD", 0.0);
+        cudaq::opt::addPipelineTranslateToOpenQASM(pm, statePrepOptions);
         mlir::DefaultTimingManager tm;
         tm.setEnabled(cudaq::isTimingTagEnabled(cudaq::TIMING_JIT_PASSES));
         auto timingScope = tm.getRootScope(); // starts the timer
@@ -651,6 +656,8 @@ mlir::ExecutionEngine *createQIRJITEngine(mlir::ModuleOp &moduleOp,
   mlir::ExecutionEngineOptions opts;
   opts.transformer = [](llvm::Module *m) { return llvm::ErrorSuccess(); };
   opts.jitCodeGenOptLevel = llvm::CodeGenOpt::None;
+  // Reuse the machine code of previous processes, if enabled.
+  opts.cache = cudaq::JITObjectCache::get();
   opts.llvmModuleBuilder =
       [convertTo = convertTo.str()](
           mlir::Operation *module,
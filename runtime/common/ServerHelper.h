@@ -106,6 +106,12 @@ public:
   /// @brief Extract the job id from the server response from posting the job.
   virtual std::string extractJobId(ServerMessage &postResponse) = 0;
 
+  /// @brief Return the default maximum number of job messages from
+  /// `createJob` that are posted to the server concurrently. Providers that
+  /// require their jobs to be submitted in order should return 1. Users can
+  /// override this with the `max_concurrent_submissions` target option.
+  virtual std::size_t getMaxConcurrentSubmissions() { return 8; }
+
   /// @brief Get the specific path required to retrieve job results.
   /// Construct specifically from the job id.
   virtual std::string constructGetJobPath(std::string &jobId) = 0;
@@ -11,4 +11,5 @@
 #include "algorithms/get_state.h"
 #include "algorithms/observe.h"
 #include "algorithms/optimizer.h"
+#include "algorithms/pipelined_vqe.h"
 #include "algorithms/vqe.h"
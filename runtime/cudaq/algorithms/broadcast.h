@@ -10,6 +10,8 @@
 
 #include "cudaq/host_config.h"
 #include "cudaq/platform.h"
+#include <exception>
+#include <optional>
 
 namespace cudaq {
 
@@ -35,6 +37,66 @@ template <typename ReturnType, typename... Args>
 using BroadcastFunctorType = const std::function<ReturnType(
     std::size_t, std::size_t, std::size_t, Args &...)>;
 
+/// @brief Signature of the functor applied by `distributeOverQpus`: it gets the
+/// QPU id, the index of the work item, the position of the item among the
+/// items run on that QPU, and the number of items run on that QPU.
+using DistributedFunctorType = const std::function<void(
+    std::size_t, std::size_t, std::size_t, std::size_t)>;
+
+/// @brief Apply \p apply to every index in `[0, N)`, distributing contiguous
+/// ranges of indices over the provided number of QPUs, and wait for all of
+/// them to complete. Exceptions thrown by \p apply are rethrown here.
+inline void distributeOverQpus(std::size_t N, std::size_t numQpus,
+                               quantum_platform &platform,
+                               DistributedFunctorType &apply) {
+  const auto nExecsPerQpu = N / numQpus + (N % numQpus != 0);
+
+  // Fetch the thread-specific seed outside the functor and then pass it inside.
+  std::size_t seed = cudaq::get_random_seed();
+
+  std::vector<std::future<void>> futures;
+  for (std::size_t qpuId = 0; qpuId < numQpus; qpuId++) {
+    const auto lowerBound = std::min(N, qpuId * nExecsPerQpu);
+    const auto upperBound = std::min(N, lowerBound + nExecsPerQpu);
+    if (lowerBound == upperBound)
+      break;
+
+    std::promise<void> _promise;
+    futures.emplace_back(_promise.get_future());
+    std::function<void()> functor = detail::make_copyable_function(
+        [&apply, qpuId, lowerBound, upperBound, seed,
+         promise = std::move(_promise)]() mutable {
+          try {
+            for (std::size_t i = lowerBound; i < upperBound; i++) {
+              // If seed is 0, then it has not been set.
+              if (seed > 0)
+                cudaq::set_random_seed(seed);
+              apply(qpuId, i, i - lowerBound, upperBound - lowerBound);
+            }
+            promise.set_value();
+          } catch (...) {
+            promise.set_exception(std::current_exception());
+          }
+        });
+
+    platform.enqueueAsyncTask(qpuId, functor);
+  }
+
+  // Wait for all the tasks, which reference `apply`, before rethrowing the
+  // first exception.
+  std::exception_ptr error;
+  for (auto &f : futures) {
+    try {
+      f.get();
+    } catch (...) {
+      if (!error)
+        error = std::current_exception();
+    }
+  }
+  if (error)
+    std::rethrow_exception(error);
+}
+
 /// @brief Given the input BroadcastFunctorType, apply it to all argument sets
 /// in the provided ArgumentSet `params`. Distribute the work over the provided
 /// number of QPUs.
@@ -43,11 +105,8 @@ std::vector<ResType>
 broadcastFunctionOverArguments(std::size_t numQpus, quantum_platform &platform,
                                BroadcastFunctorType<ResType, Args...> &apply,
                                ArgumentSet<Args...> &params) {
-  using FutureCollection = std::vector<std::future<std::vector<ResType>>>;
-
   // Assert all arg vectors are the same size
   auto N = std::get<0>(params).size();
-  auto nExecsPerQpu = N / numQpus + (N % numQpus != 0);
 
   // Validate the input deck
   cudaq::tuple_for_each(params, [&](auto &&element) {
@@ -56,83 +115,50 @@ broadcastFunctionOverArguments(std::size_t numQpus, quantum_platform &platform,
                                "over - vector sizes not the same.");
   });
 
-  // Fetch the thread-specific seed outside the functor and then pass it inside.
-  std::size_t seed = cudaq::get_random_seed();
-
-  FutureCollection futures;
-  for (std::size_t qpuId = 0; qpuId < numQpus; qpuId++) {
-    std::promise<std::vector<ResType>> _promise;
-    futures.emplace_back(_promise.get_future());
-    std::function<void()> functor = detail::make_copyable_function(
-        [&params, &apply, qpuId, nExecsPerQpu, seed,
-         promise = std::move(_promise)]() mutable {
-          // Compute the lower and upper bounds of the
-          // argument set that should be computed on the current QPU
-          auto lowerBound = qpuId * nExecsPerQpu;
-          auto upperBound = lowerBound + nExecsPerQpu;
-
-          // Store the results
-          std::vector<ResType> results;
-
-          // Loop over all sets of arguments, the ith element of each vector
-          // in the ArgumentSet tuple
-          for (std::size_t i = lowerBound, counter = 0; i < upperBound; i++) {
-            // Construct the current set of arguments as a new tuple
-            // We want a tuple so we can use std::apply with the
-            // existing sample()/observe() functions.
-            std::tuple<std::size_t, std::size_t, std::size_t, Args...>
-                currentArgs;
-
-            // Fill the argument tuple with the QPU id, current argument
-            // iteration, and the total number of arguments that will be applied
-            // on this QPU.
-            std::get<0>(currentArgs) = qpuId;
-            std::get<1>(currentArgs) = counter;
-            std::get<2>(currentArgs) = nExecsPerQpu;
-            counter++;
-
-            // If seed is 0, then it has not been set.
-            if (seed > 0)
-              cudaq::set_random_seed(seed);
-
-            // Fill the argument tuple with the actual arguments.
-            cudaq::tuple_for_each_with_idx(
-                params,
+  // Each argument set stores its own result, so that the results are in the
+  // order of the arguments.
+  std::vector<std::optional<ResType>> results(N);
+  distributeOverQpus(
+      N, numQpus, platform,
+      [&](std::size_t qpuId, std::size_t i, std::size_t counter,
+          std::size_t nExecs) {
+        // Construct the current set of arguments as a new tuple
+        // We want a tuple so we can use std::apply with the
+        // existing sample()/observe() functions.
+        std::tuple<std::size_t, std::size_t, std::size_t, Args...> currentArgs;
+
+        // Fill the argument tuple with the QPU id, current argument
+        // iteration, and the total number of arguments that will be applied
+        // on this QPU.
+        std::get<0>(currentArgs) = qpuId;
+        std::get<1>(currentArgs) = counter;
+        std::get<2>(currentArgs) = nExecs;
+
+        // Fill the argument tuple with the actual arguments.
+        cudaq::tuple_for_each_with_idx(
+            params,
 #if CUDAQ_USE_STD20
-                [&]<typename IDX_TYPE>(auto &&element, IDX_TYPE &&idx) {
-                  std::get<IDX_TYPE::value + 3>(currentArgs) = element[i];
-                }
+            [&]<typename IDX_TYPE>(auto &&element, IDX_TYPE &&idx) {
+              std::get<IDX_TYPE::value + 3>(currentArgs) = element[i];
+            }
 #else
-                [&](auto &&element, auto &&idx) {
-                  std::get<std::remove_cv_t<
-                               std::remove_reference_t<decltype(idx)>>::value +
-                           3>(currentArgs) = element[i];
-                }
+            [&](auto &&element, auto &&idx) {
+              std::get<std::remove_cv_t<
+                           std::remove_reference_t<decltype(idx)>>::value +
+                       3>(currentArgs) = element[i];
+            }
 #endif
-            );
+        );
 
-            // Call observe/sample with the current set of arguments
-            // (provided as a tuple)
-            auto result = std::apply(apply, currentArgs);
+        // Call observe/sample with the current set of arguments
+        // (provided as a tuple)
+        results[i].emplace(std::apply(apply, currentArgs));
+      });
 
-            // Store the result.
-            results.push_back(result);
-          }
-
-          // Set the promised results.
-          promise.set_value(results);
-        });
-
-    platform.enqueueAsyncTask(qpuId, functor);
-  }
-
-  // Get all the async-generated results and return.
   std::vector<ResType> allResults;
-  for (auto &f : futures) {
-    auto res = f.get();
-    allResults.insert(allResults.end(), res.begin(), res.end());
-  }
-
+  allResults.reserve(N);
+  for (auto &result : results)
+    allResults.push_back(std::move(*result));
   return allResults;
 }
 } // namespace details
@@ -47,13 +47,38 @@ protected:
     return cudaq::observe(ansatz_functor, h, x);
   }
 
+  // Given a set of parameters xs and the spin_op h, compute the expected
+  // values with respect to the ansatz. In batched mode, they are computed
+  // with a single broadcast over the available QPUs instead of one after the
+  // other.
+  std::vector<double>
+  getExpectedValues(const std::vector<std::vector<double>> &xs, spin_op h) {
+    std::vector<double> values;
+    values.reserve(xs.size());
+    if (!batched) {
+      for (auto x : xs)
+        values.push_back(getExpectedValue(x, h));
+      return values;
+    }
+    auto results = cudaq::observe(ansatz_functor, h, cudaq::make_argset(xs));
+    for (auto &result : results)
+      values.push_back(result.expectation());
+    return values;
+  }
+
   // Copy constructor. Derived classes should implement the clone() method.
   gradient(const gradient &o) {
     ansatz_functor = o.ansatz_functor;
     serializedArgs = o.serializedArgs;
+    batched = o.batched;
   }
 
 public:
+  /// If true, all the shifted parameter sets needed for a gradient are
+  /// evaluated together, distributed over the available QPUs, rather than one
+  /// at a time.
+  bool batched = false;
+
   /// Constructor, takes the quantum kernel with prescribed signature
   gradient(std::function<void(std::vector<double>)> &&kernel)
       : ansatz_functor(kernel) {}
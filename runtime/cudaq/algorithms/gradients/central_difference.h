@@ -25,18 +25,24 @@ public:
 
   void compute(const std::vector<double> &x, std::vector<double> &dx,
                const spin_op &h, double exp_h) override {
-    auto tmpX = x;
+    auto values = getExpectedValues(getShiftedParameters(x), h);
+    for (std::size_t i = 0; i < x.size(); i++)
+      dx[i] = (values[2 * i] - values[2 * i + 1]) / (2. * step);
+  }
+
+  /// @brief Return the parameter sets x_i + dx_i and x_i - dx_i, in that
+  /// order, for each i.
+  std::vector<std::vector<double>>
+  getShiftedParameters(const std::vector<double> &x) const {
+    std::vector<std::vector<double>> shifted;
+    shifted.reserve(2 * x.size());
     for (std::size_t i = 0; i < x.size(); i++) {
-      // increase value to x_i + dx_i
-      tmpX[i] += step;
-      auto px = getExpectedValue(tmpX, h);
-      // decrease the value to x_i - dx_i
-      tmpX[i] -= 2 * step;
-      auto mx = getExpectedValue(tmpX, h);
-      // return value back to x_i
-      tmpX[i] += step;
-      dx[i] = (px - mx) / (2. * step);
+      shifted.push_back(x);
+      shifted.back()[i] += step;
+      shifted.push_back(x);
+      shifted.back()[i] -= step;
     }
+    return shifted;
   }
 
   /// @brief Compute the `central_difference` gradient for the arbitrary
@@ -24,18 +24,24 @@ public:
 
   void compute(const std::vector<double> &x, std::vector<double> &dx,
                const spin_op &h, double exp_h) override {
-    auto tmpX = x;
+    auto values = getExpectedValues(getShiftedParameters(x), h);
+    for (std::size_t i = 0; i < x.size(); i++)
+      dx[i] = (values[2 * i] - values[2 * i + 1]) / 2.;
+  }
+
+  /// @brief Return the parameter sets x_i + (shiftScalar * pi) and
+  /// x_i - (shiftScalar * pi), in that order, for each i.
+  std::vector<std::vector<double>>
+  getShiftedParameters(const std::vector<double> &x) const {
+    std::vector<std::vector<double>> shifted;
+    shifted.reserve(2 * x.size());
     for (std::size_t i = 0; i < x.size(); i++) {
-      // increase value to x_i + (shiftScalar * pi)
-      tmpX[i] += shiftScalar * M_PI;
-      auto px = getExpectedValue(tmpX, h);
-      // decrease value to x_i - (shiftScalar * pi)
-      tmpX[i] -= 2 * shiftScalar * M_PI;
-      auto mx = getExpectedValue(tmpX, h);
-      // return value back to x_i
-      tmpX[i] += shiftScalar * M_PI;
-      dx[i] = (px - mx) / 2.;
+      shifted.push_back(x);
+      shifted.back()[i] += shiftScalar * M_PI;
+      shifted.push_back(x);
+      shifted.back()[i] -= shiftScalar * M_PI;
     }
+    return shifted;
   }
 
   /// @brief Compute the `parameter_shift` gradient for the arbitrary
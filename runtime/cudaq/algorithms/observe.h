@@ -787,4 +787,40 @@ observe_n(std::size_t shots, QuantumKernel &&kernel, spin_op H,
   return details::broadcastFunctionOverArguments<observe_result, Args...>(
       numQpus, platform, functor, params);
 }
+
+/// @brief Compute the expectation value of \p H for a kernel with signature
+/// `void(std::vector<double>)` at every row of the row-major \p params matrix
+/// with \p numParams columns, e.g., for a landscape scan. The rows are
+/// distributed over the available QPUs, and the expectation value for each row
+/// is returned. Unlike the `ArgumentSet` overloads, no `observe_result` is
+/// kept per row.
+template <typename QuantumKernel>
+std::vector<double> observe_sweep(QuantumKernel &&kernel, spin_op H,
+                                  const std::vector<double> &params,
+                                  std::size_t numParams) {
+  if (numParams == 0 || params.size() % numParams != 0)
+    throw std::runtime_error("Invalid parameter matrix for observe_sweep - "
+                             "size is not a multiple of the number of "
+                             "parameters.");
+
+  auto &platform = cudaq::get_platform();
+  const auto numRows = params.size() / numParams;
+  const auto shots = platform.get_shots().value_or(-1);
+  const auto kernelName = cudaq::getKernelName(kernel);
+  std::vector<double> results(numRows);
+  details::distributeOverQpus(
+      numRows, platform.num_qpus(), platform,
+      [&](std::size_t qpuId, std::size_t i, std::size_t counter,
+          std::size_t N) {
+        std::vector<double> row(params.begin() + i * numParams,
+                                params.begin() + (i + 1) * numParams);
+        results[i] = details::runObservation(
+                         [&kernel, &row]() mutable { kernel(row); }, H,
+                         platform, shots, kernelName, qpuId, nullptr, counter,
+                         N)
+                         .value()
+                         .expectation();
+      });
+  return results;
+}
 } // namespace cudaq
@@ -9,6 +9,8 @@
 #pragma once
 
 #include <functional>
+#include <stdexcept>
+#include <vector>
 
 namespace cudaq {
 
@@ -60,6 +62,13 @@ public:
   }
 };
 
+/// A batch_objective_function evaluates the objective function at each of the
+/// given points and returns the values in the same order. The points are
+/// independent of each other, so implementations may evaluate them
+/// concurrently (e.g., on different QPUs).
+using batch_objective_function = std::function<std::vector<double>(
+    const std::vector<std::vector<double>> &)>;
+
 ///
 /// The cudaq::optimizer provides a high-level interface for general
 /// optimization of user-specified objective functions. This is meant
@@ -106,5 +115,21 @@ public:
   /// current input parameters.
   virtual optimization_result optimize(const int dim,
                                        optimizable_function &&opt_function) = 0;
+
+  /// Returns true if this optimization strategy evaluates the objective
+  /// function at many independent points per iteration (perturbations,
+  /// populations, multiple starts) and implements `optimize_batch`.
+  virtual bool supportsBatchEvaluation() { return false; }
+
+  /// Run the optimization strategy with an objective function that evaluates
+  /// all the points of an iteration at once, so that they can be computed
+  /// concurrently. Only implemented by gradient-free strategies that
+  /// `supportsBatchEvaluation()`.
+  virtual optimization_result
+  optimize_batch(const int /*dim*/,
+                 const batch_objective_function & /*batch_function*/) {
+    throw std::runtime_error(
+        "This optimizer does not support batched objective evaluation.");
+  }
 };
 } // namespace cudaq
@@ -0,0 +1,506 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "population.h"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+
+namespace cudaq::optimizers {
+
+namespace {
+/// Common state of a population-based optimization: bounds, evaluation budget,
+/// random number generator and best point found so far.
+class Problem {
+  const batch_objective_function &function;
+
+public:
+  const std::size_t dim;
+  std::vector<double> lower;
+  std::vector<double> upper;
+  std::vector<double> x0;
+  std::size_t maxEval;
+  double fTol;
+  std::mt19937 gen;
+  std::size_t numEvals = 0;
+  double bestValue = std::numeric_limits<double>::infinity();
+  std::vector<double> bestX;
+
+  Problem(const base_population &opt, int dim,
+          const batch_objective_function &function)
+      : function(function), dim(dim),
+        lower(opt.lower_bounds.value_or(std::vector<double>(dim, -M_PI))),
+        upper(opt.upper_bounds.value_or(std::vector<double>(dim, M_PI))),
+        x0(opt.initial_parameters.value_or(std::vector<double>(dim))),
+        maxEval(opt.max_eval.value_or(1000 * dim)),
+        fTol(opt.f_tol.value_or(1e-6)),
+        gen(opt.seed.value_or(std::random_device{}())) {
+    if (dim <= 0)
+      throw std::invalid_argument("Invalid number of parameters (" +
+                                  std::to_string(dim) + ").");
+    if (lower.size() != this->dim || upper.size() != this->dim ||
+        x0.size() != this->dim)
+      throw std::invalid_argument(
+          "\nThe dimensions of the bounds and initial_parameters do not match "
+          "the number of parameters.\nYou have provided " +
+          std::to_string(x0.size()) + " initial_parameters, " +
+          std::to_string(lower.size()) + " lower_bounds and " +
+          std::to_string(upper.size()) + " upper_bounds for " +
+          std::to_string(dim) + " parameters.\n");
+    for (std::size_t i = 0; i < this->dim; ++i)
+      if (lower[i] > upper[i])
+        throw std::invalid_argument(
+            "Lower bounds are bigger than upper bounds.");
+    x0 = clamp(std::move(x0));
+  }
+
+  /// Evaluate the objective at all \p points at once.
+  std::vector<double> evaluate(const std::vector<std::vector<double>> &points) {
+    auto values = function(points);
+    if (values.size() != points.size())
+      throw std::runtime_error("Batch objective function returned " +
+                               std::to_string(values.size()) + " values for " +
+                               std::to_string(points.size()) + " points.");
+    numEvals += points.size();
+    for (std::size_t i = 0; i < points.size(); ++i)
+      if (values[i] < bestValue) {
+        bestValue = values[i];
+        bestX = points[i];
+      }
+    return values;
+  }
+
+  /// Return true if \p count more evaluations fit in the budget.
+  bool canEvaluate(std::size_t count) const {
+    return numEvals + count <= maxEval;
+  }
+
+  std::vector<double> clamp(std::vector<double> x) const {
+    for (std::size_t i = 0; i < dim; ++i)
+      x[i] = std::clamp(x[i], lower[i], upper[i]);
+    return x;
+  }
+
+  std::vector<double> sampleUniform() {
+    std::vector<double> x(dim);
+    for (std::size_t i = 0; i < dim; ++i)
+      x[i] = std::uniform_real_distribution<double>(lower[i], upper[i])(gen);
+    return x;
+  }
+
+  optimization_result result() {
+    if (bestX.empty())
+      evaluate({x0});
+    return std::make_tuple(bestValue, bestX);
+  }
+};
+
+double dot(const std::vector<double> &a, const std::vector<double> &b) {
+  return std::inner_product(a.begin(), a.end(), b.begin(), 0.0);
+}
+} // namespace
+
+optimization_result
+base_population::optimize(const int dim, optimizable_function &&opt_function) {
+  return optimize_batch(
+      dim, [&](const std::vector<std::vector<double>> &points) {
+        std::vector<double> values;
+        values.reserve(points.size());
+        std::vector<double> unusedGrad;
+        for (const auto &x : points)
+          values.push_back(opt_function(x, unusedGrad));
+        return values;
+      });
+}
+
+optimization_result
+batched_spsa::optimize_batch(const int dim,
+                             const batch_objective_function &batch_function) {
+  Problem problem(*this, dim, batch_function);
+  const std::size_t numPerturbations = num_perturbations.value_or(4);
+  const double a = step_size.value_or(0.2);
+  const double c = eval_step_size.value_or(0.1);
+  const double alphaExp = alpha.value_or(0.602);
+  const double gammaExp = gamma.value_or(0.101);
+  // Stability constant of the step size sequence, ~10% of the iterations.
+  const double stability = 0.1 * problem.maxEval / (2 * numPerturbations);
+
+  std::vector<double> x = problem.x0;
+  std::bernoulli_distribution coin;
+  for (std::size_t k = 0; problem.canEvaluate(2 * numPerturbations + 1); ++k) {
+    const double ak = a / std::pow(k + 1 + stability, alphaExp);
+    const double ck = c / std::pow(k + 1, gammaExp);
+    std::vector<std::vector<double>> deltas(numPerturbations,
+                                            std::vector<double>(dim));
+    std::vector<std::vector<double>> points;
+    points.reserve(2 * numPerturbations);
+    for (auto &delta : deltas) {
+      std::vector<double> plus(x), minus(x);
+      for (int i = 0; i < dim; ++i) {
+        delta[i] = coin(problem.gen) ? 1.0 : -1.0;
+        plus[i] += ck * delta[i];
+        minus[i] -= ck * delta[i];
+      }
+      points.push_back(problem.clamp(std::move(plus)));
+      points.push_back(problem.clamp(std::move(minus)));
+    }
+    auto values = problem.evaluate(points);
+
+    std::vector<double> grad(dim);
+    for (std::size_t j = 0; j < numPerturbations; ++j) {
+      const double diff = (values[2 * j] - values[2 * j + 1]) / (2 * ck);
+      for (int i = 0; i < dim; ++i)
+        grad[i] += diff * deltas[j][i] / numPerturbations;
+    }
+    for (int i = 0; i < dim; ++i)
+      x[i] -= ak * grad[i];
+    x = problem.clamp(std::move(x));
+  }
+  if (problem.canEvaluate(1))
+    problem.evaluate({x});
+  return problem.result();
+}
+
+optimization_result
+cmaes::optimize_batch(const int dim,
+                      const batch_objective_function &batch_function) {
+  using Eigen::MatrixXd;
+  using Eigen::VectorXd;
+  Problem problem(*this, dim, batch_function);
+  const double n = dim;
+  const std::size_t lambda =
+      population_size.value_or(4 + static_cast<std::size_t>(3 * std::log(n)));
+  if (lambda < 2)
+    throw std::invalid_argument("CMA-ES requires a population of at least 2.");
+  const std::size_t mu = lambda / 2;
+
+  // Recombination weights and strategy parameters, see N. Hansen, "The CMA
+  // Evolution Strategy: A Tutorial".
+  VectorXd weights(mu);
+  for (std::size_t i = 0; i < mu; ++i)
+    weights[i] = std::log(mu + 0.5) - std::log(i + 1.0);
+  weights /= weights.sum();
+  const double mueff = 1.0 / weights.squaredNorm();
+  const double cc = (4 + mueff / n) / (n + 4 + 2 * mueff / n);
+  const double cs = (mueff + 2) / (n + mueff + 5);
+  const double c1 = 2 / ((n + 1.3) * (n + 1.3) + mueff);
+  const double cmu = std::min(
+      1 - c1, 2 * (mueff - 2 + 1 / mueff) / ((n + 2) * (n + 2) + mueff));
+  const double damps =
+      1 + 2 * std::max(0.0, std::sqrt((mueff - 1) / (n + 1)) - 1) + cs;
+  const double chiN = std::sqrt(n) * (1 - 1 / (4 * n) + 1 / (21 * n * n));
+
+  VectorXd mean = Eigen::Map<const VectorXd>(problem.x0.data(), dim);
+  double step = sigma.value_or([&]() {
+    double width = 0.0;
+    for (int i = 0; i < dim; ++i)
+      width += problem.upper[i] - problem.lower[i];
+    return width / (3 * n);
+  }());
+  MatrixXd C = MatrixXd::Identity(dim, dim);
+  MatrixXd B = MatrixXd::Identity(dim, dim);
+  VectorXd D = VectorXd::Ones(dim);
+  VectorXd pc = VectorXd::Zero(dim);
+  VectorXd ps = VectorXd::Zero(dim);
+  std::normal_distribution<double> normal;
+
+  for (std::size_t generation = 0; problem.canEvaluate(lambda); ++generation) {
+    std::vector<std::vector<double>> points(lambda);
+    std::vector<VectorXd> ys(lambda);
+    for (std::size_t k = 0; k < lambda; ++k) {
+      VectorXd z(dim);
+      for (int i = 0; i < dim; ++i)
+        z[i] = normal(problem.gen);
+      VectorXd x = mean + step * (B * D.asDiagonal() * z);
+      points[k] = problem.clamp(std::vector<double>(x.data(), x.data() + dim));
+      // Account for the clamping in the update.
+      ys[k] = (Eigen::Map<const VectorXd>(points[k].data(), dim) - mean) / step;
+    }
+    auto values = problem.evaluate(points);
+    std::vector<std::size_t> order(lambda);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](std::size_t i, std::size_t j) {
+      return values[i] < values[j];
+    });
+
+    VectorXd yw = VectorXd::Zero(dim);
+    for (std::size_t i = 0; i < mu; ++i)
+      yw += weights[i] * ys[order[i]];
+    mean += step * yw;
+
+    const MatrixXd invSqrtC = B * D.cwiseInverse().asDiagonal() * B.transpose();
+    ps = (1 - cs) * ps + std::sqrt(cs * (2 - cs) * mueff) * (invSqrtC * yw);
+    const bool hsig =
+        ps.norm() / std::sqrt(1 - std::pow(1 - cs, 2.0 * (generation + 1))) /
+            chiN <
+        1.4 + 2 / (n + 1);
+    pc = (1 - cc) * pc + (hsig ? std::sqrt(cc * (2 - cc) * mueff) : 0.0) * yw;
+    MatrixXd rankMu = MatrixXd::Zero(dim, dim);
+    for (std::size_t i = 0; i < mu; ++i)
+      rankMu += weights[i] * ys[order[i]] * ys[order[i]].transpose();
+    C = (1 - c1 - cmu) * C +
+        c1 * (pc * pc.transpose() + (hsig ? 0.0 : cc * (2 - cc)) * C) +
+        cmu * rankMu;
+    step *= std::exp((cs / damps) * (ps.norm() / chiN - 1));
+
+    Eigen::SelfAdjointEigenSolver<MatrixXd> eigen((C + C.transpose()) / 2);
+    B = eigen.eigenvectors();
+    D = eigen.eigenvalues().cwiseMax(1e-20).cwiseSqrt();
+
+    const double spread = values[order.back()] - values[order.front()];
+    if (spread < problem.fTol || step * D.maxCoeff() < 1e-12)
+      break;
+  }
+  return problem.result();
+}
+
+optimization_result differential_evolution::optimize_batch(
+    const int dim, const batch_objective_function &batch_function) {
+  Problem problem(*this, dim, batch_function);
+  const std::size_t populationSize =
+      population_size.value_or(std::max<std::size_t>(10 * dim, 5));
+  if (populationSize < 4)
+    throw std::invalid_argument(
+        "Differential evolution requires a population of at least 4.");
+  const double F = differential_weight.value_or(0.8);
+  const double CR = crossover_probability.value_or(0.9);
+
+  // Start from the initial parameters and random points within the bounds.
+  std::vector<std::vector<double>> population{problem.x0};
+  while (population.size() < populationSize)
+    population.push_back(problem.sampleUniform());
+  auto fitness = problem.evaluate(population);
+
+  std::uniform_int_distribution<std::size_t> pick(0, populationSize - 1);
+  std::uniform_int_distribution<int> pickDim(0, dim - 1);
+  std::uniform_real_distribution<double> uniform;
+  while (problem.canEvaluate(populationSize)) {
+    std::vector<std::vector<double>> trials(populationSize);
+    for (std::size_t i = 0; i < populationSize; ++i) {
+      std::size_t r1, r2, r3;
+      do {
+        r1 = pick(problem.gen);
+      } while (r1 == i);
+      do {
+        r2 = pick(problem.gen);
+      } while (r2 == i || r2 == r1);
+      do {
+        r3 = pick(problem.gen);
+      } while (r3 == i || r3 == r1 || r3 == r2);
+      const int forced = pickDim(problem.gen);
+      trials[i] = population[i];
+      for (int j = 0; j < dim; ++j)
+        if (j == forced || uniform(problem.gen) < CR)
+          trials[i][j] = population[r1][j] +
+                         F * (population[r2][j] - population[r3][j]);
+      trials[i] = problem.clamp(std::move(trials[i]));
+    }
+    auto trialFitness = problem.evaluate(trials);
+    for (std::size_t i = 0; i < populationSize; ++i)
+      if (trialFitness[i] <= fitness[i]) {
+        population[i] = std::move(trials[i]);
+        fitness[i] = trialFitness[i];
+      }
+
+    auto [minIt, maxIt] = std::minmax_element(fitness.begin(), fitness.end());
+    if (*maxIt - *minIt < problem.fTol)
+      break;
+  }
+  return problem.result();
+}
+
+optimization_result multistart_lbfgs::optimize_batch(
+    const int dim, const batch_objective_function &batch_function) {
+  Problem problem(*this, dim, batch_function);
+  const std::size_t numStarts = num_starts.value_or(4);
+  const std::size_t historySize = history_size.value_or(5);
+  const double h = eval_step_size.value_or(1e-4);
+  // Step lengths tried at once in the line search, relative to the first one.
+  constexpr std::size_t numLineSearchSteps = 4;
+
+  struct Start {
+    std::vector<double> x;
+    double f = 0.0;
+    std::vector<double> grad;
+    std::deque<std::pair<std::vector<double>, std::vector<double>>> history;
+    bool active = true;
+  };
+  std::vector<Start> starts(numStarts);
+  for (std::size_t s = 0; s < numStarts; ++s)
+    starts[s].x = s == 0 ? problem.x0 : problem.sampleUniform();
+
+  // Compute the value (if requested) and central difference gradient of all
+  // the given starts in a single batch.
+  auto evaluateGradients = [&](const std::vector<Start *> &targets,
+                               bool withValue) {
+    std::vector<std::vector<double>> points;
+    for (auto *start : targets) {
+      if (withValue)
+        points.push_back(start->x);
+      for (int i = 0; i < dim; ++i) {
+        std::vector<double> plus(start->x), minus(start->x);
+        plus[i] += h;
+        minus[i] -= h;
+        points.push_back(problem.clamp(std::move(plus)));
+        points.push_back(problem.clamp(std::move(minus)));
+      }
+    }
+    auto values = problem.evaluate(points);
+    std::size_t idx = 0;
+    const std::size_t stride = 2 * dim + (withValue ? 1 : 0);
+    for (std::size_t t = 0; t < targets.size(); ++t, idx += stride) {
+      auto *start = targets[t];
+      const std::size_t offset = withValue ? 1 : 0;
+      if (withValue)
+        start->f = values[idx];
+      start->grad.assign(dim, 0.0);
+      for (int i = 0; i < dim; ++i) {
+        const auto &plus = points[idx + offset + 2 * i];
+        const auto &minus = points[idx + offset + 2 * i + 1];
+        const double width = plus[i] - minus[i];
+        if (width > 0)
+          start->grad[i] = (values[idx + offset + 2 * i] -
+                            values[idx + offset + 2 * i + 1]) /
+                           width;
+      }
+    }
+  };
+
+  std::vector<Start *> active;
+  for (auto &start : starts)
+    active.push_back(&start);
+  if (!problem.canEvaluate(numStarts * (2 * dim + 1)))
+    return problem.result();
+  evaluateGradients(active, /*withValue=*/true);
+
+  while (!active.empty()) {
+    // Search directions from the two-loop recursion.
+    std::vector<std::vector<double>> directions;
+    for (auto *start : active) {
+      std::vector<double> q = start->grad;
+      std::vector<double> alphas(start->history.size());
+      for (std::size_t j = start->history.size(); j-- > 0;) {
+        const auto &[s, y] = start->history[j];
+        alphas[j] = dot(s, q) / dot(y, s);
+        for (int i = 0; i < dim; ++i)
+          q[i] -= alphas[j] * y[i];
+      }
+      if (!start->history.empty()) {
+        const auto &[s, y] = start->history.back();
+        const double scale = dot(s, y) / dot(y, y);
+        for (auto &qi : q)
+          qi *= scale;
+      } else {
+        // Without curvature information, limit the first step to unit length.
+        const double norm = std::sqrt(dot(q, q));
+        if (norm > 0)
+          for (auto &qi : q)
+            qi /= std::max(1.0, norm);
+      }
+      for (std::size_t j = 0; j < start->history.size(); ++j) {
+        const auto &[s, y] = start->history[j];
+        const double beta = dot(y, q) / dot(y, s);
+        for (int i = 0; i < dim; ++i)
+          q[i] += s[i] * (alphas[j] - beta);
+      }
+      for (auto &qi : q)
+        qi = -qi;
+      if (dot(q, start->grad) >= 0) {
+        // Not a descent direction, restart from steepest descent.
+        start->history.clear();
+        q = start->grad;
+        for (auto &qi : q)
+          qi = -qi;
+      }
+      directions.push_back(std::move(q));
+    }
+
+    // Evaluate several step lengths for all the starts at once.
+    if (!problem.canEvaluate(active.size() * numLineSearchSteps))
+      break;
+    std::vector<std::vector<double>> candidates;
+    for (std::size_t a = 0; a < active.size(); ++a)
+      for (std::size_t k = 0; k < numLineSearchSteps; ++k) {
+        std::vector<double> x = active[a]->x;
+        const double stepLength = std::ldexp(1.0, -static_cast<int>(k));
+        for (int i = 0; i < dim; ++i)
+          x[i] += stepLength * directions[a][i];
+        candidates.push_back(problem.clamp(std::move(x)));
+      }
+    auto values = problem.evaluate(candidates);
+
+    std::vector<Start *> moved;
+    std::vector<std::vector<double>> oldX, oldGrad;
+    for (std::size_t a = 0; a < active.size(); ++a) {
+      auto *start = active[a];
+      std::size_t best = numLineSearchSteps;
+      for (std::size_t k = 0; k < numLineSearchSteps; ++k) {
+        const double stepLength = std::ldexp(1.0, -static_cast<int>(k));
+        const double armijo =
+            start->f + 1e-4 * stepLength * dot(start->grad, directions[a]);
+        const auto v = values[a * numLineSearchSteps + k];
+        if (v <= armijo &&
+            (best == numLineSearchSteps ||
+             v < values[a * numLineSearchSteps + best]))
+          best = k;
+      }
+      if (best == numLineSearchSteps) {
+        // No sufficient decrease: converged, unless we can retry without the
+        // curvature history.
+        if (start->history.empty())
+          start->active = false;
+        start->history.clear();
+        continue;
+      }
+      const double newF = values[a * numLineSearchSteps + best];
+      const bool converged = std::abs(start->f - newF) <
+                             problem.fTol * std::max(1.0, std::abs(newF));
+      if (!converged) {
+        moved.push_back(start);
+        oldX.push_back(start->x);
+        oldGrad.push_back(start->grad);
+      }
+      start->x = candidates[a * numLineSearchSteps + best];
+      start->f = newF;
+      start->active = !converged;
+    }
+
+    if (!moved.empty()) {
+      if (!problem.canEvaluate(moved.size() * 2 * dim))
+        break;
+      evaluateGradients(moved, /*withValue=*/false);
+      for (std::size_t m = 0; m < moved.size(); ++m) {
+        auto *start = moved[m];
+        std::vector<double> s(dim), y(dim);
+        for (int i = 0; i < dim; ++i) {
+          s[i] = start->x[i] - oldX[m][i];
+          y[i] = start->grad[i] - oldGrad[m][i];
+        }
+        if (dot(s, y) > 1e-12) {
+          start->history.emplace_back(std::move(s), std::move(y));
+          if (start->history.size() > historySize)
+            start->history.pop_front();
+        }
+        if (std::sqrt(dot(start->grad, start->grad)) < 1e-8)
+          start->active = false;
+      }
+    }
+
+    active.erase(std::remove_if(active.begin(), active.end(),
+                                [](Start *start) { return !start->active; }),
+                 active.end());
+  }
+  return problem.result();
+}
+
+} // namespace cudaq::optimizers
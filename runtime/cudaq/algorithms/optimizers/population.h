@@ -0,0 +1,95 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include "cudaq/algorithms/optimizer.h"
+#include <optional>
+
+namespace cudaq::optimizers {
+
+/// Base class for gradient-free optimizers that evaluate the objective function
+/// at many independent points per iteration: a set of perturbations, a whole
+/// population, or several local searches. Each iteration is a single call to
+/// the batch objective function, which `cudaq::vqe` spreads over all the QPUs
+/// of the platform. When called through `optimize`, the points are evaluated
+/// one after the other.
+class base_population : public cudaq::optimizer {
+public:
+  /// Maximum number of objective function evaluations.
+  std::optional<int> max_eval;
+  std::optional<std::vector<double>> initial_parameters;
+  std::optional<std::vector<double>> lower_bounds;
+  std::optional<std::vector<double>> upper_bounds;
+  std::optional<double> f_tol;
+  /// Seed of the random number generator, for reproducible optimizations.
+  std::optional<std::size_t> seed;
+
+  bool requiresGradients() override { return false; }
+  bool supportsBatchEvaluation() override { return true; }
+  optimization_result optimize(const int dim,
+                               optimizable_function &&opt_function) override;
+};
+
+/// Simultaneous perturbation stochastic approximation (SPSA), averaging the
+/// gradient estimates of `num_perturbations` random perturbations per
+/// iteration.
+class batched_spsa : public base_population {
+public:
+  std::optional<std::size_t> num_perturbations;
+  std::optional<double> alpha;
+  std::optional<double> gamma;
+  std::optional<double> step_size;
+  std::optional<double> eval_step_size;
+
+  optimization_result
+  optimize_batch(const int dim,
+                 const batch_objective_function &batch_function) override;
+};
+
+/// Covariance matrix adaptation evolution strategy (CMA-ES).
+class cmaes : public base_population {
+public:
+  std::optional<std::size_t> population_size;
+  /// Initial step size, defaults to a third of the mean bounds width.
+  std::optional<double> sigma;
+
+  optimization_result
+  optimize_batch(const int dim,
+                 const batch_objective_function &batch_function) override;
+};
+
+/// Differential evolution (`DE/rand/1/bin`).
+class differential_evolution : public base_population {
+public:
+  std::optional<std::size_t> population_size;
+  std::optional<double> differential_weight;
+  std::optional<double> crossover_probability;
+
+  optimization_result
+  optimize_batch(const int dim,
+                 const batch_objective_function &batch_function) override;
+};
+
+/// L-BFGS from several starting points (the initial parameters, then random
+/// points within the bounds), with central finite-difference gradients. The
+/// gradient components and line search candidates of all the starts are
+/// evaluated together.
+class multistart_lbfgs : public base_population {
+public:
+  std::optional<std::size_t> num_starts;
+  std::optional<std::size_t> history_size;
+  /// Finite difference step used to compute gradients.
+  std::optional<double> eval_step_size;
+
+  optimization_result
+  optimize_batch(const int dim,
+                 const batch_objective_function &batch_function) override;
+};
+
+} // namespace cudaq::optimizers
@@ -0,0 +1,345 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include "gradient.h"
+#include "observe.h"
+#include "optimizer.h"
+#include <atomic>
+#include <cmath>
+#include <deque>
+#include <future>
+#include <map>
+#include <numeric>
+#include <set>
+
+namespace cudaq {
+
+/// Options for `cudaq::pipelined_vqe`.
+struct pipelined_vqe_options {
+  /// Initial variational parameters, all zeros by default.
+  std::optional<std::vector<double>> initial_parameters;
+  std::size_t max_iterations = 100;
+  /// Number of step lengths (1, 1/2, 1/4, ...) of each line search that are
+  /// evaluated concurrently.
+  std::size_t line_search_candidates = 4;
+  /// Length of the first step, taken along the steepest descent direction.
+  double initial_step = 0.5;
+  /// Number of L-BFGS correction pairs.
+  std::size_t history_size = 5;
+  double f_tol = 1e-8;
+  double g_tol = 1e-6;
+  /// Launch the gradient evaluations at the longest step of each line search
+  /// before the line search has completed.
+  bool speculate = true;
+  /// Number of shots, -1 for exact expectation values.
+  int shots = -1;
+};
+
+namespace details {
+
+/// @brief Energy evaluations at parameter points, launched asynchronously on
+/// the platform QPUs (round-robin) and keyed by the parameters. Evaluations
+/// that are not needed anymore can be cancelled: local tasks that have not
+/// started yet are skipped, remote jobs are no longer waited for.
+class PipelinedEvaluator {
+public:
+  using KernelInvoker = std::function<void(const std::vector<double> &)>;
+
+private:
+  enum TaskStatus : int { Pending, Running, Cancelled };
+
+  struct Evaluation {
+    std::atomic<int> status{Pending};
+    std::promise<double> promise;
+    std::future<double> localResult = promise.get_future();
+    std::optional<async_observe_result> remoteResult;
+    std::optional<double> value;
+  };
+
+  KernelInvoker invoker;
+  spin_op &H;
+  quantum_platform &platform;
+  int shots;
+  std::string kernelName;
+  std::size_t nextQpu = 0;
+  std::map<std::vector<double>, std::shared_ptr<Evaluation>> evaluations;
+
+  void cancel(Evaluation &evaluation) {
+    int expected = Pending;
+    if (evaluation.remoteResult ||
+        evaluation.status.compare_exchange_strong(expected, Cancelled))
+      return;
+    // The task is already running and refers to this evaluator, wait for it.
+    if (evaluation.localResult.valid())
+      evaluation.localResult.wait();
+  }
+
+public:
+  PipelinedEvaluator(KernelInvoker &&invoker, spin_op &H,
+                     quantum_platform &platform, int shots,
+                     const std::string &kernelName)
+      : invoker(std::move(invoker)), H(H), platform(platform), shots(shots),
+        kernelName(kernelName) {}
+
+  PipelinedEvaluator(const PipelinedEvaluator &) = delete;
+  PipelinedEvaluator &operator=(const PipelinedEvaluator &) = delete;
+
+  ~PipelinedEvaluator() {
+    for (auto &[x, evaluation] : evaluations)
+      cancel(*evaluation);
+  }
+
+  /// @brief Launch the evaluation at \p x, unless it is already in flight.
+  void prefetch(const std::vector<double> &x) {
+    if (evaluations.count(x))
+      return;
+    auto evaluation = std::make_shared<Evaluation>();
+    evaluations.emplace(x, evaluation);
+    const auto qpuId = nextQpu++ % platform.num_qpus();
+    auto kernel = [this, x]() { invoker(x); };
+    if (platform.is_remote(qpuId)) {
+      evaluation->remoteResult = details::runObservationAsync(
+          std::move(kernel), H, platform, shots, kernelName, qpuId);
+      return;
+    }
+
+    std::function<void()> task = [this, evaluation, qpuId,
+                                  kernel = std::move(kernel)]() mutable {
+      int expected = Pending;
+      if (!evaluation->status.compare_exchange_strong(expected, Running))
+        return;
+      try {
+        evaluation->promise.set_value(
+            details::runObservation(kernel, H, platform, shots, kernelName,
+                                    qpuId)
+                .value()
+                .expectation());
+      } catch (...) {
+        evaluation->promise.set_exception(std::current_exception());
+      }
+    };
+    platform.enqueueAsyncTask(qpuId, task);
+  }
+
+  /// @brief Return the energy at \p x, waiting for it if needed.
+  double get(const std::vector<double> &x) {
+    prefetch(x);
+    auto &evaluation = *evaluations.at(x);
+    if (!evaluation.value)
+      evaluation.value = evaluation.remoteResult
+                             ? evaluation.remoteResult->get().expectation()
+                             : evaluation.localResult.get();
+    return *evaluation.value;
+  }
+
+  /// @brief Cancel all the evaluations except the ones at \p keep.
+  void retain(const std::set<std::vector<double>> &keep) {
+    for (auto iter = evaluations.begin(); iter != evaluations.end();) {
+      if (keep.count(iter->first)) {
+        ++iter;
+        continue;
+      }
+      cancel(*iter->second);
+      iter = evaluations.erase(iter);
+    }
+  }
+};
+
+/// @brief Return the points at which \p gradient evaluates the objective
+/// function to compute the gradient at \p x.
+inline std::vector<std::vector<double>>
+getGradientPoints(gradient &gradient, const std::vector<double> &x) {
+  std::vector<std::vector<double>> points;
+  gradient.compute(
+      x,
+      [&](std::vector<double> point) {
+        points.push_back(std::move(point));
+        return 0.0;
+      },
+      0.0);
+  return points;
+}
+
+/// @brief Run the optimization of `cudaq::pipelined_vqe` on \p platform,
+/// where \p invoker invokes the ansatz at the given parameters.
+inline optimization_result
+runPipelinedVqe(PipelinedEvaluator::KernelInvoker &&invoker,
+                const std::string &kernelName, quantum_platform &platform,
+                gradient &gradient, spin_op &H, const int n_params,
+                const pipelined_vqe_options &options) {
+  auto dot = [](const std::vector<double> &a, const std::vector<double> &b) {
+    return std::inner_product(a.begin(), a.end(), b.begin(), 0.0);
+  };
+  if (options.line_search_candidates == 0)
+    throw std::invalid_argument(
+        "pipelined_vqe requires at least one line search candidate.");
+
+  details::PipelinedEvaluator evaluator(std::move(invoker), H, platform,
+                                        options.shots, kernelName);
+
+  // Launch the energy and gradient at a point, then collect the gradient.
+  auto launch = [&](const std::vector<double> &x) {
+    evaluator.prefetch(x);
+    for (auto &point : details::getGradientPoints(gradient, x))
+      evaluator.prefetch(point);
+  };
+  auto collectGradient = [&](const std::vector<double> &x, double fx) {
+    return gradient.compute(
+        x, [&](std::vector<double> point) { return evaluator.get(point); },
+        fx);
+  };
+
+  std::vector<double> x =
+      options.initial_parameters.value_or(std::vector<double>(n_params));
+  if (x.size() != static_cast<std::size_t>(n_params))
+    throw std::invalid_argument("Invalid number of initial parameters.");
+  launch(x);
+  double fx = evaluator.get(x);
+  std::vector<double> grad = collectGradient(x, fx);
+  std::deque<std::pair<std::vector<double>, std::vector<double>>> history;
+
+  for (std::size_t iter = 0; iter < options.max_iterations; ++iter) {
+    if (std::sqrt(dot(grad, grad)) < options.g_tol)
+      break;
+
+    // L-BFGS two-loop recursion for the search direction.
+    std::vector<double> dir = grad;
+    std::vector<double> alphas(history.size());
+    for (std::size_t j = history.size(); j-- > 0;) {
+      const auto &[s, y] = history[j];
+      alphas[j] = dot(s, dir) / dot(y, s);
+      for (int i = 0; i < n_params; ++i)
+        dir[i] -= alphas[j] * y[i];
+    }
+    const double scale =
+        history.empty()
+            ? options.initial_step / std::sqrt(dot(grad, grad))
+            : dot(history.back().first, history.back().second) /
+                  dot(history.back().second, history.back().second);
+    for (auto &d : dir)
+      d *= scale;
+    for (std::size_t j = 0; j < history.size(); ++j) {
+      const auto &[s, y] = history[j];
+      const double beta = dot(y, dir) / dot(y, s);
+      for (int i = 0; i < n_params; ++i)
+        dir[i] += s[i] * (alphas[j] - beta);
+    }
+    for (auto &d : dir)
+      d = -d;
+
+    // Launch all the line search candidates (and speculatively the gradient
+    // at the first one), then accept the longest step with sufficient
+    // decrease.
+    std::vector<std::vector<double>> candidates;
+    for (std::size_t k = 0; k < options.line_search_candidates; ++k) {
+      std::vector<double> candidate = x;
+      for (int i = 0; i < n_params; ++i)
+        candidate[i] += std::ldexp(dir[i], -static_cast<int>(k));
+      evaluator.prefetch(candidate);
+      candidates.push_back(std::move(candidate));
+    }
+    if (options.speculate)
+      launch(candidates.front());
+
+    const double slope = dot(grad, dir);
+    std::optional<std::size_t> accepted;
+    double fNew = 0.0;
+    for (std::size_t k = 0; k < candidates.size() && !accepted; ++k) {
+      fNew = evaluator.get(candidates[k]);
+      if (fNew <= fx + 1e-4 * std::ldexp(slope, -static_cast<int>(k)))
+        accepted = k;
+    }
+    if (!accepted) {
+      // No sufficient decrease, retry along the steepest descent direction
+      // or stop if that was it already.
+      evaluator.retain({x});
+      if (history.empty())
+        break;
+      history.clear();
+      continue;
+    }
+
+    // Cancel everything that is not needed for the accepted point.
+    auto xNew = candidates[*accepted];
+    auto gradientPoints = details::getGradientPoints(gradient, xNew);
+    std::set<std::vector<double>> keep(gradientPoints.begin(),
+                                       gradientPoints.end());
+    keep.insert(xNew);
+    evaluator.retain(keep);
+    launch(xNew);
+    auto gradNew = collectGradient(xNew, fNew);
+
+    std::vector<double> s(n_params), y(n_params);
+    for (int i = 0; i < n_params; ++i) {
+      s[i] = xNew[i] - x[i];
+      y[i] = gradNew[i] - grad[i];
+    }
+    if (dot(s, y) > 1e-12) {
+      history.emplace_back(std::move(s), std::move(y));
+      if (history.size() > options.history_size)
+        history.pop_front();
+    }
+    const bool converged =
+        std::abs(fx - fNew) < options.f_tol * std::max(1.0, std::abs(fNew));
+    x = std::move(xNew);
+    fx = fNew;
+    grad = std::move(gradNew);
+    if (converged)
+      break;
+  }
+  return std::make_tuple(fx, x);
+}
+} // namespace details
+
+///
+/// \brief Compute the minimal eigenvalue of \p H with a pipelined VQE.
+///
+/// \param kernel The ansatz, a quantum kernel callable with signature
+///        void(std::vector<double>, Args...).
+/// \param gradient The gradient strategy. Only the points it evaluates are
+///        used, the kernel it was constructed with is ignored.
+/// \param H The hermitian cudaq::spin_op to compute the minimal eigenvalue for.
+/// \param n_params The number of variational parameters.
+/// \param options The optimization options.
+/// \param args Non-variational arguments to \p kernel.
+/// \returns The optimal value and corresponding parameters.
+///
+/// \details Unlike `cudaq::vqe`, which waits for each energy evaluation before
+/// issuing the next one, this runs an L-BFGS optimization that keeps many
+/// `observe` calls in flight, spread over the platform QPUs. The energy and
+/// all the gradient components at a point are launched together, as are the
+/// candidates of each backtracking line search. With `options.speculate`, the
+/// gradient at the longest step is launched along with the line search, and
+/// the work that turns out to be unneeded is cancelled. This mostly pays off
+/// on remote and multi-QPU platforms, where each evaluation has a high
+/// latency.
+///
+/// Usage:
+/// \code{.cpp}
+/// cudaq::gradients::parameter_shift gradient;
+/// auto [val, params] = cudaq::pipelined_vqe(ansatz{}, gradient, H, 1, {});
+/// \endcode
+///
+template <typename QuantumKernel, typename... Args,
+          typename = std::enable_if_t<
+              std::is_invocable_v<QuantumKernel, std::vector<double>, Args...>>>
+optimization_result
+pipelined_vqe(QuantumKernel &&kernel, cudaq::gradient &gradient,
+              cudaq::spin_op H, const int n_params,
+              const pipelined_vqe_options &options, Args &&...args) {
+  return details::runPipelinedVqe(
+      [&](const std::vector<double> &x) {
+        cudaq::invokeKernel(std::forward<QuantumKernel>(kernel), x, args...);
+      },
+      cudaq::getKernelName(kernel), cudaq::get_platform(), gradient, H,
+      n_params, options);
+}
+
+} // namespace cudaq
@@ -38,6 +38,31 @@ remote_vqe(cudaq::quantum_platform &platform, QuantumKernel &&kernel,
   return ctx->optResult.value_or(optimization_result{});
 }
 
+/// \brief Internal helper that runs VQE with an optimizer that supports batch
+/// evaluation. The points of each batch are observed asynchronously, in a
+/// round-robin fashion over the available QPUs.
+template <typename QuantumKernel, typename... Args>
+static inline optimization_result
+batch_vqe(cudaq::quantum_platform &platform, QuantumKernel &&kernel,
+          cudaq::spin_op &H, cudaq::optimizer &optimizer, const int n_params,
+          const int shots, Args &&...args) {
+  return optimizer.optimize_batch(
+      n_params, [&](const std::vector<std::vector<double>> &points) {
+        const auto numQpus = platform.num_qpus();
+        std::vector<async_observe_result> futures;
+        futures.reserve(points.size());
+        for (std::size_t i = 0; i < points.size(); ++i)
+          futures.emplace_back(observe_async(shots, i % numQpus, kernel, H,
+                                             std::vector<double>(points[i]),
+                                             args...));
+        std::vector<double> values;
+        values.reserve(points.size());
+        for (auto &f : futures)
+          values.push_back(f.get().expectation());
+        return values;
+      });
+}
+
 static inline void print_arg_mapper_warning() {
   printf(
       "WARNING: Usage of ArgMapper type on this platform will result in "
@@ -112,6 +137,10 @@ optimization_result vqe(QuantumKernel &&kernel, cudaq::spin_op H,
                                     /*gradient=*/nullptr, n_params, /*shots=*/0,
                                     args...);
 
+  if (optimizer.supportsBatchEvaluation())
+    return __internal__::batch_vqe(platform, kernel, H, optimizer, n_params,
+                                   platform.get_shots().value_or(-1), args...);
+
   return optimizer.optimize(n_params, [&](const std::vector<double> &x,
                                           std::vector<double> &grad_vec) {
     double e = cudaq::observe(kernel, H, x, args...);
@@ -183,6 +212,10 @@ optimization_result vqe(std::size_t shots, QuantumKernel &&kernel,
                                     /*gradient=*/nullptr, n_params, shots,
                                     args...);
 
+  if (optimizer.supportsBatchEvaluation())
+    return __internal__::batch_vqe(platform, kernel, H, optimizer, n_params,
+                                   static_cast<int>(shots), args...);
+
   return optimizer.optimize(n_params, [&](const std::vector<double> &x,
                                           std::vector<double> &grad_vec) {
     observe_options options{static_cast<int>(shots), cudaq::noise_model{}};
@@ -7,6 +7,8 @@
  ******************************************************************************/
 
 #include "kernel_builder.h"
+#include "kernel_builder_testing.h"
+#include "common/JIT.h"
 #include "common/Logger.h"
 #include "common/RuntimeMLIR.h"
 #include "cudaq/Optimizer/Builder/Intrinsics.h"
@@ -17,11 +19,14 @@
 #include "cudaq/Optimizer/Dialect/Quake/QuakeDialect.h"
 #include "cudaq/Optimizer/Dialect/Quake/QuakeOps.h"
 #include "cudaq/Optimizer/Transforms/Passes.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
 #include "mlir/Dialect/Affine/Passes.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
 #include "mlir/Dialect/Math/IR/Math.h"
 #include "mlir/ExecutionEngine/ExecutionEngine.h"
+#include "mlir/ExecutionEngine/OptUtils.h"
 #include "mlir/IR/AsmState.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/ImplicitLocOpBuilder.h"
@@ -33,7 +38,13 @@
 #include "mlir/Target/LLVMIR/ModuleTranslation.h"
 #include "mlir/Transforms/Passes.h"
 
+#include <atomic>
+#include <cerrno>
+#include <functional>
+#include <mutex>
 #include <numeric>
+#include <thread>
+#include <vector>
 
 using namespace mlir;
 
@@ -47,6 +58,135 @@ namespace cudaq::details {
 /// @brief Track unique measurement register names.
 static std::size_t regCounter = 0;
 
+/// @brief Return the number of invocations after which a kernel is recompiled
+/// with optimizations, or 0 if tiered compilation is disabled. Tiered
+/// compilation is opt-in, with the `CUDAQ_BUILDER_JIT_TIER_UP` environment
+/// variable.
+static std::size_t getTierUpThreshold() {
+  static const std::size_t threshold = []() -> std::size_t {
+    const char *env = std::getenv("CUDAQ_BUILDER_JIT_TIER_UP");
+    if (!env)
+      return 0;
+    const std::string thresholdStr(env);
+    const char *nptr = thresholdStr.data();
+    char *endptr = nullptr;
+    errno = 0; // reset errno to 0 before call
+    const auto value = strtoll(nptr, &endptr, 10);
+    if (nptr == endptr || *endptr != '\0' || errno != 0 || value < 0)
+      throw std::runtime_error(
+          "Invalid CUDAQ_BUILDER_JIT_TIER_UP setting. Expected a non-negative "
+          "number of invocations. Got: " +
+          thresholdStr);
+    return value;
+  }();
+  return threshold;
+}
+
+/// @brief The threads of the optimized recompilations. They are joined at
+/// exit, before the LLVM globals that they use are destroyed.
+class TierUpThreads {
+public:
+  void start(std::function<void()> task) {
+    std::lock_guard<std::mutex> lock(mutex);
+    threads.emplace_back(std::move(task));
+  }
+
+  ~TierUpThreads() {
+    for (auto &thread : threads)
+      thread.join();
+  }
+
+private:
+  std::mutex mutex;
+  std::vector<std::thread> threads;
+};
+
+/// @brief Return the threads of the optimized recompilations. This is
+/// constructed on the first recompilation, after the LLVM globals, and thus
+/// destroyed before them.
+static TierUpThreads &getTierUpThreads() {
+  static TierUpThreads threads;
+  return threads;
+}
+
+/// @brief If set, the optimized recompilation of kernels fails.
+static std::atomic<bool> tieredJitFailureForTesting = false;
+
+void setTieredJitFailureForTesting(bool fail) {
+  tieredJitFailureForTesting = fail;
+}
+
+/// Kernels are first compiled without optimizations, since optimizing large
+/// circuits is slow. Kernels that are invoked many times (e.g., in a VQE loop)
+/// are recompiled at `-O2` on a background thread, from the LLVM IR of the
+/// first compilation. The optimized engine is published atomically and used by
+/// all subsequent invocations. If the recompilation fails, the kernel keeps
+/// running the unoptimized code.
+///
+/// The background thread shares ownership of the state, so that destroying
+/// (or rebuilding) a kernel does not wait for its optimized recompilation. The
+/// optimized engine is then released when the thread ends. Threads that are
+/// still running at exit are joined.
+struct TieredJitState : std::enable_shared_from_this<TieredJitState> {
+  /// The LLVM IR of the kernel as bitcode.
+  std::string bitcode;
+  std::vector<std::string> extraLibPaths;
+  std::atomic<std::size_t> numInvocations = 0;
+  std::atomic<ExecutionEngine *> optimizedJit = nullptr;
+  std::atomic<bool> failed = false;
+
+  ~TieredJitState() { delete optimizedJit.load(); }
+
+  void tierUp() {
+    getTierUpThreads().start([self = shared_from_this()]() {
+      ExecutionEngineOptions opts;
+      opts.transformer = makeOptimizingTransformer(2, 0, nullptr);
+      opts.jitCodeGenOptLevel = llvm::CodeGenOpt::Default;
+      opts.cache = cudaq::JITObjectCache::get();
+      SmallVector<StringRef, 4> sharedLibs(self->extraLibPaths.begin(),
+                                           self->extraLibPaths.end());
+      opts.sharedLibPaths = sharedLibs;
+      opts.llvmModuleBuilder =
+          [&](Operation *, llvm::LLVMContext &llvmContext)
+          -> std::unique_ptr<llvm::Module> {
+        if (tieredJitFailureForTesting)
+          return nullptr;
+        llvmContext.setOpaquePointers(false);
+        auto moduleOrErr = llvm::parseBitcodeFile(
+            llvm::MemoryBufferRef(self->bitcode, "kernel"), llvmContext);
+        if (!moduleOrErr) {
+          llvm::consumeError(moduleOrErr.takeError());
+          return nullptr;
+        }
+        return std::move(*moduleOrErr);
+      };
+      auto jitOrError = ExecutionEngine::create(nullptr, opts);
+      if (!jitOrError) {
+        cudaq::info("kernel_builder optimized recompilation failed: {}",
+                    llvm::toString(jitOrError.takeError()));
+        self->failed = true;
+        return;
+      }
+      cudaq::info("kernel_builder optimized recompilation finished.");
+      self->optimizedJit.store(jitOrError->release(),
+                               std::memory_order_release);
+    });
+  }
+};
+
+TieredJitStatus
+getTieredJitStatus(const std::shared_ptr<TieredJitState> &tieredJit) {
+  if (!tieredJit)
+    return TieredJitStatus::Disabled;
+  if (tieredJit->optimizedJit.load(std::memory_order_acquire))
+    return TieredJitStatus::Optimized;
+  if (tieredJit->failed)
+    return TieredJitStatus::Failed;
+  if (tieredJit->numInvocations >= getTierUpThreshold())
+    return TieredJitStatus::Compiling;
+  return TieredJitStatus::Unoptimized;
+}
+
 KernelBuilderType convertArgumentTypeToMLIR(double &e) {
   return KernelBuilderType(
       [](MLIRContext *ctx) { return Float64Type::get(ctx); });
@@ -907,7 +1047,8 @@ std::tuple<bool, ExecutionEngine *>
 jitCode(ImplicitLocOpBuilder &builder, ExecutionEngine *jit,
         std::unordered_map<ExecutionEngine *, std::size_t> &jitHash,
         std::string kernelName, std::vector<std::string> extraLibPaths,
-        StateVectorStorage &stateVectorStorage) {
+        StateVectorStorage &stateVectorStorage,
+        std::shared_ptr<TieredJitState> &tieredJit) {
 
   // Start of by getting the current ModuleOp
   auto *block = builder.getBlock();
@@ -1007,15 +1148,24 @@ jitCode(ImplicitLocOpBuilder &builder, ExecutionEngine *jit,
   ExecutionEngineOptions opts;
   opts.transformer = [](llvm::Module *m) { return llvm::ErrorSuccess(); };
   opts.jitCodeGenOptLevel = llvm::CodeGenOpt::None;
+  // Reuse the machine code of previous processes, if enabled.
+  opts.cache = cudaq::JITObjectCache::get();
   SmallVector<StringRef, 4> sharedLibs;
   for (auto &lib : extraLibPaths) {
     cudaq::info("Extra library loaded: {}", lib);
     sharedLibs.push_back(lib);
   }
   opts.sharedLibPaths = sharedLibs;
+  // Keep the LLVM IR around for an optimized recompilation.
+  std::shared_ptr<TieredJitState> newTieredJit;
+  if (getTierUpThreshold() > 0) {
+    newTieredJit = std::make_shared<TieredJitState>();
+    newTieredJit->extraLibPaths = extraLibPaths;
+  }
   opts.llvmModuleBuilder =
-      [](Operation *module,
-         llvm::LLVMContext &llvmContext) -> std::unique_ptr<llvm::Module> {
+      [tiered = newTieredJit.get()](
+          Operation *module,
+          llvm::LLVMContext &llvmContext) -> std::unique_ptr<llvm::Module> {
     llvmContext.setOpaquePointers(false);
     auto llvmModule = translateModuleToLLVMIR(module, llvmContext);
     if (!llvmModule) {
@@ -1023,6 +1173,10 @@ jitCode(ImplicitLocOpBuilder &builder, ExecutionEngine *jit,
       return nullptr;
     }
     ExecutionEngine::setupTargetTriple(llvmModule.get());
+    if (tiered) {
+      llvm::raw_string_ostream os(tiered->bitcode);
+      llvm::WriteBitcodeToFile(*llvmModule, os);
+    }
     return llvmModule;
   };
 
@@ -1032,6 +1186,7 @@ jitCode(ImplicitLocOpBuilder &builder, ExecutionEngine *jit,
 
   auto uniqueJit = std::move(jitOrError.get());
   jit = uniqueJit.release();
+  tieredJit = std::move(newTieredJit);
 
   cudaq::info("- JIT Engine created successfully.");
 
@@ -1067,11 +1222,24 @@ jitCode(ImplicitLocOpBuilder &builder, ExecutionEngine *jit,
 void invokeCode(ImplicitLocOpBuilder &builder, ExecutionEngine *jit,
                 std::string kernelName, void **argsArray,
                 std::vector<std::string> extraLibPaths,
-                StateVectorStorage &storage) {
+                StateVectorStorage &storage,
+                std::shared_ptr<TieredJitState> tieredJit) {
 
   assert(jit != nullptr && "JIT ExecutionEngine was null.");
   cudaq::info("kernel_builder invoke kernel with args.");
 
+  // Switch to the optimized code once it is available, or request it once the
+  // kernel is hot.
+  if (tieredJit) {
+    if (auto *optimizedJit =
+            tieredJit->optimizedJit.load(std::memory_order_acquire))
+      jit = optimizedJit;
+    else if (++tieredJit->numInvocations == getTierUpThreshold()) {
+      cudaq::info("kernel_builder recompiling hot kernel with optimizations.");
+      tieredJit->tierUp();
+    }
+  }
+
   // Kernel names are __nvqpp__mlirgen__BuilderKernelPTRSTR for the following we
   // want the proper name, BuilderKernelPTRST
   std::string properName = name(kernelName);
@@ -91,6 +91,10 @@ using StateVectorVariant = std::variant<std::vector<std::complex<float>> *,
 /// state.
 using StateVectorStorage = std::vector<StateVectorVariant>;
 
+/// Opaque state for recompiling a JIT compiled kernel at a higher optimization
+/// level once it gets hot.
+struct TieredJitState;
+
 // Define a `mlir::Type` generator in the `cudaq` namespace, this helps us keep
 // MLIR out of this public header
 
@@ -251,17 +255,34 @@ std::string name(std::string_view kernelName);
 void applyPasses(mlir::PassManager &);
 
 /// @brief Create the `ExecutionEngine` and return a raw pointer, which we will
-/// wrap in a `unique_ptr`
+/// wrap in a `unique_ptr`. The engine is compiled without optimizations; when
+/// a new engine is created, the tiered compilation state is reset.
 std::tuple<bool, mlir::ExecutionEngine *>
 jitCode(mlir::ImplicitLocOpBuilder &, mlir::ExecutionEngine *,
         std::unordered_map<mlir::ExecutionEngine *, std::size_t> &, std::string,
-        std::vector<std::string>, StateVectorStorage &);
+        std::vector<std::string>, StateVectorStorage &,
+        std::shared_ptr<TieredJitState> &);
 
-/// @brief Invoke the function with the given kernel name.
+/// @brief Invoke the function with the given kernel name. This uses the
+/// optimized engine of \p tieredJit, if it is available, and otherwise counts
+/// the invocation towards triggering its compilation.
 void invokeCode(mlir::ImplicitLocOpBuilder &builder, mlir::ExecutionEngine *jit,
                 std::string kernelName, void **argsArray,
                 std::vector<std::string> extraLibPaths,
-                StateVectorStorage &storage);
+                StateVectorStorage &storage,
+                std::shared_ptr<TieredJitState> tieredJit);
+
+/// @brief Status of the optimized recompilation of a kernel.
+enum class TieredJitStatus {
+  Disabled,
+  Unoptimized,
+  Compiling,
+  Optimized,
+  Failed
+};
+
+/// @brief Return the status of the optimized recompilation in \p tieredJit.
+TieredJitStatus getTieredJitStatus(const std::shared_ptr<TieredJitState> &);
 
 /// @brief Invoke the provided kernel function.
 void call(mlir::ImplicitLocOpBuilder &builder, std::string &name,
@@ -408,6 +429,10 @@ private:
   std::unordered_map<mlir::ExecutionEngine *, std::size_t>
       jitEngineToModuleHash;
 
+  /// @brief Optimized recompilation of the current `ExecutionEngine` once the
+  /// kernel has been invoked often enough.
+  std::shared_ptr<details::TieredJitState> tieredJitState;
+
   /// @brief Name of the CUDA-Q kernel Quake function
   std::string kernelName = "__nvqpp__mlirgen____nvqppBuilderKernel";
 
@@ -860,11 +885,17 @@ public:
     return details::to_quake(*opBuilder);
   }
 
+  /// @brief Return the status of the optimized recompilation of this kernel.
+  details::TieredJitStatus getTieredJitStatus() const {
+    return details::getTieredJitStatus(tieredJitState);
+  }
+
   /// @brief Lower the Quake code to the LLVM Dialect, call `PassManager`.
   void jitCode(std::vector<std::string> extraLibPaths = {}) override {
     auto [wasChanged, ptr] =
         details::jitCode(*opBuilder, jitEngine.get(), jitEngineToModuleHash,
-                         kernelName, extraLibPaths, stateVectorStorage);
+                         kernelName, extraLibPaths, stateVectorStorage,
+                         tieredJitState);
     // If we had a jitEngine, but the code changed, delete the one we had.
     if (jitEngine && wasChanged)
       details::deleteJitEngine(jitEngine.release());
@@ -888,7 +919,7 @@ public:
       jitCode(extraLibPaths);
     }
     details::invokeCode(*opBuilder, jitEngine.get(), kernelName, argsArray,
-                        extraLibPaths, stateVectorStorage);
+                        extraLibPaths, stateVectorStorage, tieredJitState);
   }
 
   /// @brief The call operator for the kernel_builder, takes as input the
@@ -0,0 +1,20 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+// Test hooks of the kernel builder. This header is internal, and is not
+// installed.
+
+namespace cudaq::details {
+
+/// @brief Make the optimized recompilation of kernels fail, so that the
+/// fallback to the unoptimized code can be tested.
+void setTieredJitFailureForTesting(bool fail);
+
+} // namespace cudaq::details
@@ -9,4 +9,5 @@
 #pragma once
 
 #include "algorithms/optimizers/ensmallen/ensmallen.h"
-#include "algorithms/optimizers/nlopt/nlopt.h"
\ No newline at end of file
+#include "algorithms/optimizers/nlopt/nlopt.h"
+#include "algorithms/optimizers/population.h"
\ No newline at end of file
@@ -8,6 +8,7 @@
 
 #include "common/JIT.h"
 #include "common/JsonConvert.h"
+#include "common/KernelCache.h"
 #include "common/Logger.h"
 #include "common/PluginUtils.h"
 #include "common/RemoteKernelExecutor.h"
@@ -97,6 +98,21 @@ class RemoteRestRuntimeServer : public cudaq::RemoteRuntimeServer {
   std::unordered_map<std::size_t, CodeTransformInfo> m_codeTransform;
   // Currently-loaded NVQIR simulator.
   SimulatorHandle m_simHandle;
+  // JIT compiled kernels, keyed on their entry point and IR (and passes). The
+  // client synthesizes the kernel arguments into the IR, so this serves
+  // repeated requests with the same arguments, e.g., the tracing run and shot
+  // loop of a kernel with mid-circuit measurements, or repeated sampling of a
+  // kernel. The oldest kernel is evicted once the cache is full.
+  static constexpr std::size_t MAX_CACHED_KERNELS = 64;
+  struct MlirKernel {
+    OwningOpRef<ModuleOp> module;
+    std::unique_ptr<ExecutionEngine> engine;
+  };
+  cudaq::KernelCache<cudaq::WrappedKernel> m_llvmKernels{
+      MAX_CACHED_KERNELS, [](cudaq::WrappedKernel &kernel) {
+        clearRegOpsAndDestroyJIT(kernel.jit);
+      }};
+  cudaq::KernelCache<MlirKernel> m_mlirKernels{MAX_CACHED_KERNELS};
   // Default backend for initialization.
   // Note: we always need to preload a default backend on the server runtime
   // since cudaq runtime relies on that.
@@ -360,18 +376,16 @@ public:
     auto &platform = cudaq::get_platform();
     auto &requestInfo = m_codeTransform[reqId];
 
-    // The lifetime of this pointer should be just as long as `platform` because
-    // any calls to `platform` functions could invoke code that relies on the
-    // JIT being present.
-    std::unique_ptr<llvm::orc::LLJIT> llvmJit;
     if (requestInfo.format == cudaq::CodeFormat::LLVM) {
+      // The compiled kernel is cached and outlives this request, so any calls
+      // to `platform` functions can rely on the JIT being present.
+      const auto &kernel = getWrappedKernel(ir, std::string(kernelName));
       if (io_context.name == "sample") {
         // In library mode (LLVM), check to see if we have mid-circuit measures
         // by tracing the kernel function.
         cudaq::ExecutionContext context("tracer");
         platform.set_exec_ctx(&context);
-        llvmJit = cudaq::invokeWrappedKernel(ir, std::string(kernelName),
-                                             kernelArgs, argsSize);
+        cudaq::invokeWrappedKernel(kernel, kernelArgs, argsSize);
         platform.reset_exec_ctx();
         // In trace mode, if we have a measure result
         // that is passed to an if statement, then
@@ -385,14 +399,12 @@ public:
           // Need to run simulation shot-by-shot
           cudaq::sample_result counts;
           platform.set_exec_ctx(&io_context);
-          // Since registered operations may contain pointers to classes defined
-          // in an LLVM JIT, we must clear them before any prior LLVM JIT gets
-          // deleted.
-          clearRegOpsAndDestroyJIT(llvmJit);
+          // Drop the operations registered by the tracing run.
+          cudaq::getExecutionManager()->clearRegisteredOperations();
           // If it has conditionals, loop over individual circuit executions
-          llvmJit = cudaq::invokeWrappedKernel(
-              ir, std::string(kernelName), kernelArgs, argsSize,
-              io_context.shots, [&](std::size_t i) {
+          cudaq::invokeWrappedKernel(
+              kernel, kernelArgs, argsSize, io_context.shots,
+              [&](std::size_t i) {
                 // Reset the context and get the single
                 // measure result, add it to the
                 // sample_result and clear the context
@@ -408,17 +420,13 @@ public:
         } else {
           // If no conditionals, nothing special to do for library mode
           platform.set_exec_ctx(&io_context);
-          // Since registered operations may contain pointers to classes defined
-          // in an LLVM JIT, we must clear them before any prior LLVM JIT gets
-          // deleted.
-          clearRegOpsAndDestroyJIT(llvmJit);
-          llvmJit = cudaq::invokeWrappedKernel(ir, std::string(kernelName),
-                                               kernelArgs, argsSize);
+          // Drop the operations registered by the tracing run.
+          cudaq::getExecutionManager()->clearRegisteredOperations();
+          cudaq::invokeWrappedKernel(kernel, kernelArgs, argsSize);
         }
       } else {
         platform.set_exec_ctx(&io_context);
-        llvmJit = cudaq::invokeWrappedKernel(ir, std::string(kernelName),
-                                             kernelArgs, argsSize);
+        cudaq::invokeWrappedKernel(kernel, kernelArgs, argsSize);
       }
     } else {
       platform.set_exec_ctx(&io_context);
@@ -447,14 +455,23 @@ public:
       }
     }
     platform.reset_exec_ctx();
-    // Clear the registered operations before the `llvmJit` goes out of scope
-    // so that destruction of registered operations doesn't cause segfaults
-    // during shutdown.
-    clearRegOpsAndDestroyJIT(llvmJit);
+    // Registered operations may contain pointers into the JIT'ed code. Clear
+    // them after each request, so that none of them outlives its JIT when it
+    // is evicted from the cache.
+    cudaq::getExecutionManager()->clearRegisteredOperations();
     simulationEnd = std::chrono::high_resolution_clock::now();
   }
 
 protected:
+  const cudaq::WrappedKernel &getWrappedKernel(std::string_view ir,
+                                               const std::string &kernelName) {
+    std::string key = kernelName + '\n';
+    key.append(ir);
+    return m_llvmKernels.get(key, [&]() {
+      return cudaq::compileWrappedKernel(ir, kernelName);
+    });
+  }
+
   std::unique_ptr<ExecutionEngine>
   jitMlirCode(ModuleOp currentModule, const std::vector<std::string> &passes,
               const std::vector<std::string> &extraLibPaths = {}) {
@@ -549,13 +566,21 @@ protected:
                    const std::vector<std::string> &passes,
                    const std::string &entryPointFn, std::size_t numTimes = 1,
                    std::function<void(std::size_t)> postExecCallback = {}) {
-    llvm::SourceMgr sourceMgr;
-    sourceMgr.AddNewSourceBuffer(llvm::MemoryBuffer::getMemBufferCopy(irString),
-                                 llvm::SMLoc());
-    auto module = parseSourceFile<ModuleOp>(sourceMgr, contextPtr.get());
-    if (!module)
-      throw std::runtime_error("Failed to parse the input MLIR code");
-    auto engine = jitMlirCode(*module, passes);
+    std::string key = entryPointFn + '\n';
+    for (const auto &pass : passes)
+      key += pass + ',';
+    key += '\n';
+    key.append(irString);
+    auto &[module, engine] = m_mlirKernels.get(key, [&]() {
+      llvm::SourceMgr sourceMgr;
+      sourceMgr.AddNewSourceBuffer(
+          llvm::MemoryBuffer::getMemBufferCopy(irString), llvm::SMLoc());
+      auto parsed = parseSourceFile<ModuleOp>(sourceMgr, contextPtr.get());
+      if (!parsed)
+        throw std::runtime_error("Failed to parse the input MLIR code");
+      auto jit = jitMlirCode(*parsed, passes);
+      return MlirKernel{std::move(parsed), std::move(jit)};
+    });
     llvm::SmallVector<void *> returnArg;
     const std::string entryPointFunc =
         std::string(cudaq::runtime::cudaqGenPrefixName) + entryPointFn;
@@ -789,9 +814,18 @@ protected:
                request.executionContext.amplitudeMaps.value()) {
             val = serverState->getAmplitude(key);
           }
+          const std::size_t numQubits = serverState->getNumQubits();
+          request.executionContext.stateNumQubits = numQubits;
+          // Unless the client would retrieve it next anyway.
+          if (numQubits <=
+              request.executionContext.maxFullStateQubits.value_or(0))
+            request.executionContext.simulationState = std::move(serverState);
         }
 
-        resultJson["executionContext"] = request.executionContext;
+        // Clients that advertise it get the state amplitudes as raw bytes
+        // rather than a JSON array, which is much cheaper for large states.
+        resultJson["executionContext"] =
+            cudaq::serializeResponseContext(request);
       }
       m_codeTransform.erase(reqId);
       return resultJson;
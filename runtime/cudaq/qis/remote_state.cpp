@@ -8,31 +8,42 @@
 
 #include "remote_state.h"
 #include "common/Logger.h"
+#include <algorithm>
 
 namespace cudaq {
 
+// Number of amplitudes fetched at once for element-wise access to large remote
+// states, and number of such blocks kept on the client.
+static constexpr std::size_t AMPLITUDE_BLOCK_SIZE = 4096;
+static constexpr std::size_t MAX_CACHED_AMPLITUDE_BLOCKS = 16;
+
+void RemoteSimulationState::launchKernel(ExecutionContext &context) const {
+  auto &platform = cudaq::get_platform();
+  // Redirect remote platform log (if any)
+  // Note: due to the lazy-evaluation mechanism, the execution on the remote
+  // platform may occur during accessor API calls (e.g., amplitude, overlap).
+  // We want to defer any platform logging so that it would not interrupt
+  // potential logging of the result of the API call.
+  std::ostringstream remoteLogCout;
+  platform.setLogStream(remoteLogCout);
+  // Perform the usual pattern set the context,
+  // execute and then reset
+  platform.set_exec_ctx(&context);
+  platform.launchKernel(kernelName, args);
+  platform.reset_exec_ctx();
+  platform.resetLogStream();
+  // Cache the info log if any.
+  platformExecutionLog = remoteLogCout.str();
+}
+
 void RemoteSimulationState::execute() const {
   if (!state) {
-    auto &platform = cudaq::get_platform();
     // Create an execution context, indicate this is for
     // extracting the state representation
     ExecutionContext context("extract-state");
-    // Perform the usual pattern set the context,
-    // execute and then reset
-    platform.set_exec_ctx(&context);
-    // Redirect remote platform log (if any)
-    // Note: due to the lazy-evaluation mechanism, the execution on the remote
-    // platform may occur during accessor API calls (e.g., amplitude, overlap).
-    // We want to defer any platform logging so that it would not interrupt
-    // potential logging of the result of the API call.
-    std::ostringstream remoteLogCout;
-    platform.setLogStream(remoteLogCout);
-    platform.launchKernel(kernelName, args);
-    platform.reset_exec_ctx();
-    platform.resetLogStream();
-    // Cache the info log if any.
-    platformExecutionLog = remoteLogCout.str();
+    launchKernel(context);
     state = std::move(context.simulationState);
+    amplitudeBlocks.clear();
   }
 }
 
@@ -51,8 +62,29 @@ RemoteSimulationState::~RemoteSimulationState() {
 }
 
 std::size_t RemoteSimulationState::getNumQubits() const {
-  execute();
-  return state->getNumQubits();
+  if (state)
+    return state->getNumQubits();
+  if (!numQubits) {
+    // Query the size of the state without transferring any amplitude, unless
+    // the state is small enough to be transferred in full. In that case, the
+    // state comes back with its size, as any later access would retrieve it.
+    ExecutionContext context("extract-state");
+    context.amplitudeMaps.emplace();
+    context.maxFullStateQubits = maxQubitCountForFullStateTransfer();
+    launchKernel(context);
+    if (context.simulationState) {
+      state = std::move(context.simulationState);
+      amplitudeBlocks.clear();
+      return state->getNumQubits();
+    }
+    numQubits = context.stateNumQubits;
+    // Older servers don't report the number of qubits.
+    if (!numQubits) {
+      execute();
+      numQubits = state->getNumQubits();
+    }
+  }
+  return *numQubits;
 }
 
 cudaq::SimulationState::Tensor
@@ -73,6 +105,15 @@ std::size_t RemoteSimulationState::getNumTensors() const { return 1; }
 std::complex<double>
 RemoteSimulationState::operator()(std::size_t tensorIdx,
                                   const std::vector<std::size_t> &indices) {
+  if (!state && tensorIdx == 0 && indices.size() == 1 &&
+      getNumQubits() > maxQubitCountForFullStateTransfer()) {
+    const auto idx = indices[0];
+    if (idx >= (1ULL << getNumQubits()))
+      throw std::runtime_error(
+          "[RemoteSimulationState] Index out of range in element access.");
+    const auto &block = getAmplitudeBlock(idx / AMPLITUDE_BLOCK_SIZE);
+    return block[idx % AMPLITUDE_BLOCK_SIZE];
+  }
   execute();
   return state->operator()(tensorIdx, indices);
 }
@@ -93,7 +134,10 @@ cudaq::SimulationState::precision RemoteSimulationState::getPrecision() const {
   return state->getPrecision();
 }
 
-void RemoteSimulationState::destroyState() { state.reset(); }
+void RemoteSimulationState::destroyState() {
+  state.reset();
+  amplitudeBlocks.clear();
+}
 
 bool RemoteSimulationState::isDeviceData() const {
   execute();
@@ -138,11 +182,15 @@ std::vector<std::complex<double>> RemoteSimulationState::getAmplitudes(
   if (basisStates.empty())
     return {};
 
-  if (basisStates[0].size() <= maxQubitCountForFullStateTransfer()) {
+  if (state || basisStates[0].size() <= maxQubitCountForFullStateTransfer()) {
     execute();
     return state->getAmplitudes(basisStates);
   }
-  auto &platform = cudaq::get_platform();
+  return fetchAmplitudes(basisStates);
+}
+
+std::vector<std::complex<double>> RemoteSimulationState::fetchAmplitudes(
+    const std::vector<std::vector<int>> &basisStates) const {
   // Create an execution context, indicate this is for
   // extracting the state representation
   ExecutionContext context("extract-state");
@@ -150,11 +198,9 @@ std::vector<std::complex<double>> RemoteSimulationState::getAmplitudes(
   for (const auto &basisState : basisStates)
     amplitudeMaps[basisState] = {};
   context.amplitudeMaps = std::move(amplitudeMaps);
-  // Perform the usual pattern set the context,
-  // execute and then reset
-  platform.set_exec_ctx(&context);
-  platform.launchKernel(kernelName, args);
-  platform.reset_exec_ctx();
+  launchKernel(context);
+  if (context.stateNumQubits.has_value())
+    numQubits = context.stateNumQubits;
   std::vector<std::complex<double>> amplitudes;
   amplitudes.reserve(basisStates.size());
   for (const auto &basisState : basisStates)
@@ -162,6 +208,38 @@ std::vector<std::complex<double>> RemoteSimulationState::getAmplitudes(
   return amplitudes;
 }
 
+const std::vector<std::complex<double>> &
+RemoteSimulationState::getAmplitudeBlock(std::size_t blockIdx) const {
+  auto iter = std::find_if(
+      amplitudeBlocks.begin(), amplitudeBlocks.end(),
+      [blockIdx](const auto &block) { return block.first == blockIdx; });
+  if (iter != amplitudeBlocks.end()) {
+    // Move to the front as the most recently used.
+    amplitudeBlocks.splice(amplitudeBlocks.begin(), amplitudeBlocks, iter);
+    return amplitudeBlocks.front().second;
+  }
+
+  const std::size_t n = getNumQubits();
+  const std::size_t begin = blockIdx * AMPLITUDE_BLOCK_SIZE;
+  const std::size_t end =
+      std::min<std::size_t>(begin + AMPLITUDE_BLOCK_SIZE, 1ULL << n);
+  std::vector<std::vector<int>> basisStates;
+  basisStates.reserve(end - begin);
+  for (std::size_t idx = begin; idx < end; ++idx) {
+    // Basis states are little-endian: the first bit is the least significant.
+    std::vector<int> basisState(n);
+    for (std::size_t i = 0; i < n; ++i)
+      basisState[i] = (idx >> i) & 1;
+    basisStates.emplace_back(std::move(basisState));
+  }
+  cudaq::info("[RemoteSimulationState] Fetching amplitudes [{}, {}).", begin,
+              end);
+  amplitudeBlocks.emplace_front(blockIdx, fetchAmplitudes(basisStates));
+  if (amplitudeBlocks.size() > MAX_CACHED_AMPLITUDE_BLOCKS)
+    amplitudeBlocks.pop_back();
+  return amplitudeBlocks.front().second;
+}
+
 std::complex<double>
 RemoteSimulationState::getAmplitude(const std::vector<int> &basisState) {
   return getAmplitudes({basisState}).front();
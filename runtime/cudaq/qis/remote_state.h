@@ -11,6 +11,7 @@
 #include "common/SimulationState.h"
 #include "cudaq.h"
 #include "cudaq/utils/cudaq_utils.h"
+#include <list>
 
 namespace cudaq {
 /// Implementation of `SimulationState` for remote simulator backends.
@@ -30,6 +31,13 @@ protected:
   // Cache log messages from the remote execution.
   // Mutable to support lazy execution during `const` API calls.
   mutable std::string platformExecutionLog;
+  // Number of qubits of the state, as reported by the remote simulator when
+  // only part of the state was requested.
+  mutable std::optional<std::size_t> numQubits;
+  // Most recently used blocks of amplitudes (block index, amplitudes), for
+  // element-wise access to states that are too large to transfer in full.
+  mutable std::list<std::pair<std::size_t, std::vector<std::complex<double>>>>
+      amplitudeBlocks;
   using ArgDeleter = std::function<void(void *)>;
   /// @brief  Vector of arguments
   // Note: we create a copy of all arguments except pointers.
@@ -82,6 +90,9 @@ public:
   /// @brief Triggers remote execution to resolve the state data.
   virtual void execute() const;
 
+  /// @brief Launch the kernel on the remote platform under the given context.
+  virtual void launchKernel(ExecutionContext &context) const;
+
   /// @brief Helper to retrieve (kernel name, `args` pointers)
   virtual std::pair<std::string, std::vector<void *>> getKernelInfo() const;
 
@@ -152,5 +163,15 @@ private:
   /// @brief Return the qubit count threshold where the full remote state should
   /// be flattened and returned.
   static std::size_t maxQubitCountForFullStateTransfer();
+
+  /// @brief Compute the given amplitudes on the remote simulator, without
+  /// transferring the full state.
+  std::vector<std::complex<double>>
+  fetchAmplitudes(const std::vector<std::vector<int>> &basisStates) const;
+
+  /// @brief Return the block of amplitudes with the given index, fetching it
+  /// from the remote simulator if it is not cached.
+  const std::vector<std::complex<double>> &
+  getAmplitudeBlock(std::size_t blockIdx) const;
 };
 } // namespace cudaq
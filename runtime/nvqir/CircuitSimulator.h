@@ -755,10 +755,11 @@ protected:
             stateDimension * sizeof(std::complex<ScalarType>));
       try {
         applyGate(next);
-      } catch (std::exception &e) {
+      } catch (std::exception &) {
         while (!gateQueue.empty())
           gateQueue.pop();
-        throw e;
+        // Rethrow the original exception, and not a copy sliced to its base.
+        throw;
       } catch (...) {
         while (!gateQueue.empty())
           gateQueue.pop();
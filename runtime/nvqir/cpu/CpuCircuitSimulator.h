@@ -0,0 +1,272 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CpuState.h"
+#include "nvqir/CircuitSimulator.h"
+
+#include <random>
+
+namespace nvqir {
+
+/// @brief The CpuCircuitSimulator is a multi-threaded CPU state vector
+/// simulator, templated on the floating point precision of the amplitudes.
+/// Unlike the Q++ backend, gates are applied in place, by vectorized kernels
+/// specialized for the single and double precision amplitudes.
+template <typename ScalarType>
+class CpuCircuitSimulator : public nvqir::CircuitSimulatorBase<ScalarType> {
+protected:
+  using DataType = std::complex<ScalarType>;
+  using DataVector = std::vector<DataType>;
+  using GateApplicationTask =
+      typename nvqir::CircuitSimulatorBase<ScalarType>::GateApplicationTask;
+
+  using nvqir::CircuitSimulatorBase<ScalarType>::nQubitsAllocated;
+  using nvqir::CircuitSimulatorBase<ScalarType>::stateDimension;
+  using nvqir::CircuitSimulatorBase<ScalarType>::executionContext;
+  using nvqir::CircuitSimulatorBase<ScalarType>::flushGateQueue;
+  using nvqir::CircuitSimulatorBase<ScalarType>::flushAnySamplingTasks;
+  using nvqir::CircuitSimulatorBase<ScalarType>::shouldObserveFromSampling;
+  using nvqir::CircuitSimulatorBase<ScalarType>::summaryData;
+
+  /// @brief The state vector, qubit q is bit q of the amplitude index.
+  DataVector state;
+
+  /// @brief Random number generator for measurements and sampling.
+  std::mt19937_64 randomEngine;
+
+  /// @brief Grow the state vector by one qubit.
+  void addQubitToState() override { addQubitsToState(1); }
+
+  void addQubitsToState(std::size_t qubitCount,
+                        const void *stateDataIn = nullptr) override {
+    if (qubitCount == 0)
+      return;
+
+    const auto *stateData = reinterpret_cast<const DataType *>(stateDataIn);
+    if (state.empty()) {
+      if (stateData) {
+        state.assign(stateData, stateData + stateDimension);
+        return;
+      }
+      state.resize(stateDimension);
+      state[0] = 1;
+      return;
+    }
+
+    // The new qubits are the most significant ones, so |0..0> (x) |psi> is
+    // |psi> followed by zeros.
+    if (!stateData) {
+      state.resize(stateDimension);
+      return;
+    }
+    kron(stateData, 1ULL << qubitCount);
+  }
+
+  void addQubitsToState(const cudaq::SimulationState &in_state) override {
+    DataVector amplitudes;
+    if (const auto *casted =
+            dynamic_cast<const CpuState<ScalarType> *>(&in_state))
+      amplitudes = casted->getAmplitudes();
+    else
+      amplitudes = getHostAmplitudes<ScalarType>(in_state);
+
+    if (state.empty()) {
+      state = std::move(amplitudes);
+      return;
+    }
+    kron(amplitudes.data(), amplitudes.size());
+  }
+
+  /// @brief Replace the state with `data` (x) `state`.
+  void kron(const DataType *data, std::size_t size) {
+    const std::size_t oldDimension = state.size();
+    DataVector newState(oldDimension * size);
+#if defined(_OPENMP)
+#pragma omp parallel for if (newState.size() >= cpu::minParallelDimension)
+#endif
+    for (std::int64_t i = 0; i < static_cast<std::int64_t>(newState.size());
+         ++i)
+      newState[i] = cpu::multiply(data[i / oldDimension],
+                                  state[i % oldDimension]);
+    state = std::move(newState);
+  }
+
+  /// @brief Reset the qubit state.
+  void deallocateStateImpl() override {
+    DataVector empty;
+    state.swap(empty);
+  }
+
+  void applyGate(const GateApplicationTask &task) override {
+    cpu::applyMatrix(state.data(), stateDimension, task.matrix, task.controls,
+                     task.targets);
+  }
+
+  /// @brief Set the current state back to the |0> state.
+  void setToZeroState() override {
+    cpu::setZeroState(state.data(), stateDimension);
+  }
+
+  /// @brief Measure the qubit and collapse the state vector in place.
+  bool measureQubit(const std::size_t index) override {
+    const std::size_t mask = 1ULL << index;
+    const double probOne =
+        cpu::probability(state.data(), stateDimension, mask, mask);
+    const bool result =
+        std::uniform_real_distribution<double>(0.0, 1.0)(randomEngine) <
+        probOne;
+    cpu::collapse(state.data(), stateDimension, index, result,
+                  1.0 / std::sqrt(result ? probOne : 1.0 - probOne));
+    cudaq::info("Measured qubit {} -> {}", index, result);
+    return result;
+  }
+
+  /// @brief Sample the state vector \p shots times, returning the sorted
+  /// amplitude indices.
+  std::vector<std::size_t> sampleIndices(std::size_t shots) {
+    const double total = cpu::probability(state.data(), stateDimension, 0, 0);
+    std::uniform_real_distribution<double> uniform(0.0, total);
+    std::vector<double> draws(shots);
+    for (auto &draw : draws)
+      draw = uniform(randomEngine);
+    std::sort(draws.begin(), draws.end());
+    return cpu::resolveDraws(state.data(), stateDimension, draws);
+  }
+
+public:
+  CpuCircuitSimulator() {
+    // Populate the correct name so it is printed correctly during
+    // deconstructor.
+    summaryData.name = name();
+    std::random_device randomDevice;
+    randomEngine = std::mt19937_64(randomDevice());
+  }
+  virtual ~CpuCircuitSimulator() = default;
+
+  void setRandomSeed(std::size_t seed) override {
+    randomEngine = std::mt19937_64(seed);
+  }
+
+  bool canHandleObserve() override {
+    // Do not compute <H> from the state if shots based sampling requested
+    if (executionContext &&
+        executionContext->shots != static_cast<std::size_t>(-1)) {
+      return false;
+    }
+
+    return !shouldObserveFromSampling();
+  }
+
+  /// @brief Compute <psi|H|psi> term by term, directly from the state vector.
+  cudaq::observe_result observe(const cudaq::spin_op &op) override {
+    flushGateQueue();
+    double ee = 0.0;
+    op.for_each_term([&](cudaq::spin_op &term) {
+      const auto masks = cpu::getPauliMasks(term);
+      ee += term.get_coefficient().real() *
+            cpu::expectationPauli(state.data(), stateDimension, masks.xMask,
+                                  masks.zMask, masks.nY);
+    });
+    return cudaq::observe_result(ee, op,
+                                 cudaq::sample_result(cudaq::ExecutionResult(
+                                     {}, op.to_string(false), ee)));
+  }
+
+  /// @brief Apply exp(i theta P) in a single pass over the state vector,
+  /// rather than through the basis change and CNOT ladder decomposition of
+  /// the base class.
+  void applyExpPauli(double theta, const std::vector<std::size_t> &controls,
+                     const std::vector<std::size_t> &qubitIds,
+                     const cudaq::spin_op &op) override {
+    // The decomposition is still used to trace the gates or apply noise.
+    if (op.is_identity() ||
+        (executionContext && (executionContext->name == "tracer" ||
+                              executionContext->noiseModel))) {
+      nvqir::CircuitSimulatorBase<ScalarType>::applyExpPauli(theta, controls,
+                                                             qubitIds, op);
+      return;
+    }
+
+    flushGateQueue();
+    cudaq::info(" [{}] exp_pauli({}, {})", name(), theta, op.to_string(false));
+    const auto masks = cpu::getPauliMasks(op, qubitIds);
+    std::size_t controlMask = 0;
+    for (auto c : controls)
+      controlMask |= 1ULL << c;
+    if (summaryData.enabled)
+      summaryData.svGateUpdate(controls.size(),
+                               std::popcount(masks.xMask | masks.zMask),
+                               stateDimension,
+                               stateDimension * sizeof(DataType));
+    cpu::applyExpPauli(state.data(), stateDimension, theta, masks.xMask,
+                       masks.zMask, masks.nY, controlMask);
+  }
+
+  /// @brief Reset the qubit to |0>.
+  void resetQubit(const std::size_t index) override {
+    flushGateQueue();
+    flushAnySamplingTasks();
+    const DataType xMatrix[] = {0, 1, 1, 0};
+    if (measureQubit(index))
+      cpu::applyOneQubitMatrix(state.data(), stateDimension, xMatrix, index);
+  }
+
+  /// @brief Sample the multi-qubit state.
+  cudaq::ExecutionResult sample(const std::vector<std::size_t> &qubits,
+                                const int shots) override {
+    std::size_t zMask = 0;
+    for (auto q : qubits)
+      zMask |= 1ULL << q;
+    if (shots < 1) {
+      const double expectationValue =
+          cpu::expectationZ(state.data(), stateDimension, zMask);
+      cudaq::info("Computed expectation value = {}", expectationValue);
+      return cudaq::ExecutionResult{{}, expectationValue};
+    }
+
+    // Pack the measured bits of each outcome, bit k being `qubits[k]`.
+    auto outcomes = sampleIndices(shots);
+    for (auto &outcome : outcomes) {
+      std::size_t packed = 0;
+      for (std::size_t k = 0; k < qubits.size(); ++k)
+        packed |= ((outcome >> qubits[k]) & 1) << k;
+      outcome = packed;
+    }
+    return cpu::countOutcomes(outcomes, qubits.size());
+  }
+
+  std::unique_ptr<cudaq::SimulationState> getSimulationState() override {
+    flushGateQueue();
+    return std::make_unique<CpuState<ScalarType>>(std::move(state));
+  }
+
+  bool isStateVectorSimulator() const override { return true; }
+
+  /// @brief Primarily used for testing.
+  DataVector getStateVector() {
+    flushGateQueue();
+    return state;
+  }
+
+  std::string name() const override;
+  NVQIR_SIMULATOR_CLONE_IMPL(CpuCircuitSimulator<ScalarType>)
+};
+
+template <>
+std::string CpuCircuitSimulator<float>::name() const;
+
+/// The double precision simulator is not registered on its own, only as the
+/// base of the other CPU simulators, which override the name.
+template <>
+inline std::string CpuCircuitSimulator<double>::name() const {
+  return "cpu";
+}
+
+} // namespace nvqir
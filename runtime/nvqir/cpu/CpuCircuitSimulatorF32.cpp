@@ -0,0 +1,16 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "CpuCircuitSimulator.h"
+
+/// Register this Simulator with NVQIR.
+template <>
+std::string nvqir::CpuCircuitSimulator<float>::name() const {
+  return "cpu-fp32";
+}
+NVQIR_REGISTER_SIMULATOR(nvqir::CpuCircuitSimulator<float>, cpu_fp32)
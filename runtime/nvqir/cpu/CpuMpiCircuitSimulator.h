@@ -0,0 +1,584 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CpuCircuitSimulator.h"
+#include "cudaq/distributed/mpi_plugin.h"
+
+namespace nvqir {
+
+/// @brief The CpuMpiCircuitSimulator distributes the state vector of the CPU
+/// simulator across the processes of the CUDA-Q MPI plugin. With 2^g ranks,
+/// the n-qubit state is split into slices of 2^(n-g) amplitudes: the n-g low
+/// (local) bits of an amplitude index address the slice of a rank, and the g
+/// high (global) bits are the rank itself.
+///
+/// Qubits are mapped to index bits, or slots, by a permutation. Gates are
+/// applied in place to the local slots by the CPU kernels, and controls on
+/// global slots are resolved per rank. A target on a global slot is first
+/// swapped with a free local slot, by exchanging half of the slice with the
+/// partner rank. Probabilities, expectation values and samples are reduced
+/// across the ranks.
+///
+/// Below `CUDAQ_CPU_MPI_NQUBITS_THRESH` qubits, or without MPI, every rank
+/// simulates the full state independently, as the CPU simulator does.
+///
+/// The simulator makes collective MPI calls, so all ranks must execute the
+/// same kernels. This includes the first allocation, even below the
+/// threshold, where rank 0 broadcasts the random seed to the other ranks.
+template <typename ScalarType>
+class CpuMpiCircuitSimulator : public CpuCircuitSimulator<ScalarType> {
+protected:
+  using Base = CpuCircuitSimulator<ScalarType>;
+  using typename Base::DataVector;
+  using typename Base::GateApplicationTask;
+  using Amplitude = typename Base::DataType;
+
+  using Base::executionContext;
+  using Base::flushAnySamplingTasks;
+  using Base::flushGateQueue;
+  using Base::nQubitsAllocated;
+  using Base::randomEngine;
+  using Base::state;
+  using Base::summaryData;
+
+  /// @brief Slices keep at least this many local qubits, so that multi-qubit
+  /// gates always find enough free local slots.
+  static constexpr std::size_t minLocalQubits = 6;
+
+  /// @brief Maximum number of amplitudes per point-to-point message.
+  static constexpr std::size_t maxMessageSize = 1ULL << 20;
+
+  static constexpr auto mpiAmplitudeType =
+      std::is_same_v<ScalarType, float> ? FLOAT_COMPLEX : DOUBLE_COMPLEX;
+
+  cudaqDistributedInterface_t *mpiInterface = nullptr;
+  cudaqDistributedCommunicator_t *comm = nullptr;
+  std::size_t rank = 0;
+  std::size_t numRanks = 1;
+
+  /// @brief The number of global slots, 0 if the state is not distributed.
+  std::size_t numGlobal = 0;
+
+  /// @brief The number of local slots of a distributed state.
+  std::size_t numLocal = 0;
+
+  /// @brief The slot of each qubit.
+  std::vector<std::size_t> slots;
+
+  /// @brief The qubit count from which the state is distributed.
+  std::size_t distributionThreshold = 25;
+
+  /// @brief Whether all ranks use the same random seed, so that they draw
+  /// the same measurement results and samples.
+  bool seedSynchronized = false;
+
+  bool isDistributed() const { return numGlobal > 0; }
+
+  /// @brief Return the bit of this rank for the global \p slot.
+  bool getRankBit(std::size_t slot) const {
+    return (rank >> (slot - numLocal)) & 1;
+  }
+
+  void checkMpi(int status, const char *operation) const {
+    if (status != 0)
+      throw std::runtime_error(fmt::format(
+          "[cpu-mpi] MPI {} failed with error {}.", operation, status));
+  }
+
+  double allReduceSum(double value) const {
+    checkMpi(mpiInterface->AllreduceInPlace(comm, &value, 1, FLOAT_64, SUM),
+             "AllreduceInPlace");
+    return value;
+  }
+
+  /// @brief Retrieve the communicator if MPI has been initialized, and agree
+  /// on a random seed across ranks.
+  void initializeMpi() {
+    if (mpiInterface)
+      return;
+    auto *mpiPlugin = cudaq::mpi::getMpiPlugin(/*unsafe=*/true);
+    if (!mpiPlugin || !mpiPlugin->is_initialized())
+      return;
+    mpiInterface = mpiPlugin->get();
+    comm = mpiPlugin->getComm();
+    if (!mpiInterface || !comm)
+      throw std::runtime_error(
+          "[cpu-mpi] Invalid MPI distributed plugin encountered.");
+
+    int32_t value = 0;
+    checkMpi(mpiInterface->getNumRanks(comm, &value), "getNumRanks");
+    numRanks = value;
+    checkMpi(mpiInterface->getProcRank(comm, &value), "getProcRank");
+    rank = value;
+    if (!std::has_single_bit(numRanks))
+      throw std::runtime_error(fmt::format(
+          "[cpu-mpi] The number of MPI processes must be a power of 2, got {}.",
+          numRanks));
+
+    if (!seedSynchronized) {
+      std::uint64_t seed = randomEngine();
+      checkMpi(mpiInterface->Bcast(comm, &seed, 1, INT_64, 0), "Bcast");
+      randomEngine.seed(seed);
+      seedSynchronized = true;
+    }
+  }
+
+  /// @brief Swap the local slot \p localSlot with the global slot
+  /// \p globalSlot. Only the amplitudes whose bits at the two slots differ
+  /// move: this rank sends the half of its slice whose local bit differs
+  /// from its rank bit to the partner rank across \p globalSlot, and
+  /// receives the matching half of the partner.
+  void swapSlots(std::size_t localSlot, std::size_t globalSlot) {
+    const std::size_t flip = static_cast<std::size_t>(!getRankBit(globalSlot))
+                             << localSlot;
+    const int partner = rank ^ (1ULL << (globalSlot - numLocal));
+    const std::size_t half = state.size() / 2;
+    const std::int64_t chunk = std::min(half, maxMessageSize);
+    DataVector sendBuffer(chunk), recvBuffer(chunk);
+    for (std::size_t begin = 0; begin < half; begin += chunk) {
+#if defined(_OPENMP)
+#pragma omp parallel for if (chunk >= cpu::minParallelDimension)
+#endif
+      for (std::int64_t k = 0; k < chunk; ++k)
+        sendBuffer[k] = state[cpu::insertZeroBit(begin + k, localSlot) | flip];
+      checkMpi(mpiInterface->SendRecvAsync(comm, sendBuffer.data(),
+                                           recvBuffer.data(), chunk,
+                                           mpiAmplitudeType, partner, 0),
+               "SendRecvAsync");
+      checkMpi(mpiInterface->Synchronize(comm), "Synchronize");
+#if defined(_OPENMP)
+#pragma omp parallel for if (chunk >= cpu::minParallelDimension)
+#endif
+      for (std::int64_t k = 0; k < chunk; ++k)
+        state[cpu::insertZeroBit(begin + k, localSlot) | flip] = recvBuffer[k];
+    }
+
+    for (auto &slot : slots)
+      if (slot == localSlot)
+        slot = globalSlot;
+      else if (slot == globalSlot)
+        slot = localSlot;
+  }
+
+  /// @brief Move the \p qubits to local slots, swapping them with the
+  /// highest local slots that hold none of them.
+  void localize(const std::vector<std::size_t> &qubits) {
+    std::size_t busy = 0;
+    for (auto q : qubits)
+      if (slots[q] < numLocal)
+        busy |= 1ULL << slots[q];
+    for (auto q : qubits) {
+      if (slots[q] < numLocal)
+        continue;
+      std::size_t free = numLocal;
+      while (free > 0 && ((busy >> (free - 1)) & 1))
+        --free;
+      if (free == 0)
+        throw std::runtime_error(fmt::format(
+            "[cpu-mpi] {} local qubits are not enough for an operation on {} "
+            "qubits.",
+            numLocal, qubits.size()));
+      swapSlots(free - 1, slots[q]);
+      busy |= 1ULL << slots[q];
+    }
+  }
+
+  /// @brief Return the qubits acted on by X or Y in \p op.
+  static std::vector<std::size_t>
+  getFlippedQubits(const cudaq::spin_op &op,
+                   const std::vector<std::size_t> &qubitIds = {}) {
+    std::vector<std::size_t> qubits;
+    op.for_each_pauli([&](cudaq::pauli type, std::size_t idx) {
+      if (type == cudaq::pauli::X || type == cudaq::pauli::Y)
+        qubits.push_back(qubitIds.empty() ? idx : qubitIds[idx]);
+    });
+    return qubits;
+  }
+
+  /// @brief Return the slots of \p qubitIds, or of all qubits if empty.
+  std::vector<std::size_t>
+  getSlots(const std::vector<std::size_t> &qubitIds) const {
+    if (qubitIds.empty())
+      return slots;
+    std::vector<std::size_t> result;
+    for (auto q : qubitIds)
+      result.push_back(slots[q]);
+    return result;
+  }
+
+  /// @brief Add the last allocated qubits in the state |data> (x) |psi>, or
+  /// |0> (x) |psi> if \p data is null, distributing the state once it
+  /// reaches the threshold.
+  void growState(const Amplitude *data) {
+    if (state.empty())
+      initializeMpi();
+    const std::size_t numQubits = nQubitsAllocated;
+    const std::size_t oldNumQubits = slots.size();
+    const std::size_t count = numQubits - oldNumQubits;
+
+    // New qubits take the next local slots, shifting the global ones up.
+    if (isDistributed()) {
+      for (auto &slot : slots)
+        if (slot >= numLocal)
+          slot += count;
+      for (std::size_t i = 0; i < count; ++i)
+        slots.push_back(numLocal + i);
+      numLocal += count;
+      if (data)
+        Base::kron(data, 1ULL << count);
+      else
+        state.resize(1ULL << numLocal);
+      return;
+    }
+
+    for (std::size_t i = 0; i < count; ++i)
+      slots.push_back(oldNumQubits + i);
+    const std::size_t numRankBits = std::countr_zero(numRanks);
+    if (numRanks == 1 || numQubits < distributionThreshold ||
+        numQubits < numRankBits + minLocalQubits) {
+      Base::addQubitsToState(count, data);
+      return;
+    }
+
+    // Keep the slice of this rank, the qubits being in their own slots.
+    numGlobal = numRankBits;
+    numLocal = numQubits - numGlobal;
+    const std::size_t oldDimension = state.empty() ? 1 : state.size();
+    const std::size_t offset = rank << numLocal;
+    DataVector slice(1ULL << numLocal);
+#if defined(_OPENMP)
+#pragma omp parallel for if (slice.size() >= cpu::minParallelDimension)
+#endif
+    for (std::int64_t i = 0; i < static_cast<std::int64_t>(slice.size());
+         ++i) {
+      const std::size_t index = offset + i;
+      const std::size_t high = index >> oldNumQubits;
+      const Amplitude newAmplitude =
+          data ? data[high] : Amplitude(high == 0 ? 1 : 0);
+      const Amplitude oldAmplitude =
+          state.empty() ? Amplitude(1) : state[index & (oldDimension - 1)];
+      slice[i] = cpu::multiply(newAmplitude, oldAmplitude);
+    }
+    state = std::move(slice);
+    cudaq::info("[cpu-mpi] Distributing {} qubits across {} ranks.",
+                numQubits, numRanks);
+  }
+
+  void addQubitsToState(std::size_t qubitCount,
+                        const void *stateDataIn = nullptr) override {
+    if (qubitCount == 0)
+      return;
+    growState(reinterpret_cast<const Amplitude *>(stateDataIn));
+  }
+
+  void addQubitsToState(const cudaq::SimulationState &in_state) override {
+    if (const auto *casted =
+            dynamic_cast<const CpuState<ScalarType> *>(&in_state))
+      growState(casted->getAmplitudes().data());
+    else
+      growState(getHostAmplitudes<ScalarType>(in_state).data());
+  }
+
+  void deallocateStateImpl() override {
+    Base::deallocateStateImpl();
+    slots.clear();
+    numGlobal = 0;
+    numLocal = 0;
+  }
+
+  void applyGate(const GateApplicationTask &task) override {
+    if (!isDistributed()) {
+      Base::applyGate(task);
+      return;
+    }
+
+    // The swaps are collective, so they come before any rank skips the gate.
+    localize(task.targets);
+    std::vector<std::size_t> controls;
+    for (auto c : task.controls) {
+      if (slots[c] < numLocal)
+        controls.push_back(slots[c]);
+      else if (!getRankBit(slots[c]))
+        return;
+    }
+    cpu::applyMatrix(state.data(), state.size(), task.matrix, controls,
+                     getSlots(task.targets));
+  }
+
+  void setToZeroState() override {
+    if (!isDistributed()) {
+      Base::setToZeroState();
+      return;
+    }
+    cpu::setZeroState(state.data(), state.size());
+    if (rank != 0)
+      state[0] = 0;
+  }
+
+  bool measureQubit(const std::size_t index) override {
+    if (!isDistributed())
+      return Base::measureQubit(index);
+
+    const std::size_t slot = slots[index];
+    const bool isLocal = slot < numLocal;
+    double probOne = 0.0;
+    if (isLocal)
+      probOne = cpu::probability(state.data(), state.size(), 1ULL << slot,
+                                 1ULL << slot);
+    else if (getRankBit(slot))
+      probOne = cpu::probability(state.data(), state.size(), 0, 0);
+    probOne = allReduceSum(probOne);
+
+    const bool result =
+        std::uniform_real_distribution<double>(0.0, 1.0)(randomEngine) <
+        probOne;
+    const double scale = 1.0 / std::sqrt(result ? probOne : 1.0 - probOne);
+    if (isLocal) {
+      cpu::collapse(state.data(), state.size(), slot, result, scale);
+    } else {
+      const ScalarType factor = getRankBit(slot) == result ? scale : 0.0;
+#if defined(_OPENMP)
+#pragma omp parallel for if (state.size() >= cpu::minParallelDimension)
+#endif
+      for (std::int64_t i = 0; i < static_cast<std::int64_t>(state.size());
+           ++i)
+        state[i] *= factor;
+    }
+    cudaq::info("Measured qubit {} -> {}", index, result);
+    return result;
+  }
+
+  /// @brief Gather the full state vector on every rank, in qubit order.
+  DataVector gatherState() const {
+    const std::size_t size = state.size();
+    DataVector gathered(size * numRanks);
+    // The slices are gathered in chunks, as MPI counts are 32-bit integers.
+    const std::size_t chunk = std::min(size, maxMessageSize);
+    DataVector buffer(chunk * numRanks);
+    for (std::size_t begin = 0; begin < size; begin += chunk) {
+      checkMpi(mpiInterface->Allgather(comm, state.data() + begin,
+                                       buffer.data(), chunk, mpiAmplitudeType),
+               "Allgather");
+      for (std::size_t r = 0; r < numRanks; ++r)
+        std::copy_n(buffer.begin() + r * chunk, chunk,
+                    gathered.begin() + r * size + begin);
+    }
+    bool isIdentity = true;
+    for (std::size_t q = 0; q < slots.size(); ++q)
+      isIdentity = isIdentity && slots[q] == q;
+    if (isIdentity)
+      return gathered;
+
+    DataVector result(gathered.size());
+#if defined(_OPENMP)
+#pragma omp parallel for if (result.size() >= cpu::minParallelDimension)
+#endif
+    for (std::int64_t i = 0; i < static_cast<std::int64_t>(result.size());
+         ++i) {
+      std::size_t index = 0;
+      for (std::size_t q = 0; q < slots.size(); ++q)
+        index |= ((static_cast<std::size_t>(i) >> slots[q]) & 1) << q;
+      result[index] = gathered[i];
+    }
+    return result;
+  }
+
+public:
+  CpuMpiCircuitSimulator() {
+    if (auto *threshEnvVar = std::getenv("CUDAQ_CPU_MPI_NQUBITS_THRESH")) {
+      const std::string threshStr(threshEnvVar);
+      const char *nptr = threshStr.data();
+      char *endptr = nullptr;
+      errno = 0; // reset errno to 0 before call
+      const auto thresh = strtol(nptr, &endptr, 10);
+      if (nptr == endptr || errno != 0 || thresh < 1)
+        throw std::runtime_error(
+            "Invalid CUDAQ_CPU_MPI_NQUBITS_THRESH setting. Expected a "
+            "positive number. Got: " +
+            threshStr);
+      distributionThreshold = thresh;
+      cudaq::info("Setting the state vector distribution threshold to {} "
+                  "qubits.",
+                  distributionThreshold);
+    }
+    summaryData.name = name();
+  }
+  virtual ~CpuMpiCircuitSimulator() = default;
+
+  /// @brief Set the seed, which must be the same on all ranks.
+  void setRandomSeed(std::size_t seed) override {
+    Base::setRandomSeed(seed);
+    seedSynchronized = true;
+  }
+
+  /// @brief Compute <psi|H|psi> term by term from the slices. The qubits
+  /// flipped by a term are made local first, so that the Z operators on
+  /// global slots are just a sign on each rank.
+  cudaq::observe_result observe(const cudaq::spin_op &op) override {
+    if (!isDistributed())
+      return Base::observe(op);
+
+    flushGateQueue();
+    double ee = 0.0;
+    op.for_each_term([&](cudaq::spin_op &term) {
+      localize(getFlippedQubits(term));
+      const auto masks = cpu::getPauliMasks(term, slots);
+      const std::size_t localMask = state.size() - 1;
+      const double sign =
+          std::popcount(rank & (masks.zMask >> numLocal)) % 2 ? -1.0 : 1.0;
+      ee += sign * term.get_coefficient().real() *
+            cpu::expectationPauli(state.data(), state.size(), masks.xMask,
+                                  masks.zMask & localMask, masks.nY);
+    });
+    ee = allReduceSum(ee);
+    return cudaq::observe_result(ee, op,
+                                 cudaq::sample_result(cudaq::ExecutionResult(
+                                     {}, op.to_string(false), ee)));
+  }
+
+  /// @brief Apply exp(i theta P) to the slices. With the flipped qubits made
+  /// local, the Z operators on global slots negate theta on the ranks whose
+  /// bits have an odd parity.
+  void applyExpPauli(double theta, const std::vector<std::size_t> &controls,
+                     const std::vector<std::size_t> &qubitIds,
+                     const cudaq::spin_op &op) override {
+    if (!isDistributed() || op.is_identity() ||
+        (executionContext && (executionContext->name == "tracer" ||
+                              executionContext->noiseModel))) {
+      Base::applyExpPauli(theta, controls, qubitIds, op);
+      return;
+    }
+
+    flushGateQueue();
+    cudaq::info(" [{}] exp_pauli({}, {})", this->name(), theta,
+                op.to_string(false));
+    localize(getFlippedQubits(op, qubitIds));
+    std::size_t controlMask = 0;
+    bool isActive = true;
+    for (auto c : controls) {
+      if (slots[c] < numLocal)
+        controlMask |= 1ULL << slots[c];
+      else
+        isActive = isActive && getRankBit(slots[c]);
+    }
+    const auto masks = cpu::getPauliMasks(op, getSlots(qubitIds));
+    if (summaryData.enabled)
+      summaryData.svGateUpdate(controls.size(),
+                               std::popcount(masks.xMask | masks.zMask),
+                               state.size(),
+                               state.size() * sizeof(Amplitude));
+    if (!isActive)
+      return;
+    const double sign =
+        std::popcount(rank & (masks.zMask >> numLocal)) % 2 ? -1.0 : 1.0;
+    cpu::applyExpPauli(state.data(), state.size(), sign * theta, masks.xMask,
+                       masks.zMask & (state.size() - 1), masks.nY,
+                       controlMask);
+  }
+
+  /// @brief Reset the qubit to |0>.
+  void resetQubit(const std::size_t index) override {
+    flushGateQueue();
+    flushAnySamplingTasks();
+    if (measureQubit(index))
+      applyGate(GateApplicationTask("x", {0, 1, 1, 0}, {}, {index}, {}));
+  }
+
+  /// @brief Sample the multi-qubit state. Every rank draws the same sorted
+  /// samples of the full distribution, resolves those falling in its slice,
+  /// and the outcomes are then summed across ranks.
+  cudaq::ExecutionResult sample(const std::vector<std::size_t> &qubits,
+                                const int shots) override {
+    if (!isDistributed())
+      return Base::sample(qubits, shots);
+
+    const std::size_t localDimension = state.size();
+    if (shots < 1) {
+      std::size_t zMask = 0;
+      for (auto q : qubits)
+        zMask |= 1ULL << slots[q];
+      const double sign =
+          std::popcount(rank & (zMask >> numLocal)) % 2 ? -1.0 : 1.0;
+      const double expectationValue = allReduceSum(
+          sign * cpu::expectationZ(state.data(), localDimension,
+                                   zMask & (localDimension - 1)));
+      cudaq::info("Computed expectation value = {}", expectationValue);
+      return cudaq::ExecutionResult{{}, expectationValue};
+    }
+
+    const double localTotal =
+        cpu::probability(state.data(), localDimension, 0, 0);
+    std::vector<double> starts(numRanks + 1, 0.0);
+    checkMpi(mpiInterface->Allgather(comm, &localTotal, starts.data() + 1, 1,
+                                     FLOAT_64),
+             "Allgather");
+    std::partial_sum(starts.begin(), starts.end(), starts.begin());
+    std::uniform_real_distribution<double> uniform(0.0, starts.back());
+    std::vector<double> draws(shots);
+    for (auto &draw : draws)
+      draw = uniform(randomEngine);
+    std::sort(draws.begin(), draws.end());
+
+    // The last rank with a non-zero probability also takes the draws past
+    // the total due to rounding.
+    std::size_t lastRank = numRanks - 1;
+    while (lastRank > 0 && starts[lastRank + 1] == starts[lastRank])
+      --lastRank;
+    auto first = draws.end(), last = draws.end();
+    if (rank <= lastRank) {
+      first = std::lower_bound(draws.begin(), draws.end(), starts[rank]);
+      if (rank < lastRank)
+        last = std::lower_bound(first, draws.end(), starts[rank + 1]);
+    }
+
+    // Pack the measured bits of each outcome, bit k being `qubits[k]`.
+    static_assert(sizeof(std::size_t) == sizeof(std::int64_t));
+    std::vector<std::size_t> outcomes(shots, 0);
+    if (first != last) {
+      const auto indices =
+          cpu::resolveDraws(state.data(), localDimension,
+                            std::vector<double>(first, last), starts[rank]);
+      const std::size_t offset = first - draws.begin();
+      for (std::size_t d = 0; d < indices.size(); ++d) {
+        const std::size_t index = indices[d] | (rank << numLocal);
+        std::size_t packed = 0;
+        for (std::size_t k = 0; k < qubits.size(); ++k)
+          packed |= ((index >> slots[qubits[k]]) & 1) << k;
+        outcomes[offset + d] = packed;
+      }
+    }
+    checkMpi(mpiInterface->AllreduceInPlace(comm, outcomes.data(), shots,
+                                            INT_64, SUM),
+             "AllreduceInPlace");
+    return cpu::countOutcomes(outcomes, qubits.size());
+  }
+
+  /// @brief Return the state, gathered on every rank if distributed.
+  std::unique_ptr<cudaq::SimulationState> getSimulationState() override {
+    if (!isDistributed())
+      return Base::getSimulationState();
+    flushGateQueue();
+    return std::make_unique<CpuState<ScalarType>>(gatherState());
+  }
+
+  /// @brief Primarily used for testing.
+  DataVector getStateVector() {
+    flushGateQueue();
+    return isDistributed() ? gatherState() : state;
+  }
+
+  /// @brief Return true if the state is currently distributed.
+  bool isStateDistributed() const { return isDistributed(); }
+
+  std::string name() const override { return "cpu-mpi"; }
+  NVQIR_SIMULATOR_CLONE_IMPL(CpuMpiCircuitSimulator<ScalarType>)
+};
+
+} // namespace nvqir
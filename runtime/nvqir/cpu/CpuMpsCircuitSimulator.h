@@ -0,0 +1,736 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CpuCircuitSimulator.h"
+
+#include <Eigen/Dense>
+#include <Eigen/SVD>
+
+namespace nvqir {
+
+/// @brief Truncation settings of the matrix product state. They are read
+/// from the same environment variables as the `tensornet-mps` target.
+struct CpuMpsSettings {
+  // Default max bond dim
+  int64_t maxBond = 64;
+  // Default absolute cutoff
+  double absCutoff = 1e-5;
+  // Default relative cutoff
+  double relCutoff = 1e-5;
+
+  CpuMpsSettings() {
+    if (auto *maxBondEnvVar = std::getenv("CUDAQ_MPS_MAX_BOND")) {
+      const std::string maxBondStr(maxBondEnvVar);
+      const char *nptr = maxBondStr.data();
+      char *endptr = nullptr;
+      errno = 0; // reset errno to 0 before call
+      maxBond = strtol(nptr, &endptr, 10);
+
+      if (nptr == endptr || errno != 0 || maxBond < 1)
+        throw std::runtime_error("Invalid CUDAQ_MPS_MAX_BOND setting. "
+                                 "Expected a positive number. Got: " +
+                                 maxBondStr);
+
+      cudaq::info("Setting MPS max bond dimension to {}.", maxBond);
+    }
+    // Cutoff values
+    absCutoff = parseCutoff("CUDAQ_MPS_ABS_CUTOFF", absCutoff);
+    relCutoff = parseCutoff("CUDAQ_MPS_RELATIVE_CUTOFF", relCutoff);
+  }
+
+private:
+  static double parseCutoff(const char *envVarName, double defaultValue) {
+    auto *envVar = std::getenv(envVarName);
+    if (!envVar)
+      return defaultValue;
+
+    const std::string cutoffStr(envVar);
+    const char *nptr = cutoffStr.data();
+    char *endptr = nullptr;
+    errno = 0; // reset errno to 0 before call
+    const double cutoff = strtod(nptr, &endptr);
+
+    if (nptr == endptr || errno != 0 || cutoff <= 0.0 || cutoff >= 1.0)
+      throw std::runtime_error(std::string("Invalid ") + envVarName +
+                               " setting. Expected a number in range (0.0, "
+                               "1.0). Got: " +
+                               cutoffStr);
+
+    cudaq::info("Setting {} to {}.", envVarName, cutoff);
+    return cutoff;
+  }
+};
+
+/// @brief The CpuMpsCircuitSimulator is a CPU matrix product state (MPS)
+/// simulator. Each qubit is a site tensor, and the bonds between neighboring
+/// sites are truncated by SVD after every multi-qubit gate, so that circuits
+/// with little entanglement can be simulated on a large number of qubits.
+///
+/// The MPS is kept in mixed canonical form: the sites left of the `center`
+/// are left-orthonormal and the sites right of it right-orthonormal, which
+/// makes the truncations optimal, and lets the measurements and expectation
+/// values only contract the sites they need. Multi-qubit gates are applied
+/// to neighboring sites, the qubits being first moved next to each other by
+/// SWAP gates. The qubits are not moved back, so the qubit to site mapping
+/// is a permutation.
+class CpuMpsCircuitSimulator : public nvqir::CircuitSimulatorBase<double> {
+protected:
+  using Amplitude = std::complex<double>;
+  using RowMatrix = Eigen::Matrix<Amplitude, Eigen::Dynamic, Eigen::Dynamic,
+                                  Eigen::RowMajor>;
+  using MatrixMap = Eigen::Map<RowMatrix>;
+  using ConstMatrixMap = Eigen::Map<const RowMatrix>;
+  using SliceMap = Eigen::Map<const RowMatrix, 0, Eigen::OuterStride<>>;
+
+  /// @brief A site tensor, with element (l, p, r) at `(l * 2 + p) * right +
+  /// r`. It is both the row-major (2 left, right) and (left, 2 right) matrix.
+  struct Site {
+    std::size_t left = 1;
+    std::size_t right = 1;
+    std::vector<Amplitude> data = {1.0, 0.0};
+  };
+
+  /// @brief The site tensors.
+  std::vector<Site> sites;
+
+  /// @brief The site of each qubit, and the qubit of each site.
+  std::vector<std::size_t> siteOf;
+  std::vector<std::size_t> qubitAt;
+
+  /// @brief The orthogonality center of the MPS.
+  std::size_t center = 0;
+
+  /// @brief The bond truncation settings.
+  CpuMpsSettings settings;
+
+  /// @brief Random number generator for measurements and sampling.
+  std::mt19937_64 randomEngine;
+
+  /// @brief Shots sampled with the same random number generator. Each block
+  /// of shots has its own generator, so that the samples do not depend on
+  /// the number of threads.
+  static constexpr std::size_t shotsPerBlock = 64;
+
+  /// @brief The largest number of qubits of a contracted state vector, which
+  /// takes 64 GB.
+  static constexpr std::size_t maxStateVectorQubits = 32;
+
+  /// @brief Return the (left, right) matrix of the physical index \p p of
+  /// the \p site.
+  static SliceMap slice(const Site &site, std::size_t p) {
+    return SliceMap(site.data.data() + p * site.right, site.left, site.right,
+                    Eigen::OuterStride<>(2 * site.right));
+  }
+
+  /// @brief Move the orthogonality center to the \p target site, by QR
+  /// decompositions of the sites in between.
+  void moveCenter(std::size_t target) {
+    for (; center < target; ++center) {
+      auto &site = sites[center];
+      auto &next = sites[center + 1];
+      Eigen::HouseholderQR<RowMatrix> qr(
+          ConstMatrixMap(site.data.data(), 2 * site.left, site.right));
+      const std::size_t bond = std::min(2 * site.left, site.right);
+      RowMatrix q =
+          qr.householderQ() * RowMatrix::Identity(2 * site.left, bond);
+      RowMatrix r = qr.matrixQR().topRows(bond);
+      r.triangularView<Eigen::StrictlyLower>().setZero();
+      RowMatrix product =
+          r * ConstMatrixMap(next.data.data(), next.left, 2 * next.right);
+      site.right = bond;
+      site.data.assign(q.data(), q.data() + q.size());
+      next.left = bond;
+      next.data.assign(product.data(), product.data() + product.size());
+    }
+    for (; center > target; --center) {
+      // LQ decomposition, from the QR decomposition of the adjoint.
+      auto &site = sites[center];
+      auto &previous = sites[center - 1];
+      Eigen::HouseholderQR<RowMatrix> qr(
+          ConstMatrixMap(site.data.data(), site.left, 2 * site.right)
+              .adjoint());
+      const std::size_t bond = std::min(site.left, 2 * site.right);
+      RowMatrix q =
+          (qr.householderQ() * RowMatrix::Identity(2 * site.right, bond))
+              .adjoint();
+      RowMatrix r = qr.matrixQR().topRows(bond);
+      r.triangularView<Eigen::StrictlyLower>().setZero();
+      RowMatrix product = ConstMatrixMap(previous.data.data(),
+                                         2 * previous.left, previous.right) *
+                          r.adjoint();
+      site.left = bond;
+      site.data.assign(q.data(), q.data() + q.size());
+      previous.right = bond;
+      previous.data.assign(product.data(), product.data() + product.size());
+    }
+  }
+
+  /// @brief Move the orthogonality center to the closest site from \p first
+  /// to \p last, if it is not already one of them.
+  void moveCenterInto(std::size_t first, std::size_t last) {
+    if (center < first)
+      moveCenter(first);
+    else if (center > last)
+      moveCenter(last);
+  }
+
+  /// @brief Contract the \p count sites from \p first into a single tensor,
+  /// with element (l, s, r) at `(l * 2^count + s) * right + r`. The first
+  /// site is the most significant bit of s.
+  std::vector<Amplitude> contract(std::size_t first, std::size_t count) const {
+    std::vector<Amplitude> theta = sites[first].data;
+    std::size_t rows = 2 * sites[first].left;
+    for (std::size_t s = first + 1; s < first + count; ++s) {
+      const auto &site = sites[s];
+      std::vector<Amplitude> next(rows * 2 * site.right);
+      MatrixMap(next.data(), rows, 2 * site.right).noalias() =
+          ConstMatrixMap(theta.data(), rows, site.left) *
+          ConstMatrixMap(site.data.data(), site.left, 2 * site.right);
+      theta = std::move(next);
+      rows *= 2;
+    }
+    return theta;
+  }
+
+  /// @brief Split the contracted \p theta back into the \p count sites from
+  /// \p first, by truncated SVDs from left to right. The orthogonality
+  /// center, which must be in the block, ends up on its last site, or on the
+  /// one before if \p absorbLeft, which saves a QR decomposition when the
+  /// next operation is on the left.
+  void split(std::size_t first, std::size_t count,
+             std::vector<Amplitude> theta, bool absorbLeft = false) {
+    std::size_t left = sites[first].left;
+    for (std::size_t s = first; s + 1 < first + count; ++s) {
+      const std::size_t rows = 2 * left;
+      const std::size_t cols = theta.size() / rows;
+      Eigen::BDCSVD<Eigen::MatrixXcd> svd(
+          ConstMatrixMap(theta.data(), rows, cols),
+          Eigen::ComputeThinU | Eigen::ComputeThinV);
+      const auto &values = svd.singularValues();
+      const std::size_t bond = truncatedBond(values);
+
+      // Keep the norm of the state, which is that of the center.
+      const double scale =
+          std::sqrt(values.squaredNorm() / values.head(bond).squaredNorm());
+      const Eigen::VectorXcd singular =
+          (scale * values.head(bond)).cast<Amplitude>();
+      RowMatrix u = svd.matrixU().leftCols(bond);
+      theta.resize(bond * cols);
+      MatrixMap v(theta.data(), bond, cols);
+      v.noalias() = svd.matrixV().leftCols(bond).adjoint();
+      if (absorbLeft && s + 2 == first + count)
+        u = u * singular.asDiagonal();
+      else
+        v = singular.asDiagonal() * v;
+
+      auto &site = sites[s];
+      site.left = left;
+      site.right = bond;
+      site.data.assign(u.data(), u.data() + u.size());
+      left = bond;
+    }
+    auto &last = sites[first + count - 1];
+    last.left = left;
+    last.right = theta.size() / (2 * left);
+    last.data = std::move(theta);
+    center = absorbLeft ? first + count - 2 : first + count - 1;
+  }
+
+  /// @brief Return the number of the sorted singular \p values to keep.
+  std::size_t truncatedBond(const Eigen::VectorXd &values) const {
+    const double cutoff =
+        std::max(settings.absCutoff, settings.relCutoff * values[0]);
+    std::size_t bond = 1;
+    while (bond < static_cast<std::size_t>(values.size()) &&
+           bond < static_cast<std::size_t>(settings.maxBond) &&
+           values[bond] > cutoff)
+      ++bond;
+    return bond;
+  }
+
+  /// @brief Apply the row-major 2x2 \p matrix to the physical index of the
+  /// \p site.
+  void applySiteMatrix(Site &site, const Amplitude *matrix) {
+    for (std::size_t l = 0; l < site.left; ++l) {
+      Amplitude *lo = site.data.data() + 2 * l * site.right;
+      Amplitude *hi = lo + site.right;
+      for (std::size_t r = 0; r < site.right; ++r) {
+        const Amplitude a = lo[r], b = hi[r];
+        lo[r] = matrix[0] * a + matrix[1] * b;
+        hi[r] = matrix[2] * a + matrix[3] * b;
+      }
+    }
+  }
+
+  /// @brief Apply the row-major \p matrix to the physical indices of the
+  /// contracted \p theta, for each of its \p left indices.
+  void applyBlockMatrix(std::vector<Amplitude> &theta, std::size_t left,
+                        const RowMatrix &matrix) {
+    const std::size_t blockSize = theta.size() / left;
+    const std::size_t rows = matrix.rows();
+#if defined(_OPENMP)
+#pragma omp parallel for if (theta.size() >= cpu::minParallelDimension)
+#endif
+    for (std::int64_t l = 0; l < static_cast<std::int64_t>(left); ++l) {
+      MatrixMap block(theta.data() + l * blockSize, rows, blockSize / rows);
+      block = matrix * block;
+    }
+  }
+
+  /// @brief Swap the qubits of the \p site and the next one, leaving the
+  /// orthogonality center on the \p site.
+  void swapSites(std::size_t site) {
+    moveCenterInto(site, site + 1);
+    auto theta = contract(site, 2);
+    // Swap the physical indices 01 and 10, i.e. rows 1 and 2 of each block.
+    const std::size_t right = sites[site + 1].right;
+    for (std::size_t l = 0; l < sites[site].left; ++l)
+      std::swap_ranges(theta.begin() + (4 * l + 1) * right,
+                       theta.begin() + (4 * l + 2) * right,
+                       theta.begin() + (4 * l + 2) * right);
+    split(site, 2, std::move(theta), /*absorbLeft=*/true);
+    std::swap(qubitAt[site], qubitAt[site + 1]);
+    siteOf[qubitAt[site]] = site;
+    siteOf[qubitAt[site + 1]] = site + 1;
+  }
+
+  /// @brief Move the \p qubits to neighboring sites, and return the first.
+  std::size_t gather(std::vector<std::size_t> qubits) {
+    std::sort(qubits.begin(), qubits.end(), [&](auto a, auto b) {
+      return siteOf[a] < siteOf[b];
+    });
+    const std::size_t first = siteOf[qubits[0]];
+    for (std::size_t k = 1; k < qubits.size(); ++k)
+      while (siteOf[qubits[k]] > first + k)
+        swapSites(siteOf[qubits[k]] - 1);
+    return first;
+  }
+
+  /// @brief Apply the gate on neighboring sites, moving the qubits there
+  /// first if needed.
+  void applyGate(const GateApplicationTask &task) override {
+    if (task.controls.empty() && task.targets.size() == 1) {
+      applySiteMatrix(sites[siteOf[task.targets[0]]], task.matrix.data());
+      return;
+    }
+
+    std::vector<std::size_t> qubits(task.controls);
+    qubits.insert(qubits.end(), task.targets.begin(), task.targets.end());
+    const std::size_t first = gather(qubits);
+    const std::size_t count = qubits.size();
+
+    // Expand the controlled matrix over the sites of the block. Bit k of the
+    // target index is `targets[k]`, see `cpu::applyMatrix`.
+    const std::size_t dim = 1ULL << count;
+    std::vector<std::size_t> targetIndex(dim, 0), controlBits(dim, 0);
+    for (std::size_t s = 0; s < dim; ++s) {
+      const auto bit = [&](std::size_t q) -> std::size_t {
+        return (s >> (count - 1 - (siteOf[q] - first))) & 1;
+      };
+      for (std::size_t k = 0; k < task.targets.size(); ++k)
+        targetIndex[s] |= bit(task.targets[k]) << k;
+      for (std::size_t k = 0; k < task.controls.size(); ++k)
+        controlBits[s] |= bit(task.controls[k]) << k;
+    }
+    const std::size_t allControls = (1ULL << task.controls.size()) - 1;
+    const std::size_t numTargetRows = 1ULL << task.targets.size();
+    RowMatrix matrix = RowMatrix::Zero(dim, dim);
+    for (std::size_t row = 0; row < dim; ++row)
+      for (std::size_t col = 0; col < dim; ++col) {
+        if (controlBits[row] != controlBits[col])
+          continue;
+        if (controlBits[row] == allControls)
+          matrix(row, col) =
+              task.matrix[targetIndex[row] * numTargetRows + targetIndex[col]];
+        else if (targetIndex[row] == targetIndex[col])
+          matrix(row, col) = 1.0;
+      }
+
+    moveCenterInto(first, first + count - 1);
+    auto theta = contract(first, count);
+    applyBlockMatrix(theta, sites[first].left, matrix);
+    split(first, count, std::move(theta));
+  }
+
+  /// @brief A Pauli operator on a site.
+  using SitePauli = std::pair<std::size_t, cudaq::pauli>;
+
+  /// @brief The contractions of the sites with their adjoints, from the
+  /// orthogonality center to each site, which are shared by the expectation
+  /// values of all the terms.
+  struct Environments {
+    /// The left environments of the sites right of the center.
+    std::vector<RowMatrix> left;
+    /// The right environments of the sites left of the center.
+    std::vector<RowMatrix> right;
+  };
+
+  /// @brief Compute the environments of the sites from \p lo to \p hi.
+  Environments computeEnvironments(std::size_t lo, std::size_t hi) const {
+    Environments envs;
+    envs.left.resize(std::max(hi, center) + 1);
+    envs.left[center] =
+        RowMatrix::Identity(sites[center].left, sites[center].left);
+    for (std::size_t s = center; s < hi; ++s) {
+      envs.left[s + 1] = RowMatrix::Zero(sites[s].right, sites[s].right);
+      for (std::size_t p = 0; p < 2; ++p)
+        envs.left[s + 1].noalias() +=
+            slice(sites[s], p).adjoint() * envs.left[s] * slice(sites[s], p);
+    }
+    envs.right.resize(center + 1);
+    envs.right[center] =
+        RowMatrix::Identity(sites[center].right, sites[center].right);
+    for (std::size_t s = center; s > lo; --s) {
+      envs.right[s - 1] = RowMatrix::Zero(sites[s].left, sites[s].left);
+      for (std::size_t p = 0; p < 2; ++p)
+        envs.right[s - 1].noalias() += slice(sites[s], p).conjugate() *
+                                       envs.right[s] *
+                                       slice(sites[s], p).transpose();
+    }
+    return envs;
+  }
+
+  /// @brief Return the expectation value of the product of the \p paulis,
+  /// sorted by site, by contracting only the sites from the first to the
+  /// last Pauli. The sites beyond them are orthonormal and contract to the
+  /// identity, up to the orthogonality center, whose side is given by the
+  /// \p envs.
+  double expectation(const std::vector<SitePauli> &paulis,
+                     const Environments &envs) const {
+    if (paulis.empty())
+      return ConstMatrixMap(sites[center].data.data(), 1,
+                            sites[center].data.size())
+          .squaredNorm();
+
+    const std::size_t first = paulis.front().first;
+    const std::size_t last = paulis.back().first;
+    RowMatrix env =
+        first > center
+            ? envs.left[first]
+            : RowMatrix::Identity(sites[first].left, sites[first].left);
+    auto pauli = paulis.begin();
+    for (std::size_t s = first; s <= last; ++s) {
+      const auto &site = sites[s];
+      cudaq::pauli type = cudaq::pauli::I;
+      if (pauli != paulis.end() && pauli->first == s)
+        type = (pauli++)->second;
+
+      // O|p'> for p' = 0, 1: the row of the result, and its coefficient.
+      std::size_t rows[2] = {0, 1};
+      Amplitude coefficients[2] = {1.0, 1.0};
+      if (type == cudaq::pauli::X || type == cudaq::pauli::Y)
+        std::swap(rows[0], rows[1]);
+      if (type == cudaq::pauli::Y)
+        coefficients[0] = {0.0, 1.0}, coefficients[1] = {0.0, -1.0};
+      if (type == cudaq::pauli::Z)
+        coefficients[1] = -1.0;
+
+      RowMatrix next = RowMatrix::Zero(site.right, site.right);
+      for (std::size_t p = 0; p < 2; ++p)
+        next.noalias() += coefficients[p] * slice(site, rows[p]).adjoint() *
+                          env * slice(site, p);
+      env = std::move(next);
+    }
+    if (last < center)
+      return env.cwiseProduct(envs.right[last]).sum().real();
+    return env.trace().real();
+  }
+
+  /// @brief Set the \p count sites from \p first to the state \p data, in
+  /// which qubit k is bit k of the amplitude index. The sites must have no
+  /// left bond with the previous sites.
+  void setSites(std::size_t first, std::size_t count, const Amplitude *data) {
+    // The first site is the most significant bit of the contracted tensor.
+    std::vector<Amplitude> theta(1ULL << count);
+    for (std::size_t i = 0; i < theta.size(); ++i) {
+      std::size_t index = 0;
+      for (std::size_t k = 0; k < count; ++k)
+        index |= ((i >> (count - 1 - k)) & 1) << k;
+      theta[i] = data[index];
+    }
+
+    // Split the sites, and make them right-orthonormal. The first one then
+    // has a unit norm, and the orthogonality center of the previous sites
+    // is also the center of the whole state.
+    const std::size_t previousCenter = center;
+    split(first, count, std::move(theta));
+    moveCenter(first);
+    if (first > 0)
+      center = previousCenter;
+  }
+
+  /// @brief Grow the MPS by one qubit.
+  void addQubitToState() override { addQubitsToState(1); }
+
+  void addQubitsToState(std::size_t qubitCount,
+                        const void *stateDataIn = nullptr) override {
+    const std::size_t first = sites.size();
+    sites.resize(first + qubitCount);
+    for (std::size_t s = first; s < sites.size(); ++s) {
+      siteOf.push_back(s);
+      qubitAt.push_back(s);
+    }
+    if (stateDataIn && qubitCount > 0)
+      setSites(first, qubitCount,
+               reinterpret_cast<const Amplitude *>(stateDataIn));
+  }
+
+  void addQubitsToState(const cudaq::SimulationState &in_state) override {
+    const auto amplitudes = getHostAmplitudes<double>(in_state);
+    addQubitsToState(std::countr_zero(amplitudes.size()), amplitudes.data());
+  }
+
+  /// @brief The state dimension is the number of sites, rather than the
+  /// number of amplitudes, which would overflow on large numbers of qubits.
+  std::size_t calculateStateDim(const std::size_t numQubits) override {
+    return numQubits;
+  }
+
+  /// @brief Reset the qubit state.
+  void deallocateStateImpl() override {
+    sites.clear();
+    siteOf.clear();
+    qubitAt.clear();
+    center = 0;
+  }
+
+  /// @brief Set the current state back to the |0> state.
+  void setToZeroState() override {
+    for (auto &site : sites)
+      site = Site();
+    std::iota(siteOf.begin(), siteOf.end(), 0);
+    std::iota(qubitAt.begin(), qubitAt.end(), 0);
+    center = 0;
+  }
+
+  /// @brief Measure the qubit and collapse its site, which becomes the
+  /// orthogonality center.
+  bool measureQubit(const std::size_t index) override {
+    const std::size_t s = siteOf[index];
+    moveCenter(s);
+    auto &site = sites[s];
+    const double total = ConstMatrixMap(site.data.data(), 1, site.data.size())
+                             .squaredNorm();
+    const double probOne = slice(site, 1).squaredNorm() / total;
+    const bool result =
+        std::uniform_real_distribution<double>(0.0, 1.0)(randomEngine) <
+        probOne;
+    const double scale =
+        1.0 / std::sqrt(total * (result ? probOne : 1.0 - probOne));
+    for (std::size_t l = 0; l < site.left; ++l)
+      for (std::size_t p = 0; p < 2; ++p)
+        for (std::size_t r = 0; r < site.right; ++r) {
+          auto &element = site.data[(2 * l + p) * site.right + r];
+          element = p == result ? element * scale : 0.0;
+        }
+    cudaq::info("Measured qubit {} -> {}", index, result);
+    return result;
+  }
+
+  /// @brief Contract the state vector, in which qubit q is bit q of the
+  /// amplitude index.
+  std::vector<Amplitude> contractStateVector() const {
+    if (sites.empty())
+      return {};
+    const std::size_t count = sites.size();
+    if (count > maxStateVectorQubits)
+      throw std::runtime_error(fmt::format(
+          "[cpu-mps] Cannot contract the state vector of {} qubits, the "
+          "limit is {} qubits.",
+          count, maxStateVectorQubits));
+    const auto theta = contract(0, count);
+    std::vector<Amplitude> result(theta.size());
+    for (std::size_t i = 0; i < theta.size(); ++i) {
+      std::size_t index = 0;
+      for (std::size_t q = 0; q < count; ++q)
+        index |= ((i >> (count - 1 - siteOf[q])) & 1) << q;
+      result[index] = theta[i];
+    }
+    return result;
+  }
+
+public:
+  CpuMpsCircuitSimulator() {
+    // Populate the correct name so it is printed correctly during
+    // deconstructor.
+    summaryData.name = name();
+    std::random_device randomDevice;
+    randomEngine = std::mt19937_64(randomDevice());
+  }
+  virtual ~CpuMpsCircuitSimulator() = default;
+
+  void setRandomSeed(std::size_t seed) override {
+    randomEngine = std::mt19937_64(seed);
+  }
+
+  bool canHandleObserve() override {
+    // Do not compute <H> from the state if shots based sampling requested
+    if (executionContext &&
+        executionContext->shots != static_cast<std::size_t>(-1)) {
+      return false;
+    }
+
+    return !shouldObserveFromSampling();
+  }
+
+  /// @brief Compute <psi|H|psi> term by term, contracting for each term only
+  /// the sites between its first and last Paulis. The terms are computed in
+  /// parallel.
+  cudaq::observe_result observe(const cudaq::spin_op &op) override {
+    flushGateQueue();
+    std::vector<double> coefficients;
+    std::vector<std::vector<SitePauli>> terms;
+    std::size_t lo = center, hi = center;
+    op.for_each_term([&](cudaq::spin_op &term) {
+      coefficients.push_back(term.get_coefficient().real());
+      auto &paulis = terms.emplace_back();
+      term.for_each_pauli([&](cudaq::pauli type, std::size_t idx) {
+        if (type != cudaq::pauli::I)
+          paulis.emplace_back(siteOf[idx], type);
+      });
+      std::sort(paulis.begin(), paulis.end(),
+                [](auto &a, auto &b) { return a.first < b.first; });
+      if (!paulis.empty()) {
+        lo = std::min(lo, paulis.front().first);
+        hi = std::max(hi, paulis.back().first);
+      }
+    });
+
+    const auto envs = computeEnvironments(lo, hi);
+    double ee = 0.0;
+#if defined(_OPENMP)
+#pragma omp parallel for reduction(+ : ee) schedule(dynamic)
+#endif
+    for (std::int64_t t = 0; t < static_cast<std::int64_t>(terms.size()); ++t)
+      ee += coefficients[t] * expectation(terms[t], envs);
+    return cudaq::observe_result(ee, op,
+                                 cudaq::sample_result(cudaq::ExecutionResult(
+                                     {}, op.to_string(false), ee)));
+  }
+
+  /// @brief Reset the qubit to |0>.
+  void resetQubit(const std::size_t index) override {
+    flushGateQueue();
+    flushAnySamplingTasks();
+    const Amplitude xMatrix[] = {0, 1, 1, 0};
+    if (measureQubit(index))
+      applySiteMatrix(sites[siteOf[index]], xMatrix);
+  }
+
+  /// @brief Sample the measured qubits from the conditional probabilities of
+  /// each site given the previous ones, the shots being sampled in parallel.
+  cudaq::ExecutionResult sample(const std::vector<std::size_t> &qubits,
+                                const int shots) override {
+    if (shots < 1) {
+      std::vector<SitePauli> paulis;
+      for (auto q : qubits)
+        paulis.emplace_back(siteOf[q], cudaq::pauli::Z);
+      std::sort(paulis.begin(), paulis.end(),
+                [](auto &a, auto &b) { return a.first < b.first; });
+      const double expectationValue =
+          paulis.empty() ? 1.0
+                         : expectation(paulis, computeEnvironments(
+                                                   paulis.front().first,
+                                                   paulis.back().first));
+      cudaq::info("Computed expectation value = {}", expectationValue);
+      return cudaq::ExecutionResult{{}, expectationValue};
+    }
+
+    // The sites right of the last measured one are right-orthonormal once
+    // the center is on the first site, and need not be sampled.
+    moveCenter(0);
+    std::vector<std::int64_t> bitOfSite(sites.size(), -1);
+    std::size_t numSampledSites = 0;
+    for (std::size_t k = 0; k < qubits.size(); ++k) {
+      bitOfSite[siteOf[qubits[k]]] = k;
+      numSampledSites = std::max(numSampledSites, siteOf[qubits[k]] + 1);
+    }
+
+    const std::size_t numBlocks = (shots + shotsPerBlock - 1) / shotsPerBlock;
+    std::vector<std::uint64_t> seeds(numBlocks);
+    for (auto &seed : seeds)
+      seed = randomEngine();
+    std::vector<std::string> outcomes(shots, std::string(qubits.size(), '0'));
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (std::int64_t b = 0; b < static_cast<std::int64_t>(numBlocks); ++b) {
+      std::mt19937_64 engine(seeds[b]);
+      std::uniform_real_distribution<double> uniform(0.0, 1.0);
+      const std::size_t end =
+          std::min<std::size_t>(shots, (b + 1) * shotsPerBlock);
+      // The left environment of the next site, given the sampled bits.
+      Eigen::RowVectorXcd env, zero, one;
+      for (std::size_t shot = b * shotsPerBlock; shot < end; ++shot) {
+        env = Eigen::RowVectorXcd::Ones(1);
+        for (std::size_t s = 0; s < numSampledSites; ++s) {
+          zero.noalias() = env * slice(sites[s], 0);
+          one.noalias() = env * slice(sites[s], 1);
+          const double probZero = zero.squaredNorm();
+          const double probOne = one.squaredNorm();
+          const bool bit = uniform(engine) * (probZero + probOne) < probOne;
+          env.swap(bit ? one : zero);
+          env /= std::sqrt(bit ? probOne : probZero);
+          if (bit && bitOfSite[s] >= 0)
+            outcomes[shot][bitOfSite[s]] = '1';
+        }
+      }
+    }
+
+    double expVal = 0.0;
+    for (const auto &outcome : outcomes)
+      expVal += std::count(outcome.begin(), outcome.end(), '1') % 2 == 0
+                    ? 1.0
+                    : -1.0;
+    std::sort(outcomes.begin(), outcomes.end());
+    cudaq::ExecutionResult counts;
+    for (auto first = outcomes.begin(); first != outcomes.end();) {
+      const auto last = std::upper_bound(first, outcomes.end(), *first);
+      counts.appendResult(*first, last - first);
+      first = last;
+    }
+    counts.expectationValue = expVal / shots;
+    return counts;
+  }
+
+  /// @brief Create a state from the data without contracting the current
+  /// one.
+  std::unique_ptr<cudaq::SimulationState>
+  createStateFromData(const cudaq::state_data &data) override {
+    return CpuState<double>(std::vector<Amplitude>{}).createFromData(data);
+  }
+
+  /// @brief Return the contracted state vector, of at most
+  /// `maxStateVectorQubits` qubits.
+  std::unique_ptr<cudaq::SimulationState> getSimulationState() override {
+    flushGateQueue();
+    return std::make_unique<CpuState<double>>(contractStateVector());
+  }
+
+  /// @brief Primarily used for testing.
+  std::vector<Amplitude> getStateVector() {
+    flushGateQueue();
+    return contractStateVector();
+  }
+
+  /// @brief Return the largest bond dimension of the MPS.
+  std::size_t getMaxBondDimension() {
+    flushGateQueue();
+    std::size_t maxBond = 1;
+    for (const auto &site : sites)
+      maxBond = std::max(maxBond, site.right);
+    return maxBond;
+  }
+
+  std::string name() const override { return "cpu-mps"; }
+  NVQIR_SIMULATOR_CLONE_IMPL(CpuMpsCircuitSimulator)
+};
+
+} // namespace nvqir
@@ -0,0 +1,12 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "CpuOutOfCoreCircuitSimulator.h"
+
+/// Register this Simulator with NVQIR.
+NVQIR_REGISTER_SIMULATOR(nvqir::CpuOutOfCoreCircuitSimulator, cpu_ooc)
@@ -0,0 +1,587 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CpuCircuitSimulator.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <optional>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace nvqir {
+
+/// @brief Double precision amplitudes stored in a memory mapped temporary
+/// file. The file is unlinked as soon as it is created, so that it goes away
+/// with the mapping, whatever happens to the process.
+class MappedAmplitudes {
+public:
+  using Amplitude = std::complex<double>;
+
+  MappedAmplitudes() = default;
+  MappedAmplitudes(const MappedAmplitudes &) = delete;
+  MappedAmplitudes &operator=(const MappedAmplitudes &) = delete;
+  ~MappedAmplitudes() { release(); }
+
+  Amplitude *data() { return amplitudes; }
+  const Amplitude *data() const { return amplitudes; }
+  std::size_t size() const { return numAmplitudes; }
+  bool empty() const { return numAmplitudes == 0; }
+
+  /// @brief Resize the file to \p newSize amplitudes, creating it in
+  /// \p directory if needed. The new amplitudes are zero.
+  void resize(std::size_t newSize, const std::filesystem::path &directory) {
+    if (fd < 0) {
+      std::string path = (directory / "cudaq-state-XXXXXX").string();
+      fd = mkstemp(path.data());
+      if (fd < 0)
+        throw std::runtime_error(
+            fmt::format("[cpu-ooc] Failed to create a state file in {}: {}",
+                        directory.string(), std::strerror(errno)));
+      unlink(path.c_str());
+    }
+    unmap();
+    if (ftruncate(fd, newSize * sizeof(Amplitude)) != 0)
+      throw std::runtime_error(
+          fmt::format("[cpu-ooc] Failed to resize the state file to {} "
+                      "bytes: {}",
+                      newSize * sizeof(Amplitude), std::strerror(errno)));
+    void *ptr = mmap(nullptr, newSize * sizeof(Amplitude),
+                     PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED)
+      throw std::runtime_error(fmt::format(
+          "[cpu-ooc] Failed to map the state file: {}", std::strerror(errno)));
+    amplitudes = static_cast<Amplitude *>(ptr);
+    numAmplitudes = newSize;
+  }
+
+  /// @brief Hint that the \p count amplitudes from \p begin are needed next,
+  /// so that they are read ahead while the current ones are processed.
+  void prefetch(std::size_t begin, std::size_t count) const {
+    // The advice range must start on a page boundary.
+    const std::uintptr_t pageMask = sysconf(_SC_PAGESIZE) - 1;
+    const auto first =
+        reinterpret_cast<std::uintptr_t>(amplitudes + begin) & ~pageMask;
+    const auto last = reinterpret_cast<std::uintptr_t>(amplitudes + begin +
+                                                       count);
+    madvise(reinterpret_cast<void *>(first), last - first, MADV_WILLNEED);
+  }
+
+  /// @brief Unmap and close the file.
+  void release() {
+    unmap();
+    if (fd >= 0)
+      close(fd);
+    fd = -1;
+  }
+
+private:
+  void unmap() {
+    if (amplitudes)
+      munmap(amplitudes, numAmplitudes * sizeof(Amplitude));
+    amplitudes = nullptr;
+    numAmplitudes = 0;
+  }
+
+  int fd = -1;
+  Amplitude *amplitudes = nullptr;
+  std::size_t numAmplitudes = 0;
+};
+
+/// @brief The CpuOutOfCoreCircuitSimulator is a double precision CPU state
+/// vector simulator for states larger than the memory, whose amplitudes live
+/// in a memory mapped file, e.g. on a fast local SSD.
+///
+/// The state is processed in chunks of 2^c contiguous amplitudes, which are
+/// streamed from the file in order. The queued gates are applied pass by
+/// pass: a pass takes all the gates whose targets are among the c low index
+/// bits (slots), in order except that a gate may move ahead of blocked gates
+/// on other qubits, fuses consecutive single qubit gates and applies them
+/// all to each chunk in turn. Controls on the high slots just select the
+/// chunks. A gate targeting a high slot is unblocked by remapping: its
+/// target is swapped with the low slot whose qubit is targeted the latest,
+/// which is another streaming pass over pairs of chunks.
+class CpuOutOfCoreCircuitSimulator
+    : public nvqir::CircuitSimulatorBase<double> {
+protected:
+  using Amplitude = std::complex<double>;
+  using Base = nvqir::CircuitSimulatorBase<double>;
+
+  /// @brief A gate of the queue, on logical qubits.
+  struct QueuedGate {
+    std::vector<Amplitude> matrix;
+    std::vector<std::size_t> controls;
+    std::vector<std::size_t> targets;
+  };
+
+  /// @brief The state vector, qubit q is bit `slots[q]` of the amplitude
+  /// index.
+  MappedAmplitudes state;
+
+  /// @brief The slot of each qubit.
+  std::vector<std::size_t> slots;
+
+  /// @brief The directory of the state file, from `CUDAQ_CPU_OOC_DIR`.
+  /// Empty until the first allocation if the variable is not set.
+  std::filesystem::path directory;
+
+  /// @brief The number of low slots of a chunk.
+  std::size_t chunkQubits = 24;
+
+  /// @brief Random number generator for measurements and sampling.
+  std::mt19937_64 randomEngine;
+
+  /// @brief Return the number of low slots of the current chunks.
+  std::size_t getChunkQubits() const {
+    return std::min(chunkQubits, slots.size());
+  }
+
+  std::vector<std::size_t>
+  getSlots(const std::vector<std::size_t> &qubits) const {
+    std::vector<std::size_t> result;
+    for (auto q : qubits)
+      result.push_back(slots[q]);
+    return result;
+  }
+
+  /// @brief Swap the low slot \p lowSlot with the high slot \p highSlot, by
+  /// exchanging amplitudes between the pairs of chunks that differ in the
+  /// high slot.
+  void swapSlots(std::size_t lowSlot, std::size_t highSlot) {
+    const std::size_t numChunkQubits = getChunkQubits();
+    const std::size_t chunkSize = 1ULL << numChunkQubits;
+    const std::size_t numChunks = state.size() >> numChunkQubits;
+    const std::size_t partnerBit = 1ULL << (highSlot - numChunkQubits);
+    const std::size_t lowBit = 1ULL << lowSlot;
+    for (std::size_t chunk = 0; chunk < numChunks; ++chunk) {
+      if (chunk & partnerBit)
+        continue;
+      Amplitude *lo = state.data() + chunk * chunkSize;
+      Amplitude *hi = state.data() + (chunk | partnerBit) * chunkSize;
+#if defined(_OPENMP)
+#pragma omp parallel for if (chunkSize >= cpu::minParallelDimension)
+#endif
+      for (std::int64_t k = 0; k < static_cast<std::int64_t>(chunkSize / 2);
+           ++k) {
+        const std::size_t i = cpu::insertZeroBit(k, lowSlot) | lowBit;
+        std::swap(lo[i], hi[i ^ lowBit]);
+      }
+    }
+
+    for (auto &slot : slots)
+      if (slot == lowSlot)
+        slot = highSlot;
+      else if (slot == highSlot)
+        slot = lowSlot;
+  }
+
+  /// @brief Move the high targets of `gates[first]` to low slots, evicting
+  /// the qubits whose next use as a target among the gates not yet
+  /// \p applied is the farthest.
+  void remap(const std::vector<QueuedGate> &gates,
+             const std::vector<bool> &applied, std::size_t first) {
+    const std::size_t numChunkQubits = getChunkQubits();
+    std::vector<std::size_t> nextUse(slots.size(), gates.size());
+    for (std::size_t i = gates.size(); i-- > first;)
+      if (!applied[i])
+        for (auto t : gates[i].targets)
+          nextUse[t] = i;
+    std::vector<std::size_t> qubitAt(numChunkQubits);
+    for (std::size_t q = 0; q < slots.size(); ++q)
+      if (slots[q] < numChunkQubits)
+        qubitAt[slots[q]] = q;
+
+    const auto &targets = gates[first].targets;
+    for (auto t : targets) {
+      if (slots[t] < numChunkQubits)
+        continue;
+      std::optional<std::size_t> victim;
+      for (std::size_t slot = 0; slot < numChunkQubits; ++slot) {
+        const auto q = qubitAt[slot];
+        if (std::find(targets.begin(), targets.end(), q) != targets.end())
+          continue;
+        if (!victim || nextUse[q] >= nextUse[qubitAt[*victim]])
+          victim = slot;
+      }
+      if (!victim)
+        throw std::runtime_error(fmt::format(
+            "[cpu-ooc] Chunks of {} qubits are too small for a gate on {} "
+            "target qubits.",
+            numChunkQubits, targets.size()));
+      cudaq::info("[cpu-ooc] Swapping qubit {} (slot {}) with qubit {} (slot "
+                  "{}).",
+                  t, slots[t], qubitAt[*victim], *victim);
+      qubitAt[*victim] = t;
+      swapSlots(*victim, slots[t]);
+    }
+  }
+
+  /// @brief Apply the \p gates of a pass to each chunk in turn.
+  void streamPass(const std::vector<QueuedGate> &gates) {
+    struct ChunkGate {
+      const std::vector<Amplitude> &matrix;
+      std::vector<std::size_t> controls;
+      std::vector<std::size_t> targets;
+      std::size_t chunkControlMask = 0;
+    };
+    const std::size_t numChunkQubits = getChunkQubits();
+    std::vector<ChunkGate> chunkGates;
+    for (const auto &gate : gates) {
+      ChunkGate &chunkGate = chunkGates.emplace_back(
+          ChunkGate{gate.matrix, {}, getSlots(gate.targets)});
+      for (auto c : gate.controls)
+        if (slots[c] < numChunkQubits)
+          chunkGate.controls.push_back(slots[c]);
+        else
+          chunkGate.chunkControlMask |= 1ULL << (slots[c] - numChunkQubits);
+    }
+
+    const std::size_t chunkSize = 1ULL << numChunkQubits;
+    const std::size_t numChunks = state.size() >> numChunkQubits;
+    for (std::size_t chunk = 0; chunk < numChunks; ++chunk) {
+      if (chunk + 1 < numChunks)
+        state.prefetch((chunk + 1) * chunkSize, chunkSize);
+      Amplitude *data = state.data() + chunk * chunkSize;
+      for (const auto &gate : chunkGates)
+        if ((chunk & gate.chunkControlMask) == gate.chunkControlMask)
+          cpu::applyMatrix(data, chunkSize, gate.matrix, gate.controls,
+                           gate.targets);
+    }
+  }
+
+  /// @brief Apply the \p gates, in as few streaming passes as possible.
+  void applyGates(const std::vector<QueuedGate> &gates) {
+    std::vector<bool> applied(gates.size(), false);
+    std::size_t numApplied = 0;
+    while (numApplied < gates.size()) {
+      const std::size_t numChunkQubits = getChunkQubits();
+      std::vector<QueuedGate> pass;
+      // The gates on each qubit must stay in order: a gate is blocked if it
+      // targets a high slot, or shares a qubit with a blocked gate.
+      std::vector<bool> blocked(slots.size(), false);
+      // The pass gate that last acted on each qubit, for fusion.
+      std::vector<std::optional<std::size_t>> lastGate(slots.size());
+      std::optional<std::size_t> firstBlocked;
+      for (std::size_t i = 0; i < gates.size(); ++i) {
+        if (applied[i])
+          continue;
+        const auto &gate = gates[i];
+        std::vector<std::size_t> qubits(gate.controls);
+        qubits.insert(qubits.end(), gate.targets.begin(), gate.targets.end());
+        const bool isBlocked =
+            std::any_of(qubits.begin(), qubits.end(),
+                        [&](std::size_t q) { return blocked[q]; }) ||
+            std::any_of(gate.targets.begin(), gate.targets.end(),
+                        [&](std::size_t q) {
+                          return slots[q] >= numChunkQubits;
+                        });
+        if (isBlocked) {
+          for (auto q : qubits)
+            blocked[q] = true;
+          if (!firstBlocked)
+            firstBlocked = i;
+          continue;
+        }
+
+        applied[i] = true;
+        ++numApplied;
+        const auto isSingleQubit = [](const QueuedGate &g) {
+          return g.controls.empty() && g.targets.size() == 1;
+        };
+        const auto last = lastGate[gate.targets[0]];
+        if (isSingleQubit(gate) && last && isSingleQubit(pass[*last])) {
+          // Fuse with the previous gate on this qubit: M = G M_prev.
+          auto &m = pass[*last].matrix;
+          const auto &g = gate.matrix;
+          m = {g[0] * m[0] + g[1] * m[2], g[0] * m[1] + g[1] * m[3],
+               g[2] * m[0] + g[3] * m[2], g[2] * m[1] + g[3] * m[3]};
+          continue;
+        }
+        pass.push_back(gate);
+        for (auto q : qubits)
+          lastGate[q] = pass.size() - 1;
+      }
+
+      if (!pass.empty())
+        streamPass(pass);
+      if (firstBlocked)
+        remap(gates, applied, *firstBlocked);
+    }
+  }
+
+  void flushGateQueueImpl() override {
+    // Noise channels are applied gate by gate.
+    if (executionContext && executionContext->noiseModel) {
+      Base::flushGateQueueImpl();
+      return;
+    }
+
+    std::vector<QueuedGate> gates;
+    while (!gateQueue.empty()) {
+      auto &next = gateQueue.front();
+      if (summaryData.enabled)
+        summaryData.svGateUpdate(next.controls.size(), next.targets.size(),
+                                 stateDimension,
+                                 stateDimension * sizeof(Amplitude));
+      gates.push_back({next.matrix, next.controls, next.targets});
+      gateQueue.pop();
+    }
+    applyGates(gates);
+  }
+
+  void applyGate(const GateApplicationTask &task) override {
+    applyGates({{task.matrix, task.controls, task.targets}});
+  }
+
+  /// @brief Grow the state vector by one qubit.
+  void addQubitToState() override { addQubitsToState(1); }
+
+  /// @brief Add the new qubits, in the top slots, in the state |data> (x)
+  /// |psi>, or |0> (x) |psi> if \p stateDataIn is null.
+  void addQubitsToState(std::size_t qubitCount,
+                        const void *stateDataIn = nullptr) override {
+    if (qubitCount == 0)
+      return;
+
+    const auto *data = reinterpret_cast<const Amplitude *>(stateDataIn);
+    const std::size_t oldNumQubits = slots.size();
+    const std::size_t oldDimension = state.size();
+    for (std::size_t i = 0; i < qubitCount; ++i)
+      slots.push_back(oldNumQubits + i);
+    if (directory.empty()) {
+      // The temporary directory is often memory backed, which defeats the
+      // purpose of this simulator.
+      directory = std::filesystem::temp_directory_path();
+      cudaq::log("[cpu-ooc] WARNING: CUDAQ_CPU_OOC_DIR is not set, the state "
+                 "vector file is created in {}. If it is a memory backed "
+                 "file system, e.g., tmpfs, set CUDAQ_CPU_OOC_DIR to a "
+                 "directory on a local drive.",
+                 directory.string());
+    }
+    state.resize(stateDimension, directory);
+    Amplitude *amplitudes = state.data();
+    if (oldDimension == 0) {
+      if (data)
+        std::copy(data, data + stateDimension, amplitudes);
+      else
+        amplitudes[0] = 1;
+      return;
+    }
+    if (!data)
+      return;
+
+    // The old amplitudes are only read by the new blocks, so they can be
+    // scaled in place last.
+#if defined(_OPENMP)
+#pragma omp parallel for if (stateDimension >= cpu::minParallelDimension)
+#endif
+    for (std::int64_t i = oldDimension;
+         i < static_cast<std::int64_t>(stateDimension); ++i)
+      amplitudes[i] = cpu::multiply(data[i >> oldNumQubits],
+                                    amplitudes[i & (oldDimension - 1)]);
+    for (std::size_t i = 0; i < oldDimension; ++i)
+      amplitudes[i] = cpu::multiply(data[0], amplitudes[i]);
+  }
+
+  void addQubitsToState(const cudaq::SimulationState &in_state) override {
+    if (const auto *casted = dynamic_cast<const CpuState<double> *>(&in_state))
+      addQubitsToState(nQubitsAllocated - slots.size(),
+                       casted->getAmplitudes().data());
+    else
+      addQubitsToState(nQubitsAllocated - slots.size(),
+                       getHostAmplitudes<double>(in_state).data());
+  }
+
+  void deallocateStateImpl() override {
+    state.release();
+    slots.clear();
+  }
+
+  void setToZeroState() override {
+    cpu::setZeroState(state.data(), state.size());
+  }
+
+  bool measureQubit(const std::size_t index) override {
+    const std::size_t slot = slots[index];
+    const std::size_t mask = 1ULL << slot;
+    const double probOne =
+        cpu::probability(state.data(), state.size(), mask, mask);
+    const bool result =
+        std::uniform_real_distribution<double>(0.0, 1.0)(randomEngine) <
+        probOne;
+    cpu::collapse(state.data(), state.size(), slot, result,
+                  1.0 / std::sqrt(result ? probOne : 1.0 - probOne));
+    cudaq::info("Measured qubit {} -> {}", index, result);
+    return result;
+  }
+
+  /// @brief Return a copy of the amplitudes, in qubit order.
+  std::vector<Amplitude> copyState() const {
+    std::vector<Amplitude> result(state.size());
+#if defined(_OPENMP)
+#pragma omp parallel for if (result.size() >= cpu::minParallelDimension)
+#endif
+    for (std::int64_t i = 0; i < static_cast<std::int64_t>(result.size());
+         ++i) {
+      std::size_t index = 0;
+      for (std::size_t q = 0; q < slots.size(); ++q)
+        index |= ((static_cast<std::size_t>(i) >> slots[q]) & 1) << q;
+      result[index] = state.data()[i];
+    }
+    return result;
+  }
+
+public:
+  CpuOutOfCoreCircuitSimulator() {
+    // Populate the correct name so it is printed correctly during
+    // deconstructor.
+    summaryData.name = name();
+    std::random_device randomDevice;
+    randomEngine = std::mt19937_64(randomDevice());
+
+    if (auto *dirEnvVar = std::getenv("CUDAQ_CPU_OOC_DIR"))
+      directory = dirEnvVar;
+    if (auto *chunkEnvVar = std::getenv("CUDAQ_CPU_OOC_CHUNK_QUBITS")) {
+      const std::string chunkStr(chunkEnvVar);
+      const char *nptr = chunkStr.data();
+      char *endptr = nullptr;
+      errno = 0; // reset errno to 0 before call
+      const auto value = strtol(nptr, &endptr, 10);
+      if (nptr == endptr || errno != 0 || value < 1)
+        throw std::runtime_error("Invalid CUDAQ_CPU_OOC_CHUNK_QUBITS setting. "
+                                 "Expected a positive number. Got: " +
+                                 chunkStr);
+      chunkQubits = value;
+      cudaq::info("Setting the state vector chunk size to {} qubits.",
+                  chunkQubits);
+    }
+  }
+  virtual ~CpuOutOfCoreCircuitSimulator() = default;
+
+  void setRandomSeed(std::size_t seed) override {
+    randomEngine = std::mt19937_64(seed);
+  }
+
+  bool canHandleObserve() override {
+    // Do not compute <H> from the state if shots based sampling requested
+    if (executionContext &&
+        executionContext->shots != static_cast<std::size_t>(-1)) {
+      return false;
+    }
+
+    return !shouldObserveFromSampling();
+  }
+
+  /// @brief Compute <psi|H|psi> term by term, directly from the state vector.
+  cudaq::observe_result observe(const cudaq::spin_op &op) override {
+    flushGateQueue();
+    double ee = 0.0;
+    op.for_each_term([&](cudaq::spin_op &term) {
+      const auto masks = cpu::getPauliMasks(term, slots);
+      ee += term.get_coefficient().real() *
+            cpu::expectationPauli(state.data(), state.size(), masks.xMask,
+                                  masks.zMask, masks.nY);
+    });
+    return cudaq::observe_result(ee, op,
+                                 cudaq::sample_result(cudaq::ExecutionResult(
+                                     {}, op.to_string(false), ee)));
+  }
+
+  /// @brief Apply exp(i theta P) in a single pass over the state vector.
+  void applyExpPauli(double theta, const std::vector<std::size_t> &controls,
+                     const std::vector<std::size_t> &qubitIds,
+                     const cudaq::spin_op &op) override {
+    // The decomposition is still used to trace the gates or apply noise.
+    if (op.is_identity() ||
+        (executionContext && (executionContext->name == "tracer" ||
+                              executionContext->noiseModel))) {
+      Base::applyExpPauli(theta, controls, qubitIds, op);
+      return;
+    }
+
+    flushGateQueue();
+    cudaq::info(" [{}] exp_pauli({}, {})", name(), theta, op.to_string(false));
+    const auto masks = cpu::getPauliMasks(op, getSlots(qubitIds));
+    std::size_t controlMask = 0;
+    for (auto c : controls)
+      controlMask |= 1ULL << slots[c];
+    if (summaryData.enabled)
+      summaryData.svGateUpdate(controls.size(),
+                               std::popcount(masks.xMask | masks.zMask),
+                               stateDimension,
+                               stateDimension * sizeof(Amplitude));
+    cpu::applyExpPauli(state.data(), state.size(), theta, masks.xMask,
+                       masks.zMask, masks.nY, controlMask);
+  }
+
+  /// @brief Reset the qubit to |0>.
+  void resetQubit(const std::size_t index) override {
+    flushGateQueue();
+    flushAnySamplingTasks();
+    if (measureQubit(index))
+      applyGates({{{0, 1, 1, 0}, {}, {index}}});
+  }
+
+  /// @brief Sample the multi-qubit state.
+  cudaq::ExecutionResult sample(const std::vector<std::size_t> &qubits,
+                                const int shots) override {
+    std::size_t zMask = 0;
+    for (auto q : qubits)
+      zMask |= 1ULL << slots[q];
+    if (shots < 1) {
+      const double expectationValue =
+          cpu::expectationZ(state.data(), state.size(), zMask);
+      cudaq::info("Computed expectation value = {}", expectationValue);
+      return cudaq::ExecutionResult{{}, expectationValue};
+    }
+
+    const double total = cpu::probability(state.data(), state.size(), 0, 0);
+    std::uniform_real_distribution<double> uniform(0.0, total);
+    std::vector<double> draws(shots);
+    for (auto &draw : draws)
+      draw = uniform(randomEngine);
+    std::sort(draws.begin(), draws.end());
+    auto outcomes = cpu::resolveDraws(state.data(), state.size(), draws);
+    // Pack the measured bits of each outcome, bit k being `qubits[k]`.
+    for (auto &outcome : outcomes) {
+      std::size_t packed = 0;
+      for (std::size_t k = 0; k < qubits.size(); ++k)
+        packed |= ((outcome >> slots[qubits[k]]) & 1) << k;
+      outcome = packed;
+    }
+    return cpu::countOutcomes(outcomes, qubits.size());
+  }
+
+  /// @brief Create a state from the data without copying the current one.
+  std::unique_ptr<cudaq::SimulationState>
+  createStateFromData(const cudaq::state_data &data) override {
+    return CpuState<double>(std::vector<Amplitude>{}).createFromData(data);
+  }
+
+  /// @brief Return a copy of the state, which must fit in memory.
+  std::unique_ptr<cudaq::SimulationState> getSimulationState() override {
+    flushGateQueue();
+    return std::make_unique<CpuState<double>>(copyState());
+  }
+
+  bool isStateVectorSimulator() const override { return true; }
+
+  /// @brief Primarily used for testing.
+  std::vector<Amplitude> getStateVector() {
+    flushGateQueue();
+    return copyState();
+  }
+
+  std::string name() const override { return "cpu-ooc"; }
+  NVQIR_SIMULATOR_CLONE_IMPL(CpuOutOfCoreCircuitSimulator)
+};
+
+} // namespace nvqir
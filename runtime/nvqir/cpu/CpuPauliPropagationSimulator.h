@@ -0,0 +1,376 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include "nvqir/CircuitSimulator.h"
+
+#include <bit>
+#include <limits>
+#include <unordered_map>
+
+namespace nvqir {
+
+/// @brief Truncation settings of the propagated observables.
+struct CpuPauliPropagationSettings {
+  // Default cutoff on the magnitude of the coefficients
+  double cutoff = 1e-8;
+  // Default max Pauli weight, 0 for no limit
+  int64_t maxWeight = 0;
+
+  CpuPauliPropagationSettings() {
+    if (auto *cutoffEnvVar = std::getenv("CUDAQ_PAULI_PROPAGATION_CUTOFF")) {
+      const std::string cutoffStr(cutoffEnvVar);
+      const char *nptr = cutoffStr.data();
+      char *endptr = nullptr;
+      errno = 0; // reset errno to 0 before call
+      cutoff = strtod(nptr, &endptr);
+
+      if (nptr == endptr || errno != 0 || cutoff < 0.0 || cutoff >= 1.0)
+        throw std::runtime_error("Invalid CUDAQ_PAULI_PROPAGATION_CUTOFF "
+                                 "setting. Expected a number in range [0.0, "
+                                 "1.0). Got: " +
+                                 cutoffStr);
+
+      cudaq::info("Setting Pauli propagation cutoff to {}.", cutoff);
+    }
+    if (auto *maxWeightEnvVar =
+            std::getenv("CUDAQ_PAULI_PROPAGATION_MAX_WEIGHT")) {
+      const std::string maxWeightStr(maxWeightEnvVar);
+      const char *nptr = maxWeightStr.data();
+      char *endptr = nullptr;
+      errno = 0; // reset errno to 0 before call
+      maxWeight = strtol(nptr, &endptr, 10);
+
+      if (nptr == endptr || errno != 0 || maxWeight < 1)
+        throw std::runtime_error("Invalid CUDAQ_PAULI_PROPAGATION_MAX_WEIGHT "
+                                 "setting. Expected a positive number. Got: " +
+                                 maxWeightStr);
+
+      cudaq::info("Setting Pauli propagation max weight to {}.", maxWeight);
+    }
+  }
+};
+
+/// @brief The CpuPauliPropagationSimulator computes expectation values in the
+/// Heisenberg picture. The gates are only recorded, and each term of the
+/// observable is propagated back through the circuit, O -> U^-1 O U, as a
+/// weighted sum of Pauli strings, before being evaluated on the initial
+/// |0...0> state, where only the strings of Z and I have a non-zero value.
+///
+/// Clifford gates map a Pauli string to a single one, while rotations split
+/// it in two. The strings with a coefficient below the cutoff, or acting on
+/// more qubits than the max weight, are dropped, which bounds the cost for
+/// wide and shallow circuits, whatever their number of qubits. The terms of
+/// the observable are propagated in parallel. Only `observe` is supported:
+/// the state itself is never computed, so it can neither be measured nor
+/// sampled.
+class CpuPauliPropagationSimulator
+    : public nvqir::CircuitSimulatorBase<double> {
+protected:
+  using Amplitude = std::complex<double>;
+
+  /// @brief A Pauli string in binary symplectic form, as the terms of
+  /// `spin_op`, packed: the X bits of all the qubits, then their Z bits. A
+  /// qubit with both bits set has a Y.
+  using PauliString = std::vector<std::uint64_t>;
+
+  struct PauliStringHash {
+    std::size_t operator()(const PauliString &string) const {
+      std::size_t hash = 0;
+      for (auto word : string)
+        hash ^= word + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+      return hash;
+    }
+  };
+
+  /// @brief A weighted sum of Pauli strings.
+  using PauliSum = std::unordered_map<PauliString, double, PauliStringHash>;
+
+  /// @brief A recorded operation on `qubits`. The Pauli string on them with
+  /// X bits x and Z bits z, of local index `x | z << qubits.size()`, is
+  /// propagated to the weighted local strings `images[x | z <<
+  /// qubits.size()]`. A reset has no images.
+  struct Operation {
+    std::vector<std::size_t> qubits;
+    std::vector<std::vector<std::pair<std::size_t, double>>> images;
+  };
+
+  /// @brief The recorded circuit.
+  std::vector<Operation> circuit;
+
+  /// @brief The index in the circuit of the first operation on each qubit,
+  /// or `noOperation`.
+  std::vector<std::size_t> firstOperation;
+  static constexpr std::size_t noOperation =
+      std::numeric_limits<std::size_t>::max();
+
+  /// @brief The truncation settings.
+  CpuPauliPropagationSettings settings;
+
+  /// @brief Gates on more qubits are not supported.
+  static constexpr std::size_t maxGateQubits = 5;
+
+  std::size_t numWords() const { return (firstOperation.size() + 63) / 64; }
+
+  /// @brief Return the X (or Z if \p z) bit of \p qubit in \p string.
+  bool getBit(const PauliString &string, std::size_t qubit,
+              bool z = false) const {
+    const std::size_t word = (z ? numWords() : 0) + qubit / 64;
+    return (string[word] >> (qubit % 64)) & 1;
+  }
+
+  void setBit(PauliString &string, std::size_t qubit, bool z,
+              bool value) const {
+    const std::size_t word = (z ? numWords() : 0) + qubit / 64;
+    const std::uint64_t bit = 1ULL << (qubit % 64);
+    string[word] = value ? string[word] | bit : string[word] & ~bit;
+  }
+
+  /// @brief Return the number of qubits \p string acts on.
+  std::size_t weight(const PauliString &string) const {
+    std::size_t count = 0;
+    for (std::size_t w = 0; w < numWords(); ++w)
+      count += std::popcount(string[w] | string[w + numWords()]);
+    return count;
+  }
+
+  /// @brief Return the dense matrix of \p op, the task matrix on the targets
+  /// then the controls.
+  static std::vector<Amplitude> getFullMatrix(const GateApplicationTask &op) {
+    const std::size_t dim = 1ULL << (op.targets.size() + op.controls.size());
+    const std::size_t targetDim = 1ULL << op.targets.size();
+    std::vector<Amplitude> matrix(dim * dim, 0.0);
+    for (std::size_t i = 0; i < dim - targetDim; ++i)
+      matrix[i * dim + i] = 1.0;
+    const std::size_t offset = dim - targetDim;
+    for (std::size_t r = 0; r < targetDim; ++r)
+      for (std::size_t c = 0; c < targetDim; ++c)
+        matrix[(offset + r) * dim + offset + c] = op.matrix[r * targetDim + c];
+    return matrix;
+  }
+
+  /// @brief Record the gate, with the decomposition of U^-1 P U on the Pauli
+  /// strings for each local Pauli string P.
+  void applyGate(const GateApplicationTask &task) override {
+    Operation op{task.targets, {}};
+    op.qubits.insert(op.qubits.end(), task.controls.begin(),
+                     task.controls.end());
+    const std::size_t k = op.qubits.size();
+    if (k > maxGateQubits)
+      throw std::runtime_error(fmt::format(
+          "The {} simulator does not support gates on more than {} qubits.",
+          name(), maxGateQubits));
+
+    const std::size_t dim = 1ULL << k;
+    const auto u = getFullMatrix(task);
+    // The element (r, r ^ x) of the Pauli string x | z << k.
+    auto pauliElement = [](std::size_t x, std::size_t z, std::size_t r) {
+      static const Amplitude phases[] = {1.0, {0.0, 1.0}, -1.0, {0.0, -1.0}};
+      return phases[(std::popcount(x & z) + 2 * std::popcount(z & (r ^ x))) %
+                    4];
+    };
+    op.images.resize(dim * dim);
+    std::vector<Amplitude> m(dim * dim);
+    for (std::size_t p = 0; p < dim * dim; ++p) {
+      const std::size_t x = p % dim, z = p / dim;
+      // m = U^-1 P U
+      for (std::size_t r = 0; r < dim; ++r)
+        for (std::size_t c = 0; c < dim; ++c) {
+          Amplitude sum = 0.0;
+          for (std::size_t b = 0; b < dim; ++b)
+            sum += std::conj(u[(b ^ x) * dim + r]) *
+                   pauliElement(x, z, b ^ x) * u[b * dim + c];
+          m[r * dim + c] = sum;
+        }
+      // The coefficient of the string q is tr(q m) / dim.
+      for (std::size_t q = 0; q < dim * dim; ++q) {
+        const std::size_t qx = q % dim, qz = q / dim;
+        Amplitude sum = 0.0;
+        for (std::size_t r = 0; r < dim; ++r)
+          sum += pauliElement(qx, qz, r) * m[(r ^ qx) * dim + r];
+        const double coefficient = sum.real() / dim;
+        if (std::abs(coefficient) > 1e-14)
+          op.images[p].emplace_back(q, coefficient);
+      }
+    }
+
+    for (auto q : op.qubits)
+      firstOperation[q] = std::min(firstOperation[q], circuit.size());
+    circuit.push_back(std::move(op));
+  }
+
+  /// @brief Return U^-1 \p sum U, for the operation \p index of the circuit.
+  PauliSum propagate(PauliSum &&sum, std::size_t index) const {
+    const auto &op = circuit[index];
+    const std::size_t k = op.qubits.size();
+    PauliSum next;
+    next.reserve(sum.size());
+    for (auto &[string, coefficient] : sum) {
+      std::size_t local = 0;
+      for (std::size_t j = 0; j < k; ++j)
+        local |= (getBit(string, op.qubits[j]) << j) |
+                 (getBit(string, op.qubits[j], true) << (j + k));
+      if (local == 0) {
+        next[string] += coefficient;
+        continue;
+      }
+      if (op.images.empty()) {
+        // <0| X |0> = <0| Y |0> = 0 and <0| Z |0> = 1 on a reset qubit.
+        if (local & 1)
+          continue;
+        PauliString image = string;
+        setBit(image, op.qubits[0], true, false);
+        next[std::move(image)] += coefficient;
+        continue;
+      }
+      for (const auto &[q, factor] : op.images[local]) {
+        const double value = coefficient * factor;
+        if (std::abs(value) < settings.cutoff)
+          continue;
+        PauliString image = string;
+        bool vanishes = false;
+        for (std::size_t j = 0; j < k; ++j) {
+          const bool x = (q >> j) & 1;
+          setBit(image, op.qubits[j], false, x);
+          setBit(image, op.qubits[j], true, (q >> (j + k)) & 1);
+          // X and Y vanish on |0> if no earlier operation acts on the qubit.
+          vanishes |= x && firstOperation[op.qubits[j]] == index;
+        }
+        if (vanishes || (settings.maxWeight > 0 &&
+                         weight(image) >
+                             static_cast<std::size_t>(settings.maxWeight)))
+          continue;
+        next[std::move(image)] += value;
+      }
+    }
+    return next;
+  }
+
+  /// @brief Return <0| U^-1 P U |0> for the Pauli string \p term in binary
+  /// symplectic form, U being the circuit.
+  double expectation(const cudaq::spin_op::spin_op_term &term) const {
+    const std::size_t termQubits = term.size() / 2;
+    PauliString string(2 * numWords(), 0);
+    for (std::size_t q = 0; q < termQubits; ++q) {
+      if (q >= firstOperation.size() || firstOperation[q] == noOperation) {
+        // X and Y vanish on |0> for qubits without operations.
+        if (term[q])
+          return 0.0;
+        continue;
+      }
+      setBit(string, q, false, term[q]);
+      setBit(string, q, true, term[q + termQubits]);
+    }
+
+    PauliSum sum{{std::move(string), 1.0}};
+    for (std::size_t index = circuit.size(); index-- > 0 && !sum.empty();)
+      sum = propagate(std::move(sum), index);
+
+    double value = 0.0;
+    for (const auto &[image, coefficient] : sum) {
+      bool diagonal = true;
+      for (std::size_t w = 0; w < numWords(); ++w)
+        diagonal &= image[w] == 0;
+      if (diagonal)
+        value += coefficient;
+    }
+    return value;
+  }
+
+  /// @brief Grow the state by one qubit.
+  void addQubitToState() override { addQubitsToState(1); }
+
+  void addQubitsToState(std::size_t qubitCount,
+                        const void *stateDataIn = nullptr) override {
+    if (stateDataIn)
+      throw std::runtime_error(fmt::format(
+          "The {} simulator does not support initialization of qubits from "
+          "state data.",
+          name()));
+    firstOperation.resize(firstOperation.size() + qubitCount, noOperation);
+  }
+
+  /// @brief The state is never computed.
+  std::size_t calculateStateDim(const std::size_t numQubits) override {
+    return 0;
+  }
+
+  /// @brief Reset the qubit state.
+  void deallocateStateImpl() override {
+    circuit.clear();
+    firstOperation.clear();
+  }
+
+  /// @brief Set the current state back to the |0> state.
+  void setToZeroState() override {
+    circuit.clear();
+    std::fill(firstOperation.begin(), firstOperation.end(), noOperation);
+  }
+
+  bool measureQubit(const std::size_t index) override {
+    throw std::runtime_error(fmt::format(
+        "The {} simulator only supports observe, qubits cannot be measured. "
+        "Use a state vector simulator instead.",
+        name()));
+  }
+
+public:
+  CpuPauliPropagationSimulator() {
+    // Populate the correct name so it is printed correctly during
+    // deconstructor.
+    summaryData.name = name();
+  }
+  virtual ~CpuPauliPropagationSimulator() = default;
+
+  bool canHandleObserve() override {
+    // Shots based observe requires sampling, which is not supported.
+    return !executionContext ||
+           executionContext->shots == static_cast<std::size_t>(-1);
+  }
+
+  /// @brief Compute <psi|H|psi> by propagating the terms of H back through
+  /// the circuit. The terms are propagated in parallel.
+  cudaq::observe_result observe(const cudaq::spin_op &op) override {
+    flushGateQueue();
+    const auto data = op.get_raw_data();
+    const auto &terms = data.first;
+    const auto &coefficients = data.second;
+    double ee = 0.0;
+#if defined(_OPENMP)
+#pragma omp parallel for reduction(+ : ee) schedule(dynamic)
+#endif
+    for (std::int64_t t = 0; t < static_cast<std::int64_t>(terms.size()); ++t)
+      ee += coefficients[t].real() * expectation(terms[t]);
+    return cudaq::observe_result(ee, op,
+                                 cudaq::sample_result(cudaq::ExecutionResult(
+                                     {}, op.to_string(false), ee)));
+  }
+
+  /// @brief Reset the qubit to |0>, which is recorded in the circuit.
+  void resetQubit(const std::size_t index) override {
+    flushGateQueue();
+    firstOperation[index] = std::min(firstOperation[index], circuit.size());
+    circuit.push_back(Operation{{index}, {}});
+  }
+
+  cudaq::ExecutionResult sample(const std::vector<std::size_t> &qubits,
+                                const int shots) override {
+    throw std::runtime_error(fmt::format(
+        "The {} simulator only supports observe, the state cannot be "
+        "sampled. Use a state vector simulator instead.",
+        name()));
+  }
+
+  bool isStateVectorSimulator() const override { return false; }
+
+  std::string name() const override { return "cpu-pauli-prop"; }
+  NVQIR_SIMULATOR_CLONE_IMPL(CpuPauliPropagationSimulator)
+};
+
+} // namespace nvqir
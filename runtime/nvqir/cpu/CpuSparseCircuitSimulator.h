@@ -0,0 +1,656 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CpuCircuitSimulator.h"
+
+#include <limits>
+
+namespace nvqir {
+
+/// @brief Settings of the sparse state, read from the environment.
+struct CpuSparseSettings {
+  // Default magnitude below which amplitudes are pruned
+  double tolerance = 1e-12;
+  // Default fraction of non-zero amplitudes above which the state is dense
+  double maxDensity = 0.125;
+  // Default max number of non-zero amplitudes of a sparse state
+  int64_t maxAmplitudes = 1LL << 26;
+
+  CpuSparseSettings() {
+    tolerance = parseFraction("CUDAQ_SPARSE_TOLERANCE", tolerance, false);
+    maxDensity = parseFraction("CUDAQ_SPARSE_MAX_DENSITY", maxDensity, true);
+    if (auto *maxAmplitudesEnvVar =
+            std::getenv("CUDAQ_SPARSE_MAX_AMPLITUDES")) {
+      const std::string maxAmplitudesStr(maxAmplitudesEnvVar);
+      const char *nptr = maxAmplitudesStr.data();
+      char *endptr = nullptr;
+      errno = 0; // reset errno to 0 before call
+      maxAmplitudes = strtol(nptr, &endptr, 10);
+
+      if (nptr == endptr || errno != 0 || maxAmplitudes < 1)
+        throw std::runtime_error("Invalid CUDAQ_SPARSE_MAX_AMPLITUDES "
+                                 "setting. Expected a positive number. Got: " +
+                                 maxAmplitudesStr);
+
+      cudaq::info("Setting the max number of sparse amplitudes to {}.",
+                  maxAmplitudes);
+    }
+  }
+
+private:
+  /// @brief Parse a number in [0, 1), or in (0, 1] if \p upperInclusive.
+  static double parseFraction(const char *envVarName, double defaultValue,
+                              bool upperInclusive) {
+    auto *envVar = std::getenv(envVarName);
+    if (!envVar)
+      return defaultValue;
+
+    const std::string valueStr(envVar);
+    const char *nptr = valueStr.data();
+    char *endptr = nullptr;
+    errno = 0; // reset errno to 0 before call
+    const double value = strtod(nptr, &endptr);
+
+    const bool inRange = upperInclusive ? value > 0.0 && value <= 1.0
+                                        : value >= 0.0 && value < 1.0;
+    if (nptr == endptr || errno != 0 || !inRange)
+      throw std::runtime_error(
+          std::string("Invalid ") + envVarName +
+          " setting. Expected a number in range " +
+          (upperInclusive ? "(0.0, 1.0]" : "[0.0, 1.0)") +
+          ". Got: " + valueStr);
+
+    cudaq::info("Setting {} to {}.", envVarName, value);
+    return value;
+  }
+};
+
+/// @brief Non-zero amplitudes keyed by their basis state index, in an open
+/// addressing hash table with linear probing. The all ones index marks the
+/// empty slots, so the states have at most 63 qubits.
+class SparseAmplitudes {
+public:
+  using Amplitude = std::complex<double>;
+  static constexpr std::uint64_t emptyKey = ~0ULL;
+
+  std::size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+
+  /// @brief The slots of the table, slot s holding an amplitude if
+  /// `keyAt(s)` is not `emptyKey`.
+  std::size_t capacity() const { return keys.size(); }
+  std::uint64_t keyAt(std::size_t slot) const { return keys[slot]; }
+  Amplitude &valueAt(std::size_t slot) { return values[slot]; }
+  const Amplitude &valueAt(std::size_t slot) const { return values[slot]; }
+
+  /// @brief Return the amplitude of \p key, inserting a zero one if absent.
+  Amplitude &operator[](std::uint64_t key) {
+    if (2 * (count + 1) > keys.size())
+      rehash(std::max(minCapacity, 2 * keys.size()));
+    const std::size_t slot = findSlot(key);
+    if (keys[slot] == emptyKey) {
+      keys[slot] = key;
+      values[slot] = 0.0;
+      ++count;
+    }
+    return values[slot];
+  }
+
+  /// @brief Return the amplitude of \p key, which is zero if absent.
+  Amplitude get(std::uint64_t key) const {
+    if (keys.empty())
+      return 0.0;
+    const std::size_t slot = findSlot(key);
+    return keys[slot] == emptyKey ? Amplitude(0.0) : values[slot];
+  }
+
+  /// @brief Remove all the amplitudes, and size the table for about
+  /// \p expectedSize of them. The table is only reallocated if it is too
+  /// small or much too large, so that clearing it between gates is cheap.
+  void clear(std::size_t expectedSize = 0) {
+    const std::size_t capacity = capacityFor(expectedSize);
+    if (keys.size() < capacity || keys.size() > 4 * capacity) {
+      std::vector<std::uint64_t>(capacity, emptyKey).swap(keys);
+      std::vector<Amplitude>(capacity).swap(values);
+    } else {
+      std::fill(keys.begin(), keys.end(), emptyKey);
+    }
+    count = 0;
+  }
+
+  void swap(SparseAmplitudes &other) noexcept {
+    keys.swap(other.keys);
+    values.swap(other.values);
+    std::swap(count, other.count);
+  }
+
+private:
+  static constexpr std::size_t minCapacity = 16;
+
+  /// @brief The power of two capacity keeping the load factor below 1/2.
+  static std::size_t capacityFor(std::size_t size) {
+    return std::max(minCapacity, std::bit_ceil(2 * size));
+  }
+
+  /// @brief Mix the bits of the index (splitmix64 finalizer), so that
+  /// indices only differing in their high bits do not collide.
+  static std::uint64_t hash(std::uint64_t key) {
+    key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+    return key ^ (key >> 31);
+  }
+
+  /// @brief Return the slot of \p key, or the empty slot where it belongs.
+  std::size_t findSlot(std::uint64_t key) const {
+    const std::size_t mask = keys.size() - 1;
+    std::size_t slot = hash(key) & mask;
+    while (keys[slot] != key && keys[slot] != emptyKey)
+      slot = (slot + 1) & mask;
+    return slot;
+  }
+
+  void rehash(std::size_t capacity) {
+    std::vector<std::uint64_t> oldKeys(capacity, emptyKey);
+    std::vector<Amplitude> oldValues(capacity);
+    keys.swap(oldKeys);
+    values.swap(oldValues);
+    for (std::size_t s = 0; s < oldKeys.size(); ++s) {
+      if (oldKeys[s] == emptyKey)
+        continue;
+      const std::size_t slot = findSlot(oldKeys[s]);
+      keys[slot] = oldKeys[s];
+      values[slot] = oldValues[s];
+    }
+  }
+
+  std::vector<std::uint64_t> keys;
+  std::vector<Amplitude> values;
+  std::size_t count = 0;
+};
+
+/// @brief The CpuSparseCircuitSimulator is a CPU state vector simulator that
+/// only stores the non-zero amplitudes, keyed by basis state index, so that
+/// classical reversible and oracle circuits, which keep few non-zero
+/// amplitudes, can be simulated on up to 63 qubits.
+///
+/// Gates mapping each basis state to a single one (X, CNOT, Toffoli, SWAP,
+/// phases...) just rewrite the indices, and diagonal gates update the
+/// amplitudes in place. The other gates branch each basis state, and the
+/// resulting amplitudes below `CUDAQ_SPARSE_TOLERANCE` are pruned. Once the
+/// fraction of non-zero amplitudes exceeds `CUDAQ_SPARSE_MAX_DENSITY`, the
+/// state is converted to a dense state vector and simulated by the CPU
+/// kernels, until a measurement makes it sparse again. A sparse state with
+/// more than `CUDAQ_SPARSE_MAX_AMPLITUDES` amplitudes that is not dense
+/// enough for that is an error. As the gates are queued, it is raised when
+/// the queue is flushed (by a measurement, `observe` or a state access), not
+/// by the gate call that exceeded the limit.
+class CpuSparseCircuitSimulator : public nvqir::CircuitSimulatorBase<double> {
+protected:
+  using Amplitude = std::complex<double>;
+
+  /// @brief The all ones index is the empty key of the table.
+  static constexpr std::size_t maxQubits = 63;
+
+  /// @brief The non-zero amplitudes of a sparse state, qubit q is bit q of
+  /// the index.
+  SparseAmplitudes amplitudes;
+
+  /// @brief The table the gates write the new amplitudes to, kept to reuse
+  /// its storage.
+  SparseAmplitudes scratch;
+
+  /// @brief The state vector, if the state is dense.
+  std::vector<Amplitude> denseState;
+
+  std::size_t numQubits = 0;
+
+  CpuSparseSettings settings;
+
+  /// @brief Random number generator for measurements and sampling.
+  std::mt19937_64 randomEngine;
+
+  bool isDense() const { return !denseState.empty(); }
+
+  void toDense() {
+    cudaq::info("[{}] Switching to a dense state vector, {} non-zero "
+                "amplitudes on {} qubits.",
+                name(), amplitudes.size(), numQubits);
+    denseState.assign(stateDimension, 0.0);
+    for (std::size_t s = 0; s < amplitudes.capacity(); ++s)
+      if (amplitudes.keyAt(s) != SparseAmplitudes::emptyKey)
+        denseState[amplitudes.keyAt(s)] = amplitudes.valueAt(s);
+    amplitudes.clear();
+    scratch.clear();
+  }
+
+  void toSparse() {
+    const auto nonZeros =
+        std::count_if(denseState.begin(), denseState.end(),
+                      [](const Amplitude &a) { return a != 0.0; });
+    cudaq::info("[{}] Switching to a sparse state, {} non-zero amplitudes "
+                "on {} qubits.",
+                name(), nonZeros, numQubits);
+    amplitudes.clear(nonZeros);
+    for (std::size_t i = 0; i < denseState.size(); ++i)
+      if (denseState[i] != 0.0)
+        amplitudes[i] = denseState[i];
+    std::vector<Amplitude>().swap(denseState);
+  }
+
+  /// @brief Switch to a dense state vector if the sparse state is dense
+  /// enough, or fail if it is too large.
+  void checkDensity() {
+    if (amplitudes.size() > settings.maxDensity * stateDimension) {
+      toDense();
+      return;
+    }
+    if (amplitudes.size() > static_cast<std::size_t>(settings.maxAmplitudes))
+      throw std::runtime_error(fmt::format(
+          "The {} simulator exceeded the maximum of {} non-zero amplitudes "
+          "(CUDAQ_SPARSE_MAX_AMPLITUDES) on {} qubits. Use a state vector "
+          "simulator instead.",
+          name(), settings.maxAmplitudes, numQubits));
+  }
+
+  /// @brief Drop the amplitudes whose magnitude is below the tolerance.
+  void prune() {
+    std::size_t numPruned = 0;
+    for (std::size_t s = 0; s < amplitudes.capacity(); ++s)
+      if (amplitudes.keyAt(s) != SparseAmplitudes::emptyKey &&
+          std::abs(amplitudes.valueAt(s)) <= settings.tolerance)
+        ++numPruned;
+    if (numPruned == 0)
+      return;
+
+    scratch.clear(amplitudes.size() - numPruned);
+    for (std::size_t s = 0; s < amplitudes.capacity(); ++s)
+      if (amplitudes.keyAt(s) != SparseAmplitudes::emptyKey &&
+          std::abs(amplitudes.valueAt(s)) > settings.tolerance)
+        scratch[amplitudes.keyAt(s)] = amplitudes.valueAt(s);
+    amplitudes.swap(scratch);
+  }
+
+  void applyGate(const GateApplicationTask &task) override {
+    if (isDense()) {
+      cpu::applyMatrix(denseState.data(), denseState.size(), task.matrix,
+                       task.controls, task.targets);
+      return;
+    }
+
+    // Bit k of the matrix row / column index is `targets[k]`, and `offsets`
+    // places these bits in the basis state index, see `cpu::applyMatrix`.
+    const std::size_t numRows = 1ULL << task.targets.size();
+    std::uint64_t controlMask = 0, targetMask = 0;
+    for (auto c : task.controls)
+      controlMask |= 1ULL << c;
+    for (auto t : task.targets)
+      targetMask |= 1ULL << t;
+    std::vector<std::uint64_t> offsets(numRows, 0);
+    for (std::size_t r = 0; r < numRows; ++r)
+      for (std::size_t t = 0; t < task.targets.size(); ++t)
+        if ((r >> t) & 1)
+          offsets[r] |= 1ULL << task.targets[t];
+    const auto column = [&](std::uint64_t key) {
+      std::size_t c = 0;
+      for (std::size_t t = 0; t < task.targets.size(); ++t)
+        c |= ((key >> task.targets[t]) & 1) << t;
+      return c;
+    };
+
+    // The rows of the non-zero entries of each column.
+    std::vector<std::vector<std::size_t>> rowsOf(numRows);
+    bool diagonal = true, permutation = true;
+    std::size_t maxBranches = 1;
+    for (std::size_t c = 0; c < numRows; ++c) {
+      for (std::size_t r = 0; r < numRows; ++r)
+        if (task.matrix[r * numRows + c] != 0.0)
+          rowsOf[c].push_back(r);
+      permutation &= rowsOf[c].size() == 1;
+      diagonal &= rowsOf[c].size() == 1 && rowsOf[c][0] == c;
+      maxBranches = std::max(maxBranches, rowsOf[c].size());
+    }
+
+    if (diagonal) {
+      for (std::size_t s = 0; s < amplitudes.capacity(); ++s) {
+        const auto key = amplitudes.keyAt(s);
+        if (key == SparseAmplitudes::emptyKey ||
+            (key & controlMask) != controlMask)
+          continue;
+        const std::size_t c = column(key);
+        amplitudes.valueAt(s) *= task.matrix[c * numRows + c];
+      }
+      return;
+    }
+
+    scratch.clear(amplitudes.size() * maxBranches);
+    for (std::size_t s = 0; s < amplitudes.capacity(); ++s) {
+      const auto key = amplitudes.keyAt(s);
+      if (key == SparseAmplitudes::emptyKey)
+        continue;
+      const Amplitude value = amplitudes.valueAt(s);
+      if ((key & controlMask) != controlMask) {
+        scratch[key] += value;
+        continue;
+      }
+      const std::size_t c = column(key);
+      const std::uint64_t base = key & ~targetMask;
+      for (auto r : rowsOf[c])
+        scratch[base | offsets[r]] += task.matrix[r * numRows + c] * value;
+    }
+    amplitudes.swap(scratch);
+    if (!permutation)
+      prune();
+    checkDensity();
+  }
+
+  /// @brief Grow the state by one qubit.
+  void addQubitToState() override { addQubitsToState(1); }
+
+  /// @brief Add the new qubits, as the most significant bits of the index,
+  /// in the state |data> (x) |psi>, or |0> (x) |psi> if \p stateDataIn is
+  /// null.
+  void addQubitsToState(std::size_t qubitCount,
+                        const void *stateDataIn = nullptr) override {
+    if (qubitCount == 0)
+      return;
+    if (numQubits + qubitCount > maxQubits)
+      throw std::runtime_error(
+          fmt::format("The {} simulator supports at most {} qubits, {} were "
+                      "requested.",
+                      name(), maxQubits, numQubits + qubitCount));
+
+    const auto *data = reinterpret_cast<const Amplitude *>(stateDataIn);
+    const std::size_t oldNumQubits = numQubits;
+    numQubits += qubitCount;
+    if (isDense())
+      toSparse();
+    if (oldNumQubits == 0) {
+      amplitudes.clear();
+      if (!data)
+        amplitudes[0] = 1.0;
+      else
+        for (std::size_t i = 0; i < (1ULL << qubitCount); ++i)
+          if (data[i] != 0.0)
+            amplitudes[i] = data[i];
+    } else if (data) {
+      scratch.clear(amplitudes.size());
+      for (std::size_t i = 0; i < (1ULL << qubitCount); ++i) {
+        if (data[i] == 0.0)
+          continue;
+        for (std::size_t s = 0; s < amplitudes.capacity(); ++s)
+          if (amplitudes.keyAt(s) != SparseAmplitudes::emptyKey)
+            scratch[(i << oldNumQubits) | amplitudes.keyAt(s)] =
+                data[i] * amplitudes.valueAt(s);
+      }
+      amplitudes.swap(scratch);
+    }
+    checkDensity();
+  }
+
+  void addQubitsToState(const cudaq::SimulationState &in_state) override {
+    if (const auto *casted = dynamic_cast<const CpuState<double> *>(&in_state))
+      addQubitsToState(nQubitsAllocated - numQubits,
+                       casted->getAmplitudes().data());
+    else
+      addQubitsToState(nQubitsAllocated - numQubits,
+                       getHostAmplitudes<double>(in_state).data());
+  }
+
+  /// @brief The dimension of the full state, which saturates past the
+  /// supported number of qubits, e.g. when tracing larger kernels.
+  std::size_t calculateStateDim(const std::size_t numQubits) override {
+    return numQubits > maxQubits ? std::numeric_limits<std::size_t>::max()
+                                 : 1ULL << numQubits;
+  }
+
+  /// @brief Reset the qubit state.
+  void deallocateStateImpl() override {
+    amplitudes.clear();
+    scratch.clear();
+    std::vector<Amplitude>().swap(denseState);
+    numQubits = 0;
+  }
+
+  /// @brief Set the current state back to the |0> state.
+  void setToZeroState() override {
+    std::vector<Amplitude>().swap(denseState);
+    amplitudes.clear();
+    amplitudes[0] = 1.0;
+  }
+
+  /// @brief Measure the qubit and collapse the state. A dense state whose
+  /// non-zero amplitudes fall well below the density threshold becomes
+  /// sparse again.
+  bool measureQubit(const std::size_t index) override {
+    const std::uint64_t mask = 1ULL << index;
+    double total = 0.0, probOne = 0.0;
+    if (isDense()) {
+      total = cpu::probability(denseState.data(), denseState.size(), 0, 0);
+      probOne =
+          cpu::probability(denseState.data(), denseState.size(), mask, mask);
+    } else {
+      for (std::size_t s = 0; s < amplitudes.capacity(); ++s) {
+        const auto key = amplitudes.keyAt(s);
+        if (key == SparseAmplitudes::emptyKey)
+          continue;
+        const double prob = std::norm(amplitudes.valueAt(s));
+        total += prob;
+        if (key & mask)
+          probOne += prob;
+      }
+    }
+    probOne /= total;
+    const bool result =
+        std::uniform_real_distribution<double>(0.0, 1.0)(randomEngine) <
+        probOne;
+    const double scale =
+        1.0 / std::sqrt(total * (result ? probOne : 1.0 - probOne));
+
+    if (isDense()) {
+      cpu::collapse(denseState.data(), denseState.size(), index, result,
+                    scale);
+      const auto nonZeros =
+          std::count_if(denseState.begin(), denseState.end(),
+                        [](const Amplitude &a) { return a != 0.0; });
+      if (nonZeros < settings.maxDensity / 2 * denseState.size())
+        toSparse();
+    } else {
+      scratch.clear(amplitudes.size());
+      for (std::size_t s = 0; s < amplitudes.capacity(); ++s) {
+        const auto key = amplitudes.keyAt(s);
+        if (key != SparseAmplitudes::emptyKey &&
+            static_cast<bool>(key & mask) == result)
+          scratch[key] = amplitudes.valueAt(s) * scale;
+      }
+      amplitudes.swap(scratch);
+    }
+    cudaq::info("Measured qubit {} -> {}", index, result);
+    return result;
+  }
+
+  /// @brief Return <psi|P|psi> for the Pauli product P, described as in
+  /// `cpu::expectationPauli`.
+  double expectationPauli(std::uint64_t xMask, std::uint64_t zMask,
+                          std::size_t nY) const {
+    if (isDense())
+      return cpu::expectationPauli(denseState.data(), denseState.size(),
+                                   xMask, zMask, nY);
+
+    double re = 0.0, im = 0.0;
+    const std::size_t capacity = amplitudes.capacity();
+#if defined(_OPENMP)
+#pragma omp parallel for reduction(+ : re, im) if (capacity >=                \
+                                                     cpu::minParallelDimension)
+#endif
+    for (std::int64_t s = 0; s < static_cast<std::int64_t>(capacity); ++s) {
+      const auto key = amplitudes.keyAt(s);
+      if (key == SparseAmplitudes::emptyKey)
+        continue;
+      const Amplitude b = amplitudes.valueAt(s);
+      const Amplitude a = xMask ? amplitudes.get(key ^ xMask) : b;
+      const double sign = std::popcount(key & zMask) % 2 == 0 ? 1.0 : -1.0;
+      re += sign * (a.real() * b.real() + a.imag() * b.imag());
+      im += sign * (a.real() * b.imag() - a.imag() * b.real());
+    }
+    // The result is real for a hermitian P.
+    switch (nY % 4) {
+    case 0:
+      return re;
+    case 1:
+      return -im;
+    case 2:
+      return -re;
+    default:
+      return im;
+    }
+  }
+
+  /// @brief Resolve the sorted cumulative probability \p draws to basis
+  /// state indices, taking the amplitudes in the order of the table.
+  std::vector<std::size_t>
+  resolveSparseDraws(const std::vector<double> &draws) const {
+    std::vector<std::size_t> indices(draws.size());
+    std::size_t s = 0, last = 0;
+    double acc = 0.0;
+    for (std::size_t d = 0; d < draws.size(); ++d) {
+      for (; s < amplitudes.capacity(); ++s) {
+        if (amplitudes.keyAt(s) == SparseAmplitudes::emptyKey)
+          continue;
+        last = s;
+        const double prob = std::norm(amplitudes.valueAt(s));
+        if (prob > 0.0 && acc + prob > draws[d])
+          break;
+        acc += prob;
+      }
+      // Draws past the total due to rounding take the last amplitude.
+      indices[d] = amplitudes.keyAt(s < amplitudes.capacity() ? s : last);
+    }
+    return indices;
+  }
+
+  /// @brief Return the state vector, which must fit in memory.
+  std::vector<Amplitude> getDenseState() const {
+    if (isDense())
+      return denseState;
+    std::vector<Amplitude> result(stateDimension);
+    for (std::size_t s = 0; s < amplitudes.capacity(); ++s)
+      if (amplitudes.keyAt(s) != SparseAmplitudes::emptyKey)
+        result[amplitudes.keyAt(s)] = amplitudes.valueAt(s);
+    return result;
+  }
+
+public:
+  CpuSparseCircuitSimulator() {
+    // Populate the correct name so it is printed correctly during
+    // deconstructor.
+    summaryData.name = name();
+    std::random_device randomDevice;
+    randomEngine = std::mt19937_64(randomDevice());
+  }
+  virtual ~CpuSparseCircuitSimulator() = default;
+
+  void setRandomSeed(std::size_t seed) override {
+    randomEngine = std::mt19937_64(seed);
+  }
+
+  bool canHandleObserve() override {
+    // Do not compute <H> from the state if shots based sampling requested
+    if (executionContext &&
+        executionContext->shots != static_cast<std::size_t>(-1)) {
+      return false;
+    }
+
+    return !shouldObserveFromSampling();
+  }
+
+  /// @brief Compute <psi|H|psi> term by term, directly from the state.
+  cudaq::observe_result observe(const cudaq::spin_op &op) override {
+    flushGateQueue();
+    double ee = 0.0;
+    op.for_each_term([&](cudaq::spin_op &term) {
+      const auto masks = cpu::getPauliMasks(term);
+      ee += term.get_coefficient().real() *
+            expectationPauli(masks.xMask, masks.zMask, masks.nY);
+    });
+    return cudaq::observe_result(ee, op,
+                                 cudaq::sample_result(cudaq::ExecutionResult(
+                                     {}, op.to_string(false), ee)));
+  }
+
+  /// @brief Reset the qubit to |0>.
+  void resetQubit(const std::size_t index) override {
+    flushGateQueue();
+    flushAnySamplingTasks();
+    if (measureQubit(index))
+      applyGate(GateApplicationTask("x", {0, 1, 1, 0}, {}, {index}, {}));
+  }
+
+  /// @brief Sample the multi-qubit state.
+  cudaq::ExecutionResult sample(const std::vector<std::size_t> &qubits,
+                                const int shots) override {
+    std::size_t zMask = 0;
+    for (auto q : qubits)
+      zMask |= 1ULL << q;
+    if (shots < 1) {
+      const double expectationValue = expectationPauli(0, zMask, 0);
+      cudaq::info("Computed expectation value = {}", expectationValue);
+      return cudaq::ExecutionResult{{}, expectationValue};
+    }
+
+    const double total = expectationPauli(0, 0, 0);
+    std::uniform_real_distribution<double> uniform(0.0, total);
+    std::vector<double> draws(shots);
+    for (auto &draw : draws)
+      draw = uniform(randomEngine);
+    std::sort(draws.begin(), draws.end());
+    auto outcomes =
+        isDense()
+            ? cpu::resolveDraws(denseState.data(), denseState.size(), draws)
+            : resolveSparseDraws(draws);
+    // Pack the measured bits of each outcome, bit k being `qubits[k]`.
+    for (auto &outcome : outcomes) {
+      std::size_t packed = 0;
+      for (std::size_t k = 0; k < qubits.size(); ++k)
+        packed |= ((outcome >> qubits[k]) & 1) << k;
+      outcome = packed;
+    }
+    return cpu::countOutcomes(outcomes, qubits.size());
+  }
+
+  /// @brief Create a state from the data without expanding the current one.
+  std::unique_ptr<cudaq::SimulationState>
+  createStateFromData(const cudaq::state_data &data) override {
+    return CpuState<double>(std::vector<Amplitude>{}).createFromData(data);
+  }
+
+  /// @brief Return the state vector, which must fit in memory.
+  std::unique_ptr<cudaq::SimulationState> getSimulationState() override {
+    flushGateQueue();
+    return std::make_unique<CpuState<double>>(getDenseState());
+  }
+
+  /// @brief Primarily used for testing.
+  std::vector<Amplitude> getStateVector() {
+    flushGateQueue();
+    return getDenseState();
+  }
+
+  /// @brief Return the number of stored amplitudes, i.e. the number of
+  /// non-zero amplitudes of a sparse state, or the dimension of a dense one.
+  std::size_t getNumAmplitudes() {
+    flushGateQueue();
+    return isDense() ? denseState.size() : amplitudes.size();
+  }
+
+  std::string name() const override { return "cpu-sparse"; }
+  NVQIR_SIMULATOR_CLONE_IMPL(CpuSparseCircuitSimulator)
+};
+
+} // namespace nvqir
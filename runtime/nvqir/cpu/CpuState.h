@@ -0,0 +1,218 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CpuStateVectorKernels.h"
+#include "common/FmtCore.h"
+#include "common/SimulationState.h"
+
+#include <ostream>
+#include <stdexcept>
+
+namespace nvqir {
+
+/// @brief Copy \p size amplitudes of the given precision from \p data,
+/// converting them to `ScalarType`.
+template <typename ScalarType>
+std::vector<std::complex<ScalarType>>
+convertAmplitudes(const void *data, std::size_t size,
+                  cudaq::SimulationState::precision dataPrecision) {
+  std::vector<std::complex<ScalarType>> result(size);
+  const auto convert = [&](const auto *in) {
+    for (std::size_t i = 0; i < size; ++i)
+      result[i] = {static_cast<ScalarType>(in[i].real()),
+                   static_cast<ScalarType>(in[i].imag())};
+  };
+  if (dataPrecision == cudaq::SimulationState::precision::fp32)
+    convert(reinterpret_cast<const std::complex<float> *>(data));
+  else
+    convert(reinterpret_cast<const std::complex<double> *>(data));
+  return result;
+}
+
+/// @brief Return the host amplitudes of \p state, converted to `ScalarType`.
+template <typename ScalarType>
+std::vector<std::complex<ScalarType>>
+getHostAmplitudes(const cudaq::SimulationState &state) {
+  if (!state.isArrayLike() || state.getNumTensors() != 1)
+    throw std::invalid_argument(
+        "[cpu-state] expected a state vector as input state.");
+  const auto tensor = state.getTensor();
+  const auto size = tensor.get_num_elements();
+  if (!state.isDeviceData())
+    return convertAmplitudes<ScalarType>(tensor.data, size,
+                                         tensor.fp_precision);
+
+  if (tensor.fp_precision == cudaq::SimulationState::precision::fp32) {
+    std::vector<std::complex<float>> host(size);
+    state.toHost(host.data(), size);
+    return convertAmplitudes<ScalarType>(host.data(), size,
+                                         tensor.fp_precision);
+  }
+  std::vector<std::complex<double>> host(size);
+  state.toHost(host.data(), size);
+  return convertAmplitudes<ScalarType>(host.data(), size, tensor.fp_precision);
+}
+
+/// @brief CpuState provides an implementation of `SimulationState` that
+/// encapsulates the state vector of the CPU state vector simulators, in
+/// single or double precision. States can be created from, compared with and
+/// copied to data of either precision, which is converted as needed.
+template <typename ScalarType>
+class CpuState : public cudaq::SimulationState {
+private:
+  /// @brief The state amplitudes. This class takes ownership.
+  std::vector<std::complex<ScalarType>> state;
+
+protected:
+  std::unique_ptr<SimulationState>
+  createFromSizeAndPtr(std::size_t size, void *ptr,
+                       std::size_t dataType) override {
+    // Even state_data alternatives are fp64, odd ones fp32.
+    return std::make_unique<CpuState<ScalarType>>(convertAmplitudes<ScalarType>(
+        ptr, size, dataType % 2 ? precision::fp32 : precision::fp64));
+  }
+
+public:
+  CpuState(std::vector<std::complex<ScalarType>> &&data)
+      : state(std::move(data)) {}
+
+  /// @brief Create the state from flat data of either precision.
+  std::unique_ptr<cudaq::SimulationState>
+  createFromData(const cudaq::state_data &data) override {
+    std::tuple<std::size_t, void *> sizeAndPtr;
+    switch (data.index()) {
+    case 0:
+      sizeAndPtr = getSizeAndPtrFromVec<double, double>(data);
+      break;
+    case 1:
+      sizeAndPtr = getSizeAndPtrFromVec<float, float>(data);
+      break;
+    case 2:
+      sizeAndPtr = getSizeAndPtrFromPair<double, double>(data);
+      break;
+    case 3:
+      sizeAndPtr = getSizeAndPtrFromPair<float, float>(data);
+      break;
+    default:
+      return SimulationState::createFromData(data);
+    }
+    auto [size, ptr] = sizeAndPtr;
+    return createFromSizeAndPtr(size, ptr, data.index());
+  }
+
+  /// @brief Return the amplitudes, primarily used by the simulator.
+  const std::vector<std::complex<ScalarType>> &getAmplitudes() const {
+    return state;
+  }
+
+  std::size_t getNumQubits() const override { return std::log2(state.size()); }
+
+  std::complex<double> overlap(const cudaq::SimulationState &other) override {
+    if (other.getNumTensors() != 1 ||
+        (other.getTensor().extents != getTensor().extents))
+      throw std::runtime_error("[cpu-state] overlap error - other state "
+                               "dimension not equal to this state dimension.");
+
+    const auto tensor = other.getTensor();
+    if (!other.isDeviceData() && tensor.fp_precision == getPrecision())
+      return std::abs(cpu::innerProduct(
+          state.data(),
+          reinterpret_cast<const std::complex<ScalarType> *>(tensor.data),
+          state.size()));
+    const auto otherState = getHostAmplitudes<double>(other);
+    return std::abs(
+        cpu::innerProduct(state.data(), otherState.data(), state.size()));
+  }
+
+  std::complex<double>
+  getAmplitude(const std::vector<int> &basisState) override {
+    if (getNumQubits() != basisState.size())
+      throw std::runtime_error(fmt::format(
+          "[cpu-state] getAmplitude with an invalid number of bits in the "
+          "basis state: expected {}, provided {}.",
+          getNumQubits(), basisState.size()));
+    if (std::any_of(basisState.begin(), basisState.end(),
+                    [](int x) { return x != 0 && x != 1; }))
+      throw std::runtime_error(
+          "[cpu-state] getAmplitude with an invalid basis state: only "
+          "qubit state (0 or 1) is supported.");
+
+    // Convert the basis state to an index value
+    const std::size_t idx = std::accumulate(
+        std::make_reverse_iterator(basisState.end()),
+        std::make_reverse_iterator(basisState.begin()), 0ull,
+        [](std::size_t acc, int bit) { return (acc << 1) + bit; });
+    return state[idx];
+  }
+
+  Tensor getTensor(std::size_t tensorIdx = 0) const override {
+    if (tensorIdx != 0)
+      throw std::runtime_error("[cpu-state] invalid tensor requested.");
+    return Tensor{reinterpret_cast<void *>(
+                      const_cast<std::complex<ScalarType> *>(state.data())),
+                  std::vector<std::size_t>{state.size()}, getPrecision()};
+  }
+
+  /// @brief Return all tensors that represent this state
+  std::vector<Tensor> getTensors() const override { return {getTensor()}; }
+
+  /// @brief Return the number of tensors that represent this state.
+  std::size_t getNumTensors() const override { return 1; }
+
+  std::complex<double>
+  operator()(std::size_t tensorIdx,
+             const std::vector<std::size_t> &indices) override {
+    if (tensorIdx != 0)
+      throw std::runtime_error("[cpu-state] invalid tensor requested.");
+    if (indices.size() != 1)
+      throw std::runtime_error("[cpu-state] invalid element extraction.");
+
+    return state[indices[0]];
+  }
+
+  void dump(std::ostream &os) const override {
+    for (auto &amplitude : state)
+      os << amplitude << "\n";
+  }
+
+  precision getPrecision() const override {
+    if constexpr (std::is_same_v<ScalarType, float>)
+      return cudaq::SimulationState::precision::fp32;
+
+    return cudaq::SimulationState::precision::fp64;
+  }
+
+  /// @brief Copy the amplitudes to the user-provided buffer, converting them
+  /// to double precision if needed.
+  void toHost(std::complex<double> *userData,
+              std::size_t numElements) const override {
+    if (numElements != state.size())
+      throw std::runtime_error("[cpu-state] provided toHost pointer has "
+                               "invalid number of elements specified.");
+    std::copy(state.begin(), state.end(), userData);
+  }
+
+  /// @brief Copy the amplitudes to the user-provided buffer, converting them
+  /// to single precision if needed.
+  void toHost(std::complex<float> *userData,
+              std::size_t numElements) const override {
+    if (numElements != state.size())
+      throw std::runtime_error("[cpu-state] provided toHost pointer has "
+                               "invalid number of elements specified.");
+    std::copy(state.begin(), state.end(), userData);
+  }
+
+  void destroyState() override {
+    std::vector<std::complex<ScalarType>> empty;
+    state.swap(empty);
+  }
+};
+
+} // namespace nvqir
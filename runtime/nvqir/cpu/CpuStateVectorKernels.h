@@ -0,0 +1,441 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include "common/MeasureCounts.h"
+#include "cudaq/spin_op.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+/// State vector kernels shared by the CPU simulators. They operate on a raw
+/// array of `dim` amplitudes, where qubit q is bit q of the amplitude index,
+/// and are templated on the floating point type of the amplitudes. Reductions
+/// are always accumulated in double precision.
+namespace nvqir::cpu {
+
+/// @brief States smaller than this are processed on a single thread.
+constexpr std::size_t minParallelDimension = 1ULL << 12;
+
+/// @brief Complex multiplication without the NaN / infinity recovery of
+/// `std::complex::operator*`, which prevents vectorization.
+template <typename ScalarType>
+inline std::complex<ScalarType> multiply(std::complex<ScalarType> a,
+                                         std::complex<ScalarType> b) {
+  return {a.real() * b.real() - a.imag() * b.imag(),
+          a.real() * b.imag() + a.imag() * b.real()};
+}
+
+/// @brief Insert a zero bit at position \p bit of \p index.
+inline std::size_t insertZeroBit(std::size_t index, std::size_t bit) {
+  const std::size_t lowMask = (1ULL << bit) - 1;
+  return ((index & ~lowMask) << 1) | (index & lowMask);
+}
+
+/// @brief Apply the row-major 2x2 \p matrix to the \p target qubit.
+///
+/// The amplitude pairs are visited in blocks of 2^target contiguous
+/// amplitudes, with the complex arithmetic spelled out on the interleaved
+/// real and imaginary parts so that the inner loop vectorizes.
+template <typename ScalarType>
+void applyOneQubitMatrix(std::complex<ScalarType> *state, std::size_t dim,
+                         const std::complex<ScalarType> *matrix,
+                         std::size_t target) {
+  const std::int64_t half = 1LL << target;
+  const std::int64_t numBlocks = dim >> (target + 1);
+  const ScalarType m00r = matrix[0].real(), m00i = matrix[0].imag();
+  const ScalarType m01r = matrix[1].real(), m01i = matrix[1].imag();
+  const ScalarType m10r = matrix[2].real(), m10i = matrix[2].imag();
+  const ScalarType m11r = matrix[3].real(), m11i = matrix[3].imag();
+  auto *data = reinterpret_cast<ScalarType *>(state);
+
+  const auto applyToBlock = [&](std::int64_t b, std::int64_t begin,
+                                std::int64_t end) {
+    ScalarType *lo = data + 4 * b * half;
+    ScalarType *hi = lo + 2 * half;
+#if defined(_OPENMP)
+#pragma omp simd
+#endif
+    for (std::int64_t k = begin; k < end; ++k) {
+      const ScalarType ar = lo[2 * k], ai = lo[2 * k + 1];
+      const ScalarType br = hi[2 * k], bi = hi[2 * k + 1];
+      lo[2 * k] = m00r * ar - m00i * ai + m01r * br - m01i * bi;
+      lo[2 * k + 1] = m00r * ai + m00i * ar + m01r * bi + m01i * br;
+      hi[2 * k] = m10r * ar - m10i * ai + m11r * br - m11i * bi;
+      hi[2 * k + 1] = m10r * ai + m10i * ar + m11r * bi + m11i * br;
+    }
+  };
+
+  // Split the work over the blocks for low targets, and within each block
+  // for high targets (few large blocks).
+  if (numBlocks >= half) {
+#if defined(_OPENMP)
+#pragma omp parallel for if (dim >= minParallelDimension)
+#endif
+    for (std::int64_t b = 0; b < numBlocks; ++b)
+      applyToBlock(b, 0, half);
+    return;
+  }
+
+  for (std::int64_t b = 0; b < numBlocks; ++b) {
+#if defined(_OPENMP)
+#pragma omp parallel if (dim >= minParallelDimension)
+    {
+      const std::int64_t numThreads = omp_get_num_threads();
+      const std::int64_t chunk = (half + numThreads - 1) / numThreads;
+      const std::int64_t begin = std::min(half, omp_get_thread_num() * chunk);
+      applyToBlock(b, begin, std::min(half, begin + chunk));
+    }
+#else
+    applyToBlock(b, 0, half);
+#endif
+  }
+}
+
+/// @brief Apply the row-major \p matrix on \p targets, controlled on all the
+/// \p controls being set. Bit k of the matrix row / column index is the value
+/// of `targets[k]`.
+template <typename ScalarType>
+void applyMatrix(std::complex<ScalarType> *state, std::size_t dim,
+                 const std::vector<std::complex<ScalarType>> &matrix,
+                 const std::vector<std::size_t> &controls,
+                 const std::vector<std::size_t> &targets) {
+  if (controls.empty() && targets.size() == 1)
+    return applyOneQubitMatrix(state, dim, matrix.data(), targets[0]);
+
+  std::vector<std::size_t> qubits(controls);
+  qubits.insert(qubits.end(), targets.begin(), targets.end());
+  std::sort(qubits.begin(), qubits.end());
+  std::size_t controlMask = 0;
+  for (auto c : controls)
+    controlMask |= 1ULL << c;
+
+  // Offsets of the amplitudes mixed by the matrix, from the index of the
+  // group where all the targets are zero.
+  const std::size_t numRows = 1ULL << targets.size();
+  std::vector<std::size_t> offsets(numRows, 0);
+  for (std::size_t r = 0; r < numRows; ++r)
+    for (std::size_t t = 0; t < targets.size(); ++t)
+      if ((r >> t) & 1)
+        offsets[r] |= 1ULL << targets[t];
+
+  const std::int64_t numGroups = dim >> qubits.size();
+#if defined(_OPENMP)
+#pragma omp parallel if (dim >= minParallelDimension)
+#endif
+  {
+    std::vector<std::complex<ScalarType>> in(numRows);
+#if defined(_OPENMP)
+#pragma omp for
+#endif
+    for (std::int64_t g = 0; g < numGroups; ++g) {
+      std::size_t base = g;
+      for (auto q : qubits)
+        base = insertZeroBit(base, q);
+      base |= controlMask;
+      for (std::size_t c = 0; c < numRows; ++c)
+        in[c] = state[base | offsets[c]];
+      for (std::size_t r = 0; r < numRows; ++r) {
+        std::complex<ScalarType> acc = 0;
+        for (std::size_t c = 0; c < numRows; ++c)
+          acc += multiply(matrix[r * numRows + c], in[c]);
+        state[base | offsets[r]] = acc;
+      }
+    }
+  }
+}
+
+/// @brief Return the total probability of the amplitudes whose index has all
+/// the bits of \p mask set to \p value.
+template <typename ScalarType>
+double probability(const std::complex<ScalarType> *state, std::size_t dim,
+                   std::size_t mask, std::size_t value) {
+  double prob = 0.0;
+#if defined(_OPENMP)
+#pragma omp parallel for reduction(+ : prob) if (dim >= minParallelDimension)
+#endif
+  for (std::int64_t i = 0; i < static_cast<std::int64_t>(dim); ++i)
+    if ((i & mask) == value)
+      prob += std::norm(state[i]);
+  return prob;
+}
+
+/// @brief Zero the amplitudes whose bit \p qubit is not \p result and scale
+/// the others by \p scale.
+template <typename ScalarType>
+void collapse(std::complex<ScalarType> *state, std::size_t dim,
+              std::size_t qubit, bool result, double scale) {
+  const std::size_t mask = 1ULL << qubit;
+  const ScalarType factor = scale;
+#if defined(_OPENMP)
+#pragma omp parallel for if (dim >= minParallelDimension)
+#endif
+  for (std::int64_t i = 0; i < static_cast<std::int64_t>(dim); ++i)
+    state[i] = static_cast<bool>(i & mask) == result ? state[i] * factor
+                                                     : ScalarType(0);
+}
+
+/// @brief Set the state to |0...0>.
+template <typename ScalarType>
+void setZeroState(std::complex<ScalarType> *state, std::size_t dim) {
+#if defined(_OPENMP)
+#pragma omp parallel for if (dim >= minParallelDimension)
+#endif
+  for (std::int64_t i = 0; i < static_cast<std::int64_t>(dim); ++i)
+    state[i] = 0;
+  state[0] = 1;
+}
+
+/// @brief Return the expectation value of the Z operators on the bits of
+/// \p zMask.
+template <typename ScalarType>
+double expectationZ(const std::complex<ScalarType> *state, std::size_t dim,
+                    std::size_t zMask) {
+  double ee = 0.0;
+#if defined(_OPENMP)
+#pragma omp parallel for reduction(+ : ee) if (dim >= minParallelDimension)
+#endif
+  for (std::int64_t i = 0; i < static_cast<std::int64_t>(dim); ++i)
+    ee += std::popcount(i & zMask) % 2 == 0 ? std::norm(state[i])
+                                            : -std::norm(state[i]);
+  return ee;
+}
+
+/// @brief Return <psi|P|psi> for the Pauli product P with X and Y bits
+/// \p xMask, Z and Y bits \p zMask and \p nY Y's, i.e. P|j> = i^nY
+/// (-1)^popcount(j & zMask) |j ^ xMask>.
+template <typename ScalarType>
+double expectationPauli(const std::complex<ScalarType> *state,
+                        std::size_t dim, std::size_t xMask, std::size_t zMask,
+                        std::size_t nY) {
+  if (xMask == 0)
+    return expectationZ(state, dim, zMask);
+  // Sum of conj(psi[j ^ xMask]) (-1)^popcount(j & zMask) psi[j], times i^nY.
+  double re = 0.0, im = 0.0;
+#if defined(_OPENMP)
+#pragma omp parallel for reduction(+ : re, im) if (dim >= minParallelDimension)
+#endif
+  for (std::int64_t j = 0; j < static_cast<std::int64_t>(dim); ++j) {
+    const std::complex<double> a = state[j ^ xMask];
+    const std::complex<double> b = state[j];
+    const double sign = std::popcount(j & zMask) % 2 == 0 ? 1.0 : -1.0;
+    re += sign * (a.real() * b.real() + a.imag() * b.imag());
+    im += sign * (a.real() * b.imag() - a.imag() * b.real());
+  }
+  // The result is real for a hermitian P.
+  switch (nY % 4) {
+  case 0:
+    return re;
+  case 1:
+    return -im;
+  case 2:
+    return -re;
+  default:
+    return im;
+  }
+}
+
+/// @brief Apply exp(i theta P), controlled on the bits of \p controlMask, for
+/// the Pauli product P described as in `expectationPauli`. Amplitude pairs
+/// (j, j ^ xMask) are mixed together, or just phased if \p xMask is 0.
+template <typename ScalarType>
+void applyExpPauli(std::complex<ScalarType> *state, std::size_t dim,
+                   double theta, std::size_t xMask, std::size_t zMask,
+                   std::size_t nY, std::size_t controlMask) {
+  using Complex = std::complex<ScalarType>;
+  const ScalarType cosTheta = std::cos(theta);
+  const ScalarType sinTheta = std::sin(theta);
+  const std::int64_t signedDim = dim;
+
+  if (xMask == 0) {
+    const Complex phases[] = {{cosTheta, sinTheta}, {cosTheta, -sinTheta}};
+#if defined(_OPENMP)
+#pragma omp parallel for if (dim >= minParallelDimension)
+#endif
+    for (std::int64_t j = 0; j < signedDim; ++j)
+      if ((j & controlMask) == controlMask)
+        state[j] = multiply(state[j], phases[std::popcount(j & zMask) % 2]);
+    return;
+  }
+
+  // i sin(theta) i^nY, the coefficient of P|j> for even parity.
+  static constexpr std::complex<double> powersOfI[] = {
+      {1., 0.}, {0., 1.}, {-1., 0.}, {0., -1.}};
+  const std::complex<double> phase =
+      std::complex<double>(0., sinTheta) * powersOfI[nY % 4];
+  const Complex iSinPhase(phase.real(), phase.imag());
+
+  // Visit each pair once, from the member with the top bit of `xMask` cleared.
+  const std::size_t pivot = std::bit_width(xMask) - 1;
+#if defined(_OPENMP)
+#pragma omp parallel for if (dim >= minParallelDimension)
+#endif
+  for (std::int64_t i = 0; i < signedDim / 2; ++i) {
+    const std::size_t j = insertZeroBit(i, pivot);
+    if ((j & controlMask) != controlMask)
+      continue;
+    const std::size_t k = j ^ xMask;
+    const Complex a = state[j];
+    const Complex b = state[k];
+    const ScalarType signK = std::popcount(k & zMask) % 2 == 0 ? 1 : -1;
+    const ScalarType signJ = std::popcount(j & zMask) % 2 == 0 ? 1 : -1;
+    state[j] = cosTheta * a + signK * multiply(iSinPhase, b);
+    state[k] = cosTheta * b + signJ * multiply(iSinPhase, a);
+  }
+}
+
+/// @brief Pauli product masks, see `expectationPauli`.
+struct PauliMasks {
+  std::size_t xMask = 0;
+  std::size_t zMask = 0;
+  std::size_t nY = 0;
+};
+
+/// @brief Return the masks of the single-term \p op, whose qubit i acts on
+/// the qubit `qubitIds[i]` (or i if \p qubitIds is empty).
+inline PauliMasks getPauliMasks(const cudaq::spin_op &op,
+                                const std::vector<std::size_t> &qubitIds = {}) {
+  PauliMasks masks;
+  op.for_each_pauli([&](cudaq::pauli type, std::size_t idx) {
+    const std::size_t bit = 1ULL << (qubitIds.empty() ? idx : qubitIds[idx]);
+    if (type == cudaq::pauli::X || type == cudaq::pauli::Y)
+      masks.xMask |= bit;
+    if (type == cudaq::pauli::Z || type == cudaq::pauli::Y)
+      masks.zMask |= bit;
+    if (type == cudaq::pauli::Y)
+      masks.nY++;
+  });
+  return masks;
+}
+
+/// @brief Return the total probability of each block of \p blockSize
+/// amplitudes.
+template <typename ScalarType>
+std::vector<double> blockProbabilities(const std::complex<ScalarType> *state,
+                                       std::size_t dim, std::size_t blockSize) {
+  const std::int64_t numBlocks = (dim + blockSize - 1) / blockSize;
+  std::vector<double> probs(numBlocks, 0.0);
+#if defined(_OPENMP)
+#pragma omp parallel for if (dim >= minParallelDimension)
+#endif
+  for (std::int64_t b = 0; b < numBlocks; ++b) {
+    const std::size_t end = std::min(dim, (b + 1) * blockSize);
+    double sum = 0.0;
+    for (std::size_t i = b * blockSize; i < end; ++i)
+      sum += std::norm(state[i]);
+    probs[b] = sum;
+  }
+  return probs;
+}
+
+/// @brief Resolve the sorted cumulative probability \p draws to amplitude
+/// indices: draw d selects the first index at which the running sum of the
+/// probabilities, starting from \p start, exceeds it. The draws must not be
+/// below \p start.
+///
+/// The state is split into blocks whose total probabilities are computed
+/// first, so that each block can then resolve its own draws in parallel,
+/// i.e. O(dim + shots) with no per-shot allocation.
+template <typename ScalarType>
+std::vector<std::size_t> resolveDraws(const std::complex<ScalarType> *state,
+                                      std::size_t dim,
+                                      const std::vector<double> &draws,
+                                      double start = 0.0) {
+  constexpr std::size_t blockSize = 1ULL << 14;
+  auto blockStart = blockProbabilities(state, dim, blockSize);
+  blockStart.insert(blockStart.begin(), start);
+  std::partial_sum(blockStart.begin(), blockStart.end(), blockStart.begin());
+  // The last block with a non-zero probability also takes the draws past the
+  // total due to rounding.
+  std::int64_t numBlocks = blockStart.size() - 1;
+  while (numBlocks > 1 && blockStart[numBlocks] == blockStart[numBlocks - 1])
+    --numBlocks;
+
+  std::vector<std::size_t> indices(draws.size());
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic) if (dim >= minParallelDimension)
+#endif
+  for (std::int64_t b = 0; b < numBlocks; ++b) {
+    const auto firstDraw =
+        b == 0 ? draws.begin()
+               : std::lower_bound(draws.begin(), draws.end(), blockStart[b]);
+    const auto lastDraw =
+        b == numBlocks - 1
+            ? draws.end()
+            : std::lower_bound(firstDraw, draws.end(), blockStart[b + 1]);
+    if (firstDraw == lastDraw)
+      continue;
+    const std::size_t end = std::min(dim, (b + 1) * blockSize);
+    std::size_t i = b * blockSize;
+    // Guard against rounding landing on a zero-probability amplitude at the
+    // end of the block.
+    std::size_t lastNonZero = i;
+    double acc = blockStart[b];
+    for (auto d = firstDraw; d != lastDraw; ++d) {
+      while (i + 1 < end && acc + std::norm(state[i]) <= *d) {
+        if (std::norm(state[i]) > 0.0)
+          lastNonZero = i;
+        acc += std::norm(state[i]);
+        ++i;
+      }
+      indices[d - draws.begin()] = std::norm(state[i]) > 0.0 ? i : lastNonZero;
+    }
+  }
+  return indices;
+}
+
+/// @brief Count the packed \p outcomes, whose bit k is the result of the
+/// k-th of the \p numBits measured qubits, sorting them in place. The
+/// expectation value is that of the Z operators on all measured qubits.
+inline cudaq::ExecutionResult
+countOutcomes(std::vector<std::size_t> &outcomes, std::size_t numBits) {
+  double expVal = 0.0;
+  for (auto outcome : outcomes)
+    expVal += std::popcount(outcome) % 2 == 0 ? 1.0 : -1.0;
+  std::sort(outcomes.begin(), outcomes.end());
+
+  cudaq::ExecutionResult counts;
+  std::string bitstring(numBits, '0');
+  for (auto first = outcomes.begin(); first != outcomes.end();) {
+    const auto last = std::upper_bound(first, outcomes.end(), *first);
+    for (std::size_t k = 0; k < numBits; ++k)
+      bitstring[k] = ((*first >> k) & 1) ? '1' : '0';
+    counts.appendResult(bitstring, last - first);
+    first = last;
+  }
+  counts.expectationValue = expVal / outcomes.size();
+  return counts;
+}
+
+/// @brief Return <a|b>.
+template <typename ScalarTypeA, typename ScalarTypeB>
+std::complex<double> innerProduct(const std::complex<ScalarTypeA> *a,
+                                  const std::complex<ScalarTypeB> *b,
+                                  std::size_t dim) {
+  double re = 0.0, im = 0.0;
+#if defined(_OPENMP)
+#pragma omp parallel for reduction(+ : re, im) if (dim >= minParallelDimension)
+#endif
+  for (std::int64_t i = 0; i < static_cast<std::int64_t>(dim); ++i) {
+    const std::complex<double> x = a[i], y = b[i];
+    re += x.real() * y.real() + x.imag() * y.imag();
+    im += x.real() * y.imag() - x.imag() * y.real();
+  }
+  return {re, im};
+}
+
+} // namespace nvqir::cpu
@@ -8,10 +8,13 @@
 
 #include "nvqir/CircuitSimulator.h"
 #include "nvqir/Gates.h"
+#include "nvqir/cpu/CpuStateVectorKernels.h"
 
 #include <bit>
 #include <iostream>
+#include <numeric>
 #include <qpp.h>
+#include <random>
 #include <set>
 #include <span>
 
@@ -174,6 +177,31 @@ protected:
     return std::accumulate(result.begin(), result.end(), 0.0);
   }
 
+  /// @brief Sample the state vector \p shots times, returning the outcomes
+  /// packed as integers whose bit k is the value of `qubits[k]`.
+  ///
+  /// The sorted uniform draws are matched against the running sum of the
+  /// probabilities in a single pass over the state (see
+  /// `cpu::resolveDraws`), with no per-shot allocation.
+  std::vector<std::size_t>
+  sampleOutcomes(const std::vector<std::size_t> &qubits, std::size_t shots) {
+    static_assert(std::is_same_v<StateType, qpp::ket>);
+    const double total = cpu::probability(state.data(), stateDimension, 0, 0);
+    std::uniform_real_distribution<double> uniform(0.0, total);
+    auto &prng = qpp::RandomDevices::get_instance().get_prng();
+    std::vector<double> draws(shots);
+    for (auto &draw : draws)
+      draw = uniform(prng);
+    std::sort(draws.begin(), draws.end());
+    const auto indices = cpu::resolveDraws(state.data(), stateDimension, draws);
+
+    std::vector<std::size_t> outcomes(shots);
+    for (std::size_t d = 0; d < shots; ++d)
+      for (std::size_t k = 0; k < qubits.size(); ++k)
+        outcomes[d] |= ((indices[d] >> qubits[k]) & 1) << k;
+    return outcomes;
+  }
+
   qpp::cmat toQppMatrix(const std::vector<std::complex<double>> &data,
                         std::size_t nTargets) {
     auto nRows = (1UL << nTargets);
@@ -208,13 +236,12 @@ protected:
         state = qpp::ket::Map(stateData, stateDimension);
       return;
     }
-    // If we are resizing an existing, allocate
-    // a zero state on a n qubit, and Kron-prod
-    // that with the existing state.
+    // If we are resizing an existing state, the new qubits in |0> are the
+    // most significant ones, i.e., |0..0> (x) |psi> is |psi> followed by zeros.
+    // Grow the buffer in place (this is a realloc) and zero the new
+    // amplitudes, rather than allocating a Kron-product.
     if (stateData == nullptr) {
-      qpp::ket zero_state = qpp::ket::Zero((1UL << qubitCount));
-      zero_state(0) = 1.0;
-      state = qpp::kron(zero_state, state);
+      state.conservativeResizeLike(qpp::ket::Zero(stateDimension));
     } else {
       qpp::ket initState = qpp::ket::Map(stateData, (1UL << qubitCount));
       state = qpp::kron(initState, state);
@@ -268,6 +295,21 @@ protected:
   /// @brief Measure the qubit and return the result. Collapse the
   /// state vector.
   bool measureQubit(const std::size_t index) override {
+    if constexpr (std::is_same_v<StateType, qpp::ket>) {
+      // Collapse in place: one pass to get the probability of |1>, then one
+      // pass to zero the amplitudes of the other outcome and renormalize.
+      const std::size_t mask = 1ULL << index;
+      const double probOne =
+          cpu::probability(state.data(), stateDimension, mask, mask);
+      const bool result =
+          std::uniform_real_distribution<double>(0.0, 1.0)(
+              qpp::RandomDevices::get_instance().get_prng()) < probOne;
+      cpu::collapse(state.data(), stateDimension, index, result,
+                    1.0 / std::sqrt(result ? probOne : 1.0 - probOne));
+      cudaq::info("Measured qubit {} -> {}", index, result);
+      return result;
+    }
+
     const auto qubitIdx = convertQubitIndex(index);
     // If here, then we care about the result bit, so compute it.
     const auto measurement_tuple =
@@ -348,6 +390,35 @@ public:
                                      {}, op.to_string(false), ee)));
   }
 
+  /// @brief Apply exp(i theta P) to the state vector in a single pass (see
+  /// `cpu::applyExpPauli`), rather than through the basis change and CNOT
+  /// ladder decomposition of the base class.
+  void applyExpPauli(double theta, const std::vector<std::size_t> &controls,
+                     const std::vector<std::size_t> &qubitIds,
+                     const cudaq::spin_op &op) override {
+    // The decomposition is still used to trace the gates or apply noise.
+    if constexpr (std::is_same_v<StateType, qpp::ket>) {
+      if (!op.is_identity() &&
+          !(executionContext && (executionContext->name == "tracer" ||
+                                 executionContext->noiseModel))) {
+        flushGateQueue();
+        cudaq::info(" [qpp] exp_pauli({}, {})", theta, op.to_string(false));
+        const auto masks = cpu::getPauliMasks(op, qubitIds);
+        std::size_t controlMask = 0;
+        for (auto c : controls)
+          controlMask |= 1ULL << c;
+        if (summaryData.enabled)
+          summaryData.svGateUpdate(
+              controls.size(), std::popcount(masks.xMask | masks.zMask),
+              stateDimension, stateDimension * sizeof(std::complex<double>));
+        cpu::applyExpPauli(state.data(), stateDimension, theta, masks.xMask,
+                           masks.zMask, masks.nY, controlMask);
+        return;
+      }
+    }
+    CircuitSimulatorBase<double>::applyExpPauli(theta, controls, qubitIds, op);
+  }
+
   /// @brief Reset the qubit
   /// @param index 0-based index of qubit to reset
   void resetQubit(const std::size_t index) override {
@@ -366,6 +437,13 @@ public:
       return cudaq::ExecutionResult{{}, expectationValue};
     }
 
+    if constexpr (std::is_same_v<StateType, qpp::ket>) {
+      if (qubits.size() <= 64) {
+        auto outcomes = sampleOutcomes(qubits, shots);
+        return cpu::countOutcomes(outcomes, qubits.size());
+      }
+    }
+
     std::vector<std::size_t> measuredBits;
     for (auto index : qubits) {
       measuredBits.push_back(convertQubitIndex(index));
@@ -214,9 +214,10 @@ protected:
 
     // We're adding qubits to an existing state.
     if (!stateDataIn) {
-      qpp::cmat zero_state = qpp::cmat::Zero(1 << qubitCount, 1 << qubitCount);
-      zero_state(0, 0) = 1.0;
-      state = qpp::kron(zero_state, state);
+      // |0..0><0..0| (x) rho is rho in the top left corner and zeros
+      // elsewhere, no need for a Kron-product.
+      state.conservativeResizeLike(
+          qpp::cmat::Zero(stateDimension, stateDimension));
     } else {
       // rho = |psi><psi|
       auto *stateData = reinterpret_cast<std::complex<double> *>(
@@ -0,0 +1,669 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include "nvqir/CircuitSimulator.h"
+#include "stim.h"
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <optional>
+#include <span>
+#include <unordered_map>
+
+namespace nvqir {
+
+/// @brief The NearCliffordCircuitSimulator simulates Clifford circuits with a
+/// few non-Clifford gates (T gates, arbitrary rotations, Toffoli gates, ...)
+/// on many qubits. The state is held as C |chi>, where the Clifford C is the
+/// tableau of a Stim tableau simulator and |chi> = sum_x a_x |x> is a sparse
+/// superposition of computational basis states.
+///
+/// Clifford gates are applied on the tableau only. Any other gate is expanded
+/// on Pauli operators, U = sum_P u_P P, so that U C |chi> = C (sum_P u_P
+/// C^-1 P C) |chi>, where the Paulis C^-1 P C are read from the inverse
+/// tableau and permute and rephase the basis states of |chi>. The number of
+/// terms of |chi> is thus only multiplied by 2 for each T gate or rotation
+/// (and at most by 4^k for each other k-qubit gate), independently of the
+/// number of qubits. Measurements never increase it: the measured Pauli is
+/// first made diagonal on |chi> by Clifford gates inserted at the beginning
+/// of the circuit, as done by Stim when collapsing its tableau.
+class NearCliffordCircuitSimulator
+    : public nvqir::CircuitSimulatorBase<double> {
+public:
+  /// @brief Packed bits, the bit k being for the qubit k.
+  using Bits = std::vector<std::uint64_t>;
+
+  /// @brief The Pauli operator i^phase X^xs Z^zs.
+  struct PauliOperator {
+    Bits xs;
+    Bits zs;
+    unsigned phase = 0;
+  };
+
+protected:
+  // Follow Stim naming convention (W) for bit width (required for templates).
+  static constexpr std::size_t W = stim::MAX_BITWORD_WIDTH;
+
+  using Amplitude = std::complex<double>;
+
+  struct BitsHash {
+    std::size_t operator()(const Bits &bits) const {
+      std::size_t hash = 0;
+      for (auto word : bits)
+        hash ^= word + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+      return hash;
+    }
+  };
+
+  /// @brief The amplitudes a_x of |chi>, by basis state x.
+  using Terms = std::unordered_map<Bits, Amplitude, BitsHash>;
+
+  /// @brief Amplitudes below this magnitude are dropped.
+  static constexpr double tolerance = 1e-12;
+
+  /// @brief Stim tableau simulator, holding the Clifford C.
+  std::unique_ptr<stim::TableauSimulator<W>> tableau;
+
+  /// @brief The terms of |chi>.
+  Terms terms;
+
+  /// @brief The number of qubits of the state.
+  std::size_t numQubits = 0;
+
+  /// @brief The maximum number of terms of |chi>.
+  std::size_t maxTerms = 1ULL << 22;
+
+  std::mt19937_64 randomEngine;
+
+  std::size_t numWords() const { return (numQubits + 63) / 64; }
+
+  static bool getBit(const Bits &bits, std::size_t k) {
+    return (bits[k / 64] >> (k % 64)) & 1;
+  }
+
+  static void flipBit(Bits &bits, std::size_t k) {
+    bits[k / 64] ^= 1ULL << (k % 64);
+  }
+
+  /// @brief Return the parity of the bits set in both \p a and \p b.
+  static bool parity(const Bits &a, const Bits &b) {
+    std::size_t count = 0;
+    for (std::size_t w = 0; w < a.size(); ++w)
+      count += std::popcount(a[w] & b[w]);
+    return count % 2;
+  }
+
+  static Amplitude phaseFactor(unsigned phase) {
+    static const Amplitude factors[] = {1.0, {0.0, 1.0}, -1.0, {0.0, -1.0}};
+    return factors[phase % 4];
+  }
+
+  PauliOperator identity() const {
+    return PauliOperator{Bits(numWords(), 0), Bits(numWords(), 0), 0};
+  }
+
+  /// @brief Return the product \p a \p b.
+  static PauliOperator multiply(const PauliOperator &a,
+                                const PauliOperator &b) {
+    // Moving X^b.xs left of Z^a.zs adds a -1 per common qubit.
+    PauliOperator product{a.xs, a.zs, a.phase + b.phase};
+    for (std::size_t w = 0; w < a.xs.size(); ++w) {
+      product.xs[w] ^= b.xs[w];
+      product.zs[w] ^= b.zs[w];
+    }
+    if (parity(a.zs, b.xs))
+      product.phase += 2;
+    return product;
+  }
+
+  /// @brief Convert a row of the inverse tableau, a Stim Pauli string whose
+  /// Y are X and Z bits set together, with Y = i X Z.
+  PauliOperator toPauliOperator(stim::PauliStringRef<W> row) const {
+    auto op = identity();
+    for (std::size_t k = 0; k < numQubits; ++k) {
+      const bool x = row.xs[k];
+      const bool z = row.zs[k];
+      if (x)
+        flipBit(op.xs, k);
+      if (z)
+        flipBit(op.zs, k);
+      if (x && z)
+        ++op.phase;
+    }
+    if (row.sign)
+      op.phase += 2;
+    return op;
+  }
+
+  /// @brief Return C^-1 P C for the Pauli \p type on \p qubit.
+  PauliOperator conjugate(cudaq::pauli type, std::size_t qubit) {
+    if (type == cudaq::pauli::X)
+      return toPauliOperator(tableau->inv_state.xs[qubit]);
+    if (type == cudaq::pauli::Z)
+      return toPauliOperator(tableau->inv_state.zs[qubit]);
+    if (type == cudaq::pauli::Y) {
+      auto op = multiply(conjugate(cudaq::pauli::X, qubit),
+                         conjugate(cudaq::pauli::Z, qubit));
+      ++op.phase;
+      return op;
+    }
+    return identity();
+  }
+
+  /// @brief Add \p coefficient \p op |\p in> to \p out.
+  static void accumulate(const PauliOperator &op, Amplitude coefficient,
+                         const Terms &in, Terms &out) {
+    const Amplitude factor = coefficient * phaseFactor(op.phase);
+    for (const auto &[basis, amplitude] : in) {
+      Bits key = basis;
+      for (std::size_t w = 0; w < key.size(); ++w)
+        key[w] ^= op.xs[w];
+      out[std::move(key)] +=
+          (parity(op.zs, basis) ? -factor : factor) * amplitude;
+    }
+  }
+
+  /// @brief Return <\p state| \p op |\p state>.
+  static Amplitude expectation(const PauliOperator &op, const Terms &state) {
+    Amplitude sum = 0.0;
+    Bits key;
+    for (const auto &[basis, amplitude] : state) {
+      key = basis;
+      for (std::size_t w = 0; w < key.size(); ++w)
+        key[w] ^= op.xs[w];
+      const auto iter = state.find(key);
+      if (iter == state.end())
+        continue;
+      const Amplitude value = std::conj(iter->second) * amplitude;
+      sum += parity(op.zs, basis) ? -value : value;
+    }
+    return phaseFactor(op.phase) * sum;
+  }
+
+  /// @brief Drop the negligible terms of |chi>, and throw if too many
+  /// remain.
+  void setTerms(Terms &&next) {
+    std::erase_if(next, [](const auto &term) {
+      return std::abs(term.second) < tolerance;
+    });
+    if (next.size() > maxTerms)
+      throw std::runtime_error(fmt::format(
+          "The near-Clifford simulator state has {} terms, more than the {} "
+          "allowed by CUDAQ_NEAR_CLIFFORD_MAX_TERMS. This circuit has too "
+          "many non-Clifford gates, use a state vector simulator instead.",
+          next.size(), maxTerms));
+    terms = std::move(next);
+  }
+
+  /// @brief Make the first of the Hermitian \p observables diagonal on
+  /// \p state, by applying the same Clifford gates V to \p state, to all the
+  /// \p observables (P -> V P V^-1) and, if \p updateTableau, at the
+  /// beginning of the tableau (C -> C V^-1) so that C |chi> is unchanged.
+  void diagonalize(Terms &state, std::span<PauliOperator> observables,
+                   bool updateTableau) {
+    auto &observable = observables.front();
+    std::size_t pivot = 0;
+    while (pivot < numQubits && !getBit(observable.xs, pivot))
+      ++pivot;
+    if (pivot == numQubits)
+      return;
+
+    std::optional<stim::TableauTransposedRaii<W>> transposed;
+    if (updateTableau)
+      transposed.emplace(tableau->inv_state);
+
+    // CNOTs from the pivot remove the other X of the observable.
+    Bits mask = observable.xs;
+    flipBit(mask, pivot);
+    if (std::any_of(mask.begin(), mask.end(), [](auto w) { return w; })) {
+      Terms next;
+      next.reserve(state.size());
+      for (auto &[basis, amplitude] : state) {
+        Bits key = basis;
+        if (getBit(key, pivot))
+          for (std::size_t w = 0; w < key.size(); ++w)
+            key[w] ^= mask[w];
+        next.emplace(std::move(key), amplitude);
+      }
+      state = std::move(next);
+      for (auto &op : observables) {
+        if (getBit(op.xs, pivot))
+          for (std::size_t w = 0; w < mask.size(); ++w)
+            op.xs[w] ^= mask[w];
+        if (parity(op.zs, mask))
+          flipBit(op.zs, pivot);
+      }
+      if (transposed)
+        for (std::size_t k = 0; k < numQubits; ++k)
+          if (getBit(mask, k))
+            transposed->append_ZCX(pivot, k);
+    }
+
+    // CZs from the pivot remove the other Z of the observable.
+    mask = observable.zs;
+    if (getBit(mask, pivot))
+      flipBit(mask, pivot);
+    if (std::any_of(mask.begin(), mask.end(), [](auto w) { return w; })) {
+      for (auto &[basis, amplitude] : state)
+        if (getBit(basis, pivot) && parity(basis, mask))
+          amplitude = -amplitude;
+      for (auto &op : observables) {
+        const bool flip = parity(op.xs, mask);
+        if (getBit(op.xs, pivot)) {
+          for (std::size_t w = 0; w < mask.size(); ++w)
+            op.zs[w] ^= mask[w];
+          if (flip)
+            op.phase += 2;
+        }
+        if (flip)
+          flipBit(op.zs, pivot);
+      }
+      if (transposed)
+        for (std::size_t k = 0; k < numQubits; ++k)
+          if (getBit(mask, k))
+            transposed->append_ZCZ(pivot, k);
+    }
+
+    // An S gate turns a Y on the pivot into an X.
+    if (getBit(observable.zs, pivot)) {
+      for (auto &[basis, amplitude] : state)
+        if (getBit(basis, pivot))
+          amplitude *= Amplitude(0.0, 1.0);
+      for (auto &op : observables)
+        if (getBit(op.xs, pivot)) {
+          ++op.phase;
+          flipBit(op.zs, pivot);
+        }
+      if (transposed)
+        transposed->append_S(pivot);
+    }
+
+    // A Hadamard gate turns the X on the pivot into a Z.
+    Terms next;
+    next.reserve(2 * state.size());
+    for (auto &[basis, amplitude] : state) {
+      Bits key = basis;
+      const bool bit = getBit(key, pivot);
+      next[key] += (bit ? -M_SQRT1_2 : M_SQRT1_2) * amplitude;
+      flipBit(key, pivot);
+      next[std::move(key)] += M_SQRT1_2 * amplitude;
+    }
+    state = std::move(next);
+    for (auto &op : observables) {
+      const bool x = getBit(op.xs, pivot);
+      const bool z = getBit(op.zs, pivot);
+      if (x != z) {
+        flipBit(op.xs, pivot);
+        flipBit(op.zs, pivot);
+      }
+      if (x && z)
+        op.phase += 2;
+    }
+    if (transposed)
+      transposed->append_H_XZ(pivot);
+  }
+
+  /// @brief Return whether the diagonal \p observable is -1 on \p basis.
+  static bool isNegative(const PauliOperator &observable, const Bits &basis) {
+    return parity(observable.zs, basis) != (observable.phase % 4 == 2);
+  }
+
+  /// @brief Return the probability of the -1 eigenvalue of the diagonal
+  /// \p observable.
+  static double probabilityOfOne(const Terms &state,
+                                 const PauliOperator &observable) {
+    double total = 0.0;
+    double one = 0.0;
+    for (const auto &[basis, amplitude] : state) {
+      total += std::norm(amplitude);
+      if (isNegative(observable, basis))
+        one += std::norm(amplitude);
+    }
+    return one / total;
+  }
+
+  /// @brief Project \p state on the eigenvalue (-1)^\p result of the diagonal
+  /// \p observable, and normalize it.
+  static void project(Terms &state, const PauliOperator &observable,
+                      bool result) {
+    std::erase_if(state, [&](const auto &term) {
+      return isNegative(observable, term.first) != result ||
+             std::abs(term.second) < tolerance;
+    });
+    double norm = 0.0;
+    for (const auto &[basis, amplitude] : state)
+      norm += std::norm(amplitude);
+    for (auto &[basis, amplitude] : state)
+      amplitude /= std::sqrt(norm);
+  }
+
+  /// @brief Apply the Stim gate \p gateName on the tableau.
+  void applyStimGate(const std::string &gateName,
+                     const std::vector<std::uint32_t> &targets) {
+    stim::Circuit tempCircuit;
+    cudaq::info("Calling applyStimGate {} - {}", gateName, targets);
+    tempCircuit.safe_append_u(gateName, targets);
+    tableau->safe_do_circuit(tempCircuit);
+  }
+
+  /// @brief Return the Stim gate equal to the gate of \p task up to a global
+  /// phase, or an empty string if the gate is not a Clifford gate.
+  static std::string getCliffordGate(const GateApplicationTask &task) {
+    static const std::unordered_map<std::string, std::string> gates = {
+        {"h", "H"}, {"x", "X"},     {"y", "Y"},       {"z", "Z"},
+        {"s", "S"}, {"sdg", "S_DAG"}, {"swap", "SWAP"}};
+    static const std::unordered_map<std::string, std::string>
+        controlledGates = {{"x", "CX"}, {"y", "CY"}, {"z", "CZ"}};
+    // Rotations by multiples of pi/2, by number of quarter turns.
+    static const std::unordered_map<std::string, std::array<std::string, 4>>
+        rotations = {{"rx", {"I", "SQRT_X", "X", "SQRT_X_DAG"}},
+                     {"ry", {"I", "SQRT_Y", "Y", "SQRT_Y_DAG"}},
+                     {"rz", {"I", "S", "Z", "S_DAG"}},
+                     {"r1", {"I", "S", "Z", "S_DAG"}}};
+
+    if (task.controls.size() == 1) {
+      const auto iter = controlledGates.find(task.operationName);
+      return iter == controlledGates.end() ? "" : iter->second;
+    }
+    if (!task.controls.empty())
+      return "";
+    if (const auto iter = gates.find(task.operationName); iter != gates.end())
+      return iter->second;
+    if (const auto iter = rotations.find(task.operationName);
+        iter != rotations.end()) {
+      const double quarters = task.parameters[0] / M_PI_2;
+      const double rounded = std::round(quarters);
+      if (std::abs(quarters - rounded) > tolerance)
+        return "";
+      return iter->second[(static_cast<std::int64_t>(rounded) % 4 + 4) % 4];
+    }
+    return "";
+  }
+
+  /// @brief Apply a Clifford gate on the tableau, or expand any other gate on
+  /// Paulis to apply it on |chi>.
+  void applyGate(const GateApplicationTask &task) override {
+    const auto cliffordGate = getCliffordGate(task);
+    if (!cliffordGate.empty()) {
+      if (cliffordGate == "I")
+        return;
+      std::vector<std::uint32_t> stimTargets;
+      for (auto c : task.controls)
+        stimTargets.push_back(c);
+      for (auto t : task.targets)
+        stimTargets.push_back(t);
+      applyStimGate(cliffordGate, stimTargets);
+      return;
+    }
+
+    // The matrix on the targets then the controls, bit j of its index being
+    // for the j-th of these qubits.
+    std::vector<std::size_t> qubits(task.targets);
+    qubits.insert(qubits.end(), task.controls.begin(), task.controls.end());
+    const std::size_t dim = 1ULL << qubits.size();
+    const std::size_t targetDim = 1ULL << task.targets.size();
+    auto element = [&](std::size_t row, std::size_t column) -> Amplitude {
+      if (row / targetDim != column / targetDim)
+        return 0.0;
+      if (row / targetDim != dim / targetDim - 1)
+        return row == column ? 1.0 : 0.0;
+      return task.matrix[(row % targetDim) * targetDim + column % targetDim];
+    };
+
+    std::vector<PauliOperator> xImages, zImages;
+    for (auto q : qubits) {
+      xImages.push_back(conjugate(cudaq::pauli::X, q));
+      zImages.push_back(conjugate(cudaq::pauli::Z, q));
+    }
+
+    // The coefficient of X^x Z^z is tr(Z^z X^x U) / dim.
+    Terms next;
+    for (std::size_t x = 0; x < dim; ++x)
+      for (std::size_t z = 0; z < dim; ++z) {
+        Amplitude coefficient = 0.0;
+        for (std::size_t i = 0; i < dim; ++i) {
+          const auto value = element(i ^ x, i);
+          coefficient += std::popcount(z & i) % 2 ? -value : value;
+        }
+        coefficient /= static_cast<double>(dim);
+        if (std::abs(coefficient) < tolerance)
+          continue;
+
+        auto op = identity();
+        for (std::size_t j = 0; j < qubits.size(); ++j)
+          if ((x >> j) & 1)
+            op = multiply(op, xImages[j]);
+        for (std::size_t j = 0; j < qubits.size(); ++j)
+          if ((z >> j) & 1)
+            op = multiply(op, zImages[j]);
+        accumulate(op, coefficient, terms, next);
+      }
+    setTerms(std::move(next));
+  }
+
+  /// @brief Grow the state by one qubit.
+  void addQubitToState() override { addQubitsToState(1); }
+
+  /// @brief Add \p qubitCount qubits, on which C acts as the identity, so
+  /// that their initial state data goes in |chi>.
+  void addQubitsToState(std::size_t qubitCount,
+                        const void *stateDataIn = nullptr) override {
+    if (!tableau) {
+      cudaq::info("Creating new Stim Tableau simulator");
+      tableau = std::make_unique<stim::TableauSimulator<W>>(
+          std::mt19937_64(randomEngine()), /*num_qubits=*/0,
+          /*sign_bias=*/+0);
+    }
+    const std::size_t first = numQubits;
+    numQubits += qubitCount;
+    tableau->ensure_large_enough_for_qubits(numQubits);
+
+    Terms next;
+    if (terms.empty())
+      next.emplace(Bits(numWords(), 0), 1.0);
+    for (auto &[basis, amplitude] : terms) {
+      Bits key = basis;
+      key.resize(numWords(), 0);
+      next.emplace(std::move(key), amplitude);
+    }
+    if (stateDataIn) {
+      const auto *data = reinterpret_cast<const Amplitude *>(stateDataIn);
+      Terms product;
+      for (std::size_t i = 0; i < (1ULL << qubitCount); ++i) {
+        if (std::abs(data[i]) < tolerance)
+          continue;
+        for (auto &[basis, amplitude] : next) {
+          Bits key = basis;
+          for (std::size_t j = 0; j < qubitCount; ++j)
+            if ((i >> j) & 1)
+              flipBit(key, first + j);
+          product.emplace(std::move(key), data[i] * amplitude);
+        }
+      }
+      next = std::move(product);
+    }
+    setTerms(std::move(next));
+  }
+
+  /// @brief Reset the qubit state.
+  void deallocateStateImpl() override {
+    tableau.reset();
+    terms.clear();
+    numQubits = 0;
+  }
+
+  /// @brief Set the current state back to the |0> state.
+  void setToZeroState() override {
+    tableau = std::make_unique<stim::TableauSimulator<W>>(
+        std::mt19937_64(randomEngine()), numQubits, /*sign_bias=*/+0);
+    terms.clear();
+    terms.emplace(Bits(numWords(), 0), 1.0);
+  }
+
+  /// @brief Override the calculateStateDim because this is not a state vector
+  /// simulator.
+  std::size_t calculateStateDim(const std::size_t numQubits) override {
+    return 0;
+  }
+
+  /// @brief Measure the qubit and return the result.
+  bool measureQubit(const std::size_t index) override {
+    std::vector<PauliOperator> observables{conjugate(cudaq::pauli::Z, index)};
+    diagonalize(terms, observables, /*updateTableau=*/true);
+    const double probOne = probabilityOfOne(terms, observables.front());
+    const bool result =
+        std::uniform_real_distribution<double>(0.0, 1.0)(randomEngine) <
+        probOne;
+    project(terms, observables.front(), result);
+    return result;
+  }
+
+public:
+  NearCliffordCircuitSimulator() : randomEngine(std::random_device{}()) {
+    if (auto *maxTermsEnvVar = std::getenv("CUDAQ_NEAR_CLIFFORD_MAX_TERMS")) {
+      const std::string maxTermsStr(maxTermsEnvVar);
+      const char *nptr = maxTermsStr.data();
+      char *endptr = nullptr;
+      errno = 0; // reset errno to 0 before call
+      const auto value = strtoll(nptr, &endptr, 10);
+
+      if (nptr == endptr || errno != 0 || value < 1)
+        throw std::runtime_error("Invalid CUDAQ_NEAR_CLIFFORD_MAX_TERMS "
+                                 "setting. Expected a positive number. Got: " +
+                                 maxTermsStr);
+      maxTerms = value;
+      cudaq::info("Setting near-Clifford max terms to {}.", maxTerms);
+    }
+    // Populate the correct name so it is printed correctly during
+    // deconstructor.
+    summaryData.name = name();
+  }
+  virtual ~NearCliffordCircuitSimulator() = default;
+
+  void setRandomSeed(std::size_t seed) override {
+    randomEngine = std::mt19937_64(seed);
+  }
+
+  bool canHandleObserve() override {
+    // Do not compute <H> from the state if shots based sampling requested
+    if (executionContext &&
+        executionContext->shots != static_cast<std::size_t>(-1)) {
+      return false;
+    }
+
+    return !shouldObserveFromSampling();
+  }
+
+  /// @brief Compute <psi|H|psi> as the sum over the terms of H of
+  /// <chi| C^-1 P C |chi>.
+  cudaq::observe_result observe(const cudaq::spin_op &op) override {
+    flushGateQueue();
+    double ee = 0.0;
+    op.for_each_term([&](cudaq::spin_op &term) {
+      auto image = identity();
+      term.for_each_pauli([&](cudaq::pauli type, std::size_t idx) {
+        image = multiply(image, conjugate(type, idx));
+      });
+      ee += (term.get_coefficient() * expectation(image, terms)).real();
+    });
+    return cudaq::observe_result(ee, op,
+                                 cudaq::sample_result(cudaq::ExecutionResult(
+                                     {}, op.to_string(false), ee)));
+  }
+
+  /// @brief Reset the qubit
+  /// @param index 0-based index of qubit to reset
+  void resetQubit(const std::size_t index) override {
+    flushGateQueue();
+    flushAnySamplingTasks();
+    if (measureQubit(index))
+      applyStimGate("X", {static_cast<std::uint32_t>(index)});
+  }
+
+  /// @brief Sample the multi-qubit state. The shots with the same first
+  /// outcomes share the collapsed state, which is split for the next
+  /// measurement according to a binomial draw, so that deterministic outcomes
+  /// cost a single collapse for all the shots.
+  cudaq::ExecutionResult sample(const std::vector<std::size_t> &qubits,
+                                const int shots) override {
+    std::vector<PauliOperator> observables;
+    for (auto q : qubits)
+      observables.push_back(conjugate(cudaq::pauli::Z, q));
+
+    if (shots < 1) {
+      auto image = identity();
+      for (const auto &observable : observables)
+        image = multiply(image, observable);
+      const double expectationValue = expectation(image, terms).real();
+      cudaq::info("Computed expectation value = {}", expectationValue);
+      return cudaq::ExecutionResult{{}, expectationValue};
+    }
+
+    struct Branch {
+      Terms state;
+      std::vector<PauliOperator> observables;
+      std::string outcome;
+      std::size_t shots;
+    };
+    std::vector<Branch> branches;
+    branches.push_back(
+        Branch{terms, std::move(observables), "", std::size_t(shots)});
+    cudaq::ExecutionResult counts;
+    double expVal = 0.0;
+    while (!branches.empty()) {
+      auto branch = std::move(branches.back());
+      branches.pop_back();
+      const std::size_t k = branch.outcome.size();
+      if (k == qubits.size()) {
+        const auto ones =
+            std::count(branch.outcome.begin(), branch.outcome.end(), '1');
+        expVal += ones % 2 == 0 ? branch.shots : -double(branch.shots);
+        counts.appendResult(branch.outcome, branch.shots);
+        continue;
+      }
+
+      std::span<PauliOperator> remaining(branch.observables.begin() + k,
+                                         branch.observables.end());
+      diagonalize(branch.state, remaining, /*updateTableau=*/false);
+      const double probOne = probabilityOfOne(branch.state, remaining.front());
+      const std::size_t ones = std::binomial_distribution<std::size_t>(
+          branch.shots, probOne)(randomEngine);
+      auto collapse = [&](Branch &&next, std::size_t count, bool result) {
+        project(next.state, next.observables[k], result);
+        next.outcome.push_back(result ? '1' : '0');
+        next.shots = count;
+        branches.push_back(std::move(next));
+      };
+      if (ones > 0 && ones < branch.shots)
+        collapse(Branch(branch), ones, true);
+      else if (ones > 0) {
+        collapse(std::move(branch), ones, true);
+        continue;
+      }
+      collapse(std::move(branch), branch.shots - ones, false);
+    }
+    counts.expectationValue = expVal / shots;
+    return counts;
+  }
+
+  bool isStateVectorSimulator() const override { return false; }
+
+  /// @brief Return the number of terms of |chi>.
+  std::size_t getNumTerms() {
+    flushGateQueue();
+    return terms.size();
+  }
+
+  std::string name() const override { return "near-clifford"; }
+  NVQIR_SIMULATOR_CLONE_IMPL(NearCliffordCircuitSimulator)
+};
+
+} // namespace nvqir
@@ -0,0 +1,50 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+// REQUIRES: remote-sim
+
+// clang-format off
+// RUN: nvq++ %cpp_std --enable-mlir --target remote-mqpu %s -o %t && CUDAQ_REMOTE_STATE_MAX_QUBIT_COUNT=5 %t
+// RUN: nvq++ %cpp_std --target remote-mqpu %s -o %t && CUDAQ_REMOTE_STATE_MAX_QUBIT_COUNT=5 %t
+// clang-format on
+
+#include "remote_test_assert.h"
+#include <cudaq.h>
+
+struct cat_state {
+  void operator()(int N) __qpu__ {
+    cudaq::qvector qubits(N);
+    h(qubits[0]);
+    for (int i = 0; i < N - 1; ++i)
+      cx(qubits[i], qubits[i + 1]);
+  }
+};
+
+int main() {
+  // The state is above the full transfer threshold, hence element access is
+  // served by fetching blocks of amplitudes from the server.
+  constexpr int numQubits = 14;
+  auto state = cudaq::get_state(cat_state{}, numQubits);
+  REMOTE_TEST_ASSERT(state.get_num_qubits() == numQubits);
+  const std::size_t lastIdx = (1ULL << numQubits) - 1;
+  for (std::size_t i = 0; i <= lastIdx; i += 1023) {
+    const auto expected = (i == 0 || i == lastIdx) ? M_SQRT1_2 : 0.0;
+    REMOTE_TEST_ASSERT(std::abs(state[i] - expected) < 1e-3);
+  }
+  REMOTE_TEST_ASSERT(std::abs(state[lastIdx] - M_SQRT1_2) < 1e-3);
+
+  // The state is small enough to be transferred along with its size, hence
+  // element access is served from the full state.
+  auto smallState = cudaq::get_state(cat_state{}, 3);
+  REMOTE_TEST_ASSERT(std::abs(smallState[0] - M_SQRT1_2) < 1e-3);
+  REMOTE_TEST_ASSERT(std::abs(smallState[1]) < 1e-3);
+  REMOTE_TEST_ASSERT(std::abs(smallState[7] - M_SQRT1_2) < 1e-3);
+  REMOTE_TEST_ASSERT(smallState.get_num_qubits() == 3);
+
+  return 0;
+}
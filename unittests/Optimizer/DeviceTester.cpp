@@ -0,0 +1,93 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "cudaq/Support/Device.h"
+#include <gtest/gtest.h>
+#include <limits>
+#include <vector>
+
+using cudaq::Device;
+
+namespace {
+/// Brute-force BFS distances from \p src, over the neighbours of the device.
+std::vector<unsigned> distancesFrom(const Device &device, unsigned src) {
+  std::vector<unsigned> distances(device.getNumQubits(),
+                                  std::numeric_limits<unsigned>::max());
+  std::vector<unsigned> queue{src};
+  distances[src] = 0;
+  for (std::size_t i = 0; i < queue.size(); ++i)
+    for (auto neighbour : device.getNeighbours(Device::Qubit(queue[i])))
+      if (distances[neighbour.index] == std::numeric_limits<unsigned>::max()) {
+        distances[neighbour.index] = distances[queue[i]] + 1;
+        queue.push_back(neighbour.index);
+      }
+  return distances;
+}
+
+/// Check the distance and the shortest path between \p src and \p dst.
+void checkPath(const Device &device, unsigned src, unsigned dst,
+               unsigned distance) {
+  EXPECT_EQ(device.getDistance(Device::Qubit(src), Device::Qubit(dst)),
+            distance)
+      << src << " -> " << dst;
+  auto path = device.getShortestPath(Device::Qubit(src), Device::Qubit(dst));
+  ASSERT_EQ(path.size(), distance + 1) << src << " -> " << dst;
+  EXPECT_EQ(path.front().index, src);
+  EXPECT_EQ(path.back().index, dst);
+  for (std::size_t i = 1; i < path.size(); ++i)
+    EXPECT_TRUE(device.areConnected(path[i - 1], path[i]))
+        << src << " -> " << dst << " at " << i;
+}
+} // namespace
+
+TEST(DeviceTester, checkDenseVersusLazyThreshold) {
+  // The largest device with dense tables keeps a tree per root.
+  auto dense = Device::grid(32, Device::denseTableMaxQubits / 32);
+  ASSERT_EQ(dense.getNumQubits(), Device::denseTableMaxQubits);
+  const unsigned numRoots = Device::lazyCacheMaxTrees + 44;
+  const unsigned last = dense.getNumQubits() - 1;
+  for (unsigned root = 0; root < numRoots; ++root)
+    dense.getDistance(Device::Qubit(root), Device::Qubit(last));
+  EXPECT_EQ(dense.getNumShortestPathTrees(), numRoots);
+
+  // One more row of qubits switches to the bounded cache.
+  auto lazy = Device::grid(32, Device::denseTableMaxQubits / 32 + 1);
+  for (unsigned root = 0; root < numRoots; ++root)
+    lazy.getDistance(Device::Qubit(root), Device::Qubit(last));
+  EXPECT_EQ(lazy.getNumShortestPathTrees(), Device::lazyCacheMaxTrees);
+}
+
+TEST(DeviceTester, checkLazyDistancesAndPaths) {
+  auto device = Device::grid(48, 48);
+  ASSERT_GT(device.getNumQubits(), Device::denseTableMaxQubits);
+  const unsigned last = device.getNumQubits() - 1;
+  for (unsigned src : {0u, 47u, 1000u, 1151u, last}) {
+    const auto distances = distancesFrom(device, src);
+    for (unsigned dst : {0u, 1u, 48u, 500u, 1175u, 2000u, last}) {
+      checkPath(device, src, dst, distances[dst]);
+      checkPath(device, dst, src, distances[dst]);
+    }
+  }
+}
+
+TEST(DeviceTester, checkLazyEviction) {
+  auto device = Device::grid(48, 48);
+  const unsigned last = device.getNumQubits() - 1;
+  const unsigned numRoots = 2 * Device::lazyCacheMaxTrees + 10;
+  for (unsigned root = 0; root < numRoots; ++root)
+    device.getDistance(Device::Qubit(root), Device::Qubit(last));
+  EXPECT_EQ(device.getNumShortestPathTrees(), Device::lazyCacheMaxTrees);
+
+  // The trees of evicted roots are computed again, with the same results.
+  for (unsigned src : {0u, 5u, numRoots - 1}) {
+    const auto distances = distancesFrom(device, src);
+    for (unsigned dst : {1u, 700u, last})
+      checkPath(device, src, dst, distances[dst]);
+  }
+  EXPECT_EQ(device.getNumShortestPathTrees(), Device::lazyCacheMaxTrees);
+}
@@ -0,0 +1,144 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include <complex>
+#include <gtest/gtest.h>
+#include <math.h>
+
+#include "CUDAQTestUtils.h"
+#include "CpuCircuitSimulator.h"
+#include "backends/CpuSimulatorTestUtils.h"
+#include "common/JsonConvert.h"
+#include "llvm/Support/Base64.h"
+
+using namespace nvqir;
+
+namespace {
+constexpr double tolerance = 1e-6;
+} // namespace
+
+CUDAQ_TEST(CpuFp32Tester, checkMultiTargetGates) {
+  CpuCircuitSimulator<float> sim;
+  auto qubits = sim.allocateQubits(3);
+  sim.x(qubits[0]);
+  // Controlled swap of qubits 0 and 2, controlled on qubit 1.
+  sim.swap({qubits[1]}, qubits[0], qubits[2]);
+  std::vector<std::complex<double>> want(8, 0.0);
+  want[1] = 1.0;
+  test::expectStateNear(sim.getStateVector(), want, tolerance);
+
+  sim.x(qubits[1]);
+  sim.swap({qubits[1]}, qubits[0], qubits[2]);
+  want[1] = 0.0;
+  want[6] = 1.0;
+  test::expectStateNear(sim.getStateVector(), want, tolerance);
+  sim.deallocateQubits(qubits);
+}
+
+CUDAQ_TEST(CpuFp32Tester, checkMeasureAndReset) {
+  CpuCircuitSimulator<float> sim;
+  sim.setRandomSeed(13);
+  auto qubits = sim.allocateQubits(2);
+  sim.h(qubits[0]);
+  sim.x({qubits[0]}, qubits[1]);
+  const bool result = sim.mz(qubits[0]);
+  EXPECT_EQ(result, sim.mz(qubits[1]));
+  std::vector<std::complex<double>> want(4, 0.0);
+  want[result ? 3 : 0] = 1.0;
+  test::expectStateNear(sim.getStateVector(), want, tolerance);
+
+  sim.resetQubit(qubits[0]);
+  sim.resetQubit(qubits[1]);
+  want[3] = 0.0;
+  want[0] = 1.0;
+  test::expectStateNear(sim.getStateVector(), want, tolerance);
+  sim.deallocateQubits(qubits);
+}
+
+CUDAQ_TEST(CpuFp32Tester, checkObserve) {
+  CpuCircuitSimulator<float> sim;
+  auto qubits = sim.allocateQubits(2);
+  const double theta = 0.37;
+  sim.ry(theta, qubits[0]);
+  sim.rx(theta, qubits[1]);
+  using cudaq::spin::x, cudaq::spin::y, cudaq::spin::z;
+  EXPECT_NEAR(sim.observe(z(0)).expectation(), std::cos(theta), tolerance);
+  EXPECT_NEAR(sim.observe(x(0)).expectation(), std::sin(theta), tolerance);
+  EXPECT_NEAR(sim.observe(y(1)).expectation(), -std::sin(theta), tolerance);
+  EXPECT_NEAR(sim.observe(2.0 * x(0) * y(1) + z(1)).expectation(),
+              -2.0 * std::sin(theta) * std::sin(theta) + std::cos(theta),
+              tolerance);
+  sim.deallocateQubits(qubits);
+}
+
+CUDAQ_TEST(CpuFp32Tester, checkExpPauli) {
+  // Compare with the decomposition of the base class.
+  const auto op = cudaq::spin::x(0) * cudaq::spin::y(1) * cudaq::spin::z(2);
+  std::vector<std::complex<float>> states[2];
+  for (int decompose = 0; decompose < 2; ++decompose) {
+    CpuCircuitSimulator<float> sim;
+    auto qubits = sim.allocateQubits(4);
+    for (auto q : qubits)
+      sim.ry(0.3 + 0.2 * q, q);
+    if (decompose)
+      sim.CircuitSimulator::applyExpPauli(0.41, {qubits[3]}, qubits, op);
+    else
+      sim.applyExpPauli(0.41, {qubits[3]}, qubits, op);
+    states[decompose] = sim.getStateVector();
+    sim.deallocateQubits(qubits);
+  }
+  std::vector<std::complex<double>> want(states[1].begin(), states[1].end());
+  test::expectStateNear(states[0], want, tolerance);
+}
+
+CUDAQ_TEST(CpuFp32Tester, checkStatePrecisionConversion) {
+  CpuCircuitSimulator<float> sim;
+  sim.allocateQubits(1);
+  auto state = sim.getSimulationState();
+  EXPECT_EQ(state->getPrecision(), cudaq::SimulationState::precision::fp32);
+
+  // Double precision data is converted to single precision.
+  std::vector<std::complex<double>> data{M_SQRT1_2, {0.0, M_SQRT1_2}};
+  auto fromData = state->createFromData(data);
+  EXPECT_EQ(fromData->getPrecision(), cudaq::SimulationState::precision::fp32);
+  EXPECT_NEAR(fromData->getAmplitude({1}).imag(), M_SQRT1_2, tolerance);
+
+  std::vector<std::complex<double>> host(2);
+  fromData->toHost(host.data(), host.size());
+  EXPECT_NEAR(host[0].real(), M_SQRT1_2, tolerance);
+  EXPECT_NEAR(std::abs(fromData->overlap(*fromData)), 1.0, tolerance);
+  fromData->destroyState();
+  state->destroyState();
+}
+
+CUDAQ_TEST(CpuFp32Tester, checkSerializeState) {
+  CpuCircuitSimulator<float> sim;
+  auto qubits = sim.allocateQubits(5);
+  test::applyTestCircuit(sim, qubits);
+  const auto amplitudes = sim.getStateVector();
+  auto state = sim.getSimulationState();
+  EXPECT_FALSE(state->isDeviceData());
+
+  // The single precision amplitudes are serialized in double precision.
+  const std::vector<std::complex<double>> want(amplitudes.begin(),
+                                               amplitudes.end());
+  auto j = cudaq::serializeSimulationData(*state);
+  std::vector<std::complex<double>> data;
+  j["data"].get_to(data);
+  test::expectStateNear(data, want, 0.0);
+
+  j = cudaq::serializeSimulationData(*state, /*binary=*/true);
+  std::vector<char> bytes;
+  ASSERT_FALSE(llvm::errorToBool(
+      llvm::decodeBase64(j["binaryData"].get<std::string>(), bytes)));
+  ASSERT_EQ(bytes.size(), want.size() * sizeof(std::complex<double>));
+  std::memcpy(data.data(), bytes.data(), bytes.size());
+  test::expectStateNear(data, want, 0.0);
+  state->destroyState();
+  sim.deallocateQubits(qubits);
+}
@@ -0,0 +1,197 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include <complex>
+#include <gtest/gtest.h>
+#include <math.h>
+
+#include "CUDAQTestUtils.h"
+#include "CpuCircuitSimulator.h"
+#include "CpuMpsCircuitSimulator.h"
+#include "backends/CpuSimulatorTestUtils.h"
+
+using namespace nvqir;
+
+namespace {
+constexpr double tolerance = 1e-10;
+
+/// MPS simulator with the given truncation settings, instead of the ones of
+/// the environment.
+class TruncatedMpsSimulator : public CpuMpsCircuitSimulator {
+public:
+  TruncatedMpsSimulator(int64_t maxBond, double cutoff) {
+    settings.maxBond = maxBond;
+    settings.absCutoff = cutoff;
+    settings.relCutoff = cutoff;
+  }
+};
+
+/// Apply the layers \p first to \p last (excluded) of a brickwork circuit,
+/// with rotations and CNOT gates between neighboring qubits, alternately on
+/// the even and the odd bonds.
+template <typename Simulator>
+void applyBrickwork(Simulator &sim, const std::vector<std::size_t> &qubits,
+                    std::size_t first, std::size_t last) {
+  for (std::size_t layer = first; layer < last; ++layer) {
+    for (auto q : qubits) {
+      sim.ry(0.4 + 0.3 * q + layer, q);
+      sim.rz(0.2 * q - 0.5 * layer, q);
+    }
+    for (std::size_t q = layer % 2; q + 1 < qubits.size(); q += 2)
+      sim.x({qubits[q]}, qubits[q + 1]);
+  }
+}
+} // namespace
+
+CUDAQ_TEST(CpuMpsTester, checkNonAdjacentGates) {
+  TruncatedMpsSimulator sim(64, 1e-12);
+  CpuCircuitSimulator<double> reference;
+  auto qubits = sim.allocateQubits(8);
+  reference.allocateQubits(8);
+  test::applyTestCircuit(sim, qubits);
+  test::applyTestCircuit(reference, qubits);
+  test::expectStateNear(sim.getStateVector(), reference.getStateVector(),
+                        tolerance);
+
+  // More gates between distant qubits, which were moved over the sites.
+  auto applyDistantGates = [&](CircuitSimulator &simulator) {
+    simulator.x({qubits[7], qubits[6]}, qubits[0]);
+    simulator.swap({qubits[1]}, qubits[0], qubits[7]);
+    simulator.x({qubits[4]}, qubits[2]);
+  };
+  applyDistantGates(sim);
+  applyDistantGates(reference);
+  test::expectStateNear(sim.getStateVector(), reference.getStateVector(),
+                        tolerance);
+  sim.deallocateQubits(qubits);
+  reference.deallocateQubits(qubits);
+}
+
+CUDAQ_TEST(CpuMpsTester, checkObserve) {
+  TruncatedMpsSimulator sim(64, 1e-12);
+  CpuCircuitSimulator<double> reference;
+  auto qubits = sim.allocateQubits(6);
+  reference.allocateQubits(6);
+  test::applyTestCircuit(sim, qubits);
+  test::applyTestCircuit(reference, qubits);
+
+  using cudaq::spin::x, cudaq::spin::y, cudaq::spin::z;
+  const auto op = x(5) * z(0) + 0.5 * y(1) * z(2) * x(3) - 2.0 * y(2) +
+                  1.5 * z(1) * z(4);
+  EXPECT_NEAR(sim.observe(op).expectation(),
+              reference.observe(op).expectation(), tolerance);
+  sim.deallocateQubits(qubits);
+  reference.deallocateQubits(qubits);
+}
+
+CUDAQ_TEST(CpuMpsTester, checkGrowState) {
+  TruncatedMpsSimulator sim(64, 1e-12);
+  CpuCircuitSimulator<double> reference;
+  auto qubits = sim.allocateQubits(5);
+  reference.allocateQubits(5);
+  test::applyTestCircuit(sim, qubits);
+  test::applyTestCircuit(reference, qubits);
+
+  // The new qubits are in a product state with the others.
+  std::vector<std::complex<double>> plus(4, 0.5);
+  auto added = sim.allocateQubits(2, plus.data(),
+                                  cudaq::simulation_precision::fp64);
+  reference.allocateQubits(2, plus.data(), cudaq::simulation_precision::fp64);
+  qubits.insert(qubits.end(), added.begin(), added.end());
+  test::expectStateNear(sim.getStateVector(), reference.getStateVector(),
+                        tolerance);
+  sim.deallocateQubits(qubits);
+  reference.deallocateQubits(qubits);
+}
+
+CUDAQ_TEST(CpuMpsTester, checkBondGrowth) {
+  TruncatedMpsSimulator sim(64, 1e-12);
+  CpuCircuitSimulator<double> reference;
+  auto qubits = sim.allocateQubits(8);
+  reference.allocateQubits(8);
+  EXPECT_EQ(sim.getMaxBondDimension(), 1);
+
+  // The largest bond at most doubles every other layer, until it reaches
+  // 2^4 for 8 qubits.
+  std::size_t bond = 1;
+  for (std::size_t layer = 0; layer < 10; ++layer) {
+    applyBrickwork(sim, qubits, layer, layer + 1);
+    applyBrickwork(reference, qubits, layer, layer + 1);
+    const std::size_t grown = sim.getMaxBondDimension();
+    EXPECT_GE(grown, bond) << "layer " << layer;
+    EXPECT_LE(grown, std::min<std::size_t>(2ULL << (layer / 2), 16))
+        << "layer " << layer;
+    bond = grown;
+  }
+  EXPECT_EQ(bond, 16);
+  test::expectStateNear(sim.getStateVector(), reference.getStateVector(),
+                        tolerance);
+  sim.deallocateQubits(qubits);
+  reference.deallocateQubits(qubits);
+}
+
+CUDAQ_TEST(CpuMpsTester, checkTruncationError) {
+  TruncatedMpsSimulator sim(4, 1e-12);
+  CpuCircuitSimulator<double> reference;
+  auto qubits = sim.allocateQubits(8);
+  reference.allocateQubits(8);
+  applyBrickwork(sim, qubits, 0, 6);
+  applyBrickwork(reference, qubits, 0, 6);
+  EXPECT_EQ(sim.getMaxBondDimension(), 4);
+
+  // The truncated state is normalized, and close to the exact one.
+  const auto state = sim.getStateVector();
+  const auto exact = reference.getStateVector();
+  double norm = 0.0;
+  std::complex<double> overlap = 0.0;
+  for (std::size_t i = 0; i < state.size(); ++i) {
+    norm += std::norm(state[i]);
+    overlap += std::conj(exact[i]) * state[i];
+  }
+  EXPECT_NEAR(norm, 1.0, tolerance);
+  EXPECT_LT(std::norm(overlap), 1.0 - 1e-4);
+  EXPECT_GT(std::norm(overlap), 0.5);
+
+  // The default cutoffs only drop negligible singular values.
+  TruncatedMpsSimulator defaultSim(64, 1e-5);
+  defaultSim.allocateQubits(8);
+  applyBrickwork(defaultSim, qubits, 0, 6);
+  test::expectStateNear(defaultSim.getStateVector(), exact, 1e-4);
+  defaultSim.deallocateQubits(qubits);
+  sim.deallocateQubits(qubits);
+  reference.deallocateQubits(qubits);
+}
+
+CUDAQ_TEST(CpuMpsTester, checkManyQubits) {
+  CpuMpsCircuitSimulator sim;
+  auto qubits = sim.allocateQubits(64);
+  sim.h(qubits[0]);
+  sim.x({qubits[0]}, qubits[63]);
+  EXPECT_EQ(sim.getMaxBondDimension(), 2);
+
+  using cudaq::spin::z;
+  EXPECT_NEAR(sim.observe(z(0) * z(63)).expectation(), 1.0, tolerance);
+
+  // The state vector is too large to be contracted.
+  EXPECT_THROW(sim.getStateVector(), std::runtime_error);
+  sim.deallocateQubits(qubits);
+}
+
+CUDAQ_TEST(CpuMpsTester, checkInvalidSettings) {
+  setenv("CUDAQ_MPS_MAX_BOND", "0", 1);
+  EXPECT_THROW(CpuMpsCircuitSimulator(), std::runtime_error);
+  unsetenv("CUDAQ_MPS_MAX_BOND");
+
+  setenv("CUDAQ_MPS_MAX_BOND", "2", 1);
+  CpuMpsCircuitSimulator sim;
+  unsetenv("CUDAQ_MPS_MAX_BOND");
+  auto qubits = sim.allocateQubits(8);
+  applyBrickwork(sim, qubits, 0, 4);
+  EXPECT_EQ(sim.getMaxBondDimension(), 2);
+  sim.deallocateQubits(qubits);
+}
@@ -0,0 +1,139 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include <complex>
+#include <gtest/gtest.h>
+#include <math.h>
+
+#include "CUDAQTestUtils.h"
+#include "CpuCircuitSimulator.h"
+#include "CpuOutOfCoreCircuitSimulator.h"
+#include "backends/CpuSimulatorTestUtils.h"
+
+using namespace nvqir;
+
+namespace {
+constexpr double tolerance = 1e-10;
+
+/// Create a simulator streaming the state in chunks of \p chunkQubits qubits,
+/// with its state file in \p directory.
+std::unique_ptr<CpuOutOfCoreCircuitSimulator>
+createSimulator(std::size_t chunkQubits,
+                const std::filesystem::path &directory =
+                    std::filesystem::temp_directory_path()) {
+  setenv("CUDAQ_CPU_OOC_CHUNK_QUBITS", std::to_string(chunkQubits).c_str(),
+         1);
+  setenv("CUDAQ_CPU_OOC_DIR", directory.c_str(), 1);
+  auto sim = std::make_unique<CpuOutOfCoreCircuitSimulator>();
+  unsetenv("CUDAQ_CPU_OOC_CHUNK_QUBITS");
+  unsetenv("CUDAQ_CPU_OOC_DIR");
+  return sim;
+}
+} // namespace
+
+CUDAQ_TEST(CpuOutOfCoreTester, checkStreamingMatchesReference) {
+  auto sim = createSimulator(3);
+  CpuCircuitSimulator<double> reference;
+  auto qubits = sim->allocateQubits(8);
+  reference.allocateQubits(8);
+  test::applyTestCircuit(*sim, qubits);
+  test::applyTestCircuit(reference, qubits);
+  test::expectStateNear(sim->getStateVector(), reference.getStateVector(),
+                        tolerance);
+
+  using cudaq::spin::x, cudaq::spin::y, cudaq::spin::z;
+  const auto op = x(7) * z(0) + 0.5 * y(1) * z(6) * x(7) - 2.0 * y(5);
+  EXPECT_NEAR(sim->observe(op).expectation(),
+              reference.observe(op).expectation(), tolerance);
+
+  const auto pauli = x(0) * y(1) * z(2);
+  sim->applyExpPauli(0.41, {3}, {7, 2, 6}, pauli);
+  reference.applyExpPauli(0.41, {3}, {7, 2, 6}, pauli);
+  sim->h(7);
+  reference.h(7);
+  test::expectStateNear(sim->getStateVector(), reference.getStateVector(),
+                        tolerance);
+  sim->deallocateQubits(qubits);
+  reference.deallocateQubits(qubits);
+}
+
+CUDAQ_TEST(CpuOutOfCoreTester, checkGrowState) {
+  auto sim = createSimulator(2);
+  CpuCircuitSimulator<double> reference;
+  auto qubits = sim->allocateQubits(5);
+  reference.allocateQubits(5);
+  test::applyTestCircuit(*sim, qubits);
+  test::applyTestCircuit(reference, qubits);
+
+  // The new qubits are added on top of remapped ones.
+  auto added = sim->allocateQubits(3);
+  reference.allocateQubits(3);
+  qubits.insert(qubits.end(), added.begin(), added.end());
+  test::applyTestCircuit(*sim, qubits);
+  test::applyTestCircuit(reference, qubits);
+  test::expectStateNear(sim->getStateVector(), reference.getStateVector(),
+                        tolerance);
+  sim->deallocateQubits(qubits);
+  reference.deallocateQubits(qubits);
+}
+
+CUDAQ_TEST(CpuOutOfCoreTester, checkMeasureAndSample) {
+  auto sim = createSimulator(2);
+  CpuCircuitSimulator<double> reference;
+  sim->setRandomSeed(13);
+  auto qubits = sim->allocateQubits(6);
+  reference.allocateQubits(6);
+  test::applyTestCircuit(*sim, qubits);
+  test::applyTestCircuit(reference, qubits);
+
+  // The frequencies of the outcomes match the reference probabilities.
+  const std::size_t shots = 10000;
+  cudaq::ExecutionContext ctx("sample", shots);
+  sim->setExecutionContext(&ctx);
+  for (auto q : qubits)
+    sim->mz(q);
+  sim->resetExecutionContext();
+  const auto want = reference.getStateVector();
+  const auto counts = ctx.result.to_map();
+  for (std::size_t i = 0; i < want.size(); ++i) {
+    std::string bits;
+    for (std::size_t q = 0; q < qubits.size(); ++q)
+      bits += (i >> q) & 1 ? '1' : '0';
+    const auto iter = counts.find(bits);
+    const double frequency =
+        iter == counts.end() ? 0.0 : static_cast<double>(iter->second) / shots;
+    EXPECT_NEAR(frequency, std::norm(want[i]), 0.02) << bits;
+  }
+
+  // A measurement collapses the state on the high qubits too.
+  const bool result = sim->mz(qubits.back());
+  const auto collapsed = sim->getStateVector();
+  const std::size_t mask = 1ULL << (qubits.size() - 1);
+  double norm = 0.0;
+  for (std::size_t i = 0; i < collapsed.size(); ++i) {
+    if (static_cast<bool>(i & mask) != result) {
+      EXPECT_EQ(collapsed[i], std::complex<double>(0.0)) << "at " << i;
+    }
+    norm += std::norm(collapsed[i]);
+  }
+  EXPECT_NEAR(norm, 1.0, tolerance);
+  sim->resetQubit(qubits.back());
+  EXPECT_FALSE(sim->mz(qubits.back()));
+  sim->deallocateQubits(qubits);
+  reference.deallocateQubits(qubits);
+}
+
+CUDAQ_TEST(CpuOutOfCoreTester, checkInvalidSettings) {
+  setenv("CUDAQ_CPU_OOC_CHUNK_QUBITS", "0", 1);
+  EXPECT_THROW(CpuOutOfCoreCircuitSimulator(), std::runtime_error);
+  unsetenv("CUDAQ_CPU_OOC_CHUNK_QUBITS");
+
+  // The state file is only created on the first allocation.
+  auto sim = createSimulator(2, "/nonexistent-cudaq-state-directory");
+  EXPECT_THROW(sim->allocateQubits(2), std::runtime_error);
+}
@@ -0,0 +1,169 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <math.h>
+
+#include "CUDAQTestUtils.h"
+#include "CpuCircuitSimulator.h"
+#include "CpuPauliPropagationSimulator.h"
+#include "backends/CpuSimulatorTestUtils.h"
+
+using namespace nvqir;
+
+namespace {
+constexpr double tolerance = 1e-10;
+} // namespace
+
+CUDAQ_TEST(CpuPauliPropagationTester, checkMatchesReference) {
+  CpuPauliPropagationSimulator sim;
+  CpuCircuitSimulator<double> reference;
+  auto qubits = sim.allocateQubits(6);
+  reference.allocateQubits(6);
+  test::applyTestCircuit(sim, qubits);
+  test::applyTestCircuit(reference, qubits);
+
+  using cudaq::spin::x, cudaq::spin::y, cudaq::spin::z;
+  const auto op = x(5) * z(0) + 0.5 * y(1) * z(2) * x(3) - 2.0 * y(2) +
+                  1.5 * z(1) * z(4) + 0.3 * y(0) * y(5);
+  EXPECT_NEAR(sim.observe(op).expectation(),
+              reference.observe(op).expectation(), tolerance);
+  sim.deallocateQubits(qubits);
+  reference.deallocateQubits(qubits);
+}
+
+CUDAQ_TEST(CpuPauliPropagationTester, checkRotations) {
+  CpuPauliPropagationSimulator sim;
+  auto qubits = sim.allocateQubits(2);
+  sim.ry(0.4, qubits[0]);
+  sim.rx(1.1, qubits[1]);
+  sim.x({qubits[0]}, qubits[1]);
+  using cudaq::spin::x, cudaq::spin::y, cudaq::spin::z;
+  EXPECT_NEAR(sim.observe(z(0)).expectation(), std::cos(0.4), tolerance);
+  EXPECT_NEAR(sim.observe(x(0) * x(1)).expectation(), std::sin(0.4),
+              tolerance);
+  EXPECT_NEAR(sim.observe(z(1)).expectation(), std::cos(0.4) * std::cos(1.1),
+              tolerance);
+  EXPECT_NEAR(sim.observe(2.0 * z(0) * z(1) - y(1)).expectation(),
+              2.0 * std::cos(1.1) - std::cos(0.4) * -std::sin(1.1),
+              tolerance);
+  sim.deallocateQubits(qubits);
+}
+
+CUDAQ_TEST(CpuPauliPropagationTester, checkGHZOnManyQubits) {
+  CpuPauliPropagationSimulator sim;
+  const std::size_t numQubits = 100;
+  auto qubits = sim.allocateQubits(numQubits);
+  sim.h(qubits[0]);
+  for (std::size_t q = 0; q + 1 < numQubits; ++q)
+    sim.x({qubits[q]}, qubits[q + 1]);
+
+  using cudaq::spin::x, cudaq::spin::z;
+  auto allX = x(0);
+  for (std::size_t q = 1; q < numQubits; ++q)
+    allX *= x(q);
+  EXPECT_NEAR(sim.observe(z(0) * z(numQubits - 1)).expectation(), 1.0,
+              tolerance);
+  EXPECT_NEAR(sim.observe(z(numQubits / 2)).expectation(), 0.0, tolerance);
+  EXPECT_NEAR(sim.observe(allX).expectation(), 1.0, tolerance);
+  sim.deallocateQubits(qubits);
+}
+
+CUDAQ_TEST(CpuPauliPropagationTester, checkToffoliAndReset) {
+  CpuPauliPropagationSimulator sim;
+  auto qubits = sim.allocateQubits(3);
+  sim.x(qubits[0]);
+  sim.x(qubits[1]);
+  sim.x({qubits[0], qubits[1]}, qubits[2]);
+  using cudaq::spin::x, cudaq::spin::z;
+  EXPECT_NEAR(sim.observe(z(2)).expectation(), -1.0, tolerance);
+
+  sim.h(qubits[1]);
+  sim.resetQubit(qubits[0]);
+  sim.resetQubit(qubits[1]);
+  EXPECT_NEAR(sim.observe(z(0)).expectation(), 1.0, tolerance);
+  EXPECT_NEAR(sim.observe(z(1)).expectation(), 1.0, tolerance);
+  EXPECT_NEAR(sim.observe(x(1)).expectation(), 0.0, tolerance);
+  EXPECT_NEAR(sim.observe(z(2)).expectation(), -1.0, tolerance);
+  sim.deallocateQubits(qubits);
+}
+
+CUDAQ_TEST(CpuPauliPropagationTester, checkMaxWeight) {
+  setenv("CUDAQ_PAULI_PROPAGATION_MAX_WEIGHT", "1", 1);
+  CpuPauliPropagationSimulator sim;
+  unsetenv("CUDAQ_PAULI_PROPAGATION_MAX_WEIGHT");
+  auto qubits = sim.allocateQubits(2);
+  sim.x(qubits[0]);
+  sim.x({qubits[0]}, qubits[1]);
+  using cudaq::spin::z;
+  EXPECT_NEAR(sim.observe(z(0) * z(1)).expectation(), 1.0, tolerance);
+  // Z1 propagates back to Z0 Z1, which exceeds the maximum weight and is
+  // dropped.
+  EXPECT_NEAR(sim.observe(z(1)).expectation(), 0.0, tolerance);
+  sim.deallocateQubits(qubits);
+}
+
+CUDAQ_TEST(CpuPauliPropagationTester, checkCutoff) {
+  // Z0 Z1 propagates to cos(1.4) Z0 Z1 + sin(1.4) Z0 X1 through the last
+  // rotation, then to cos(0.3) cos(1.4) Z0 Z1 + ... through the first one.
+  auto observeWithCutoff = [](const char *cutoff, const cudaq::spin_op &op) {
+    setenv("CUDAQ_PAULI_PROPAGATION_CUTOFF", cutoff, 1);
+    CpuPauliPropagationSimulator sim;
+    unsetenv("CUDAQ_PAULI_PROPAGATION_CUTOFF");
+    auto qubits = sim.allocateQubits(2);
+    sim.ry(0.3, qubits[0]);
+    sim.ry(1.4, qubits[1]);
+    const double value = sim.observe(op).expectation();
+    sim.deallocateQubits(qubits);
+    return value;
+  };
+  using cudaq::spin::z;
+  EXPECT_NEAR(observeWithCutoff("0.1", z(0) * z(1)),
+              std::cos(0.3) * std::cos(1.4), tolerance);
+  EXPECT_NEAR(observeWithCutoff("0.2", z(0) * z(1)), 0.0, tolerance);
+  EXPECT_NEAR(observeWithCutoff("0.2", z(0)), std::cos(0.3), tolerance);
+}
+
+CUDAQ_TEST(CpuPauliPropagationTester, checkInvalidSettings) {
+  for (const char *value : {"-0.1", "1.0", "small", ""}) {
+    setenv("CUDAQ_PAULI_PROPAGATION_CUTOFF", value, 1);
+    EXPECT_THROW(CpuPauliPropagationSimulator(), std::runtime_error) << value;
+  }
+  unsetenv("CUDAQ_PAULI_PROPAGATION_CUTOFF");
+  for (const char *value : {"0", "-2", "all", ""}) {
+    setenv("CUDAQ_PAULI_PROPAGATION_MAX_WEIGHT", value, 1);
+    EXPECT_THROW(CpuPauliPropagationSimulator(), std::runtime_error) << value;
+  }
+  unsetenv("CUDAQ_PAULI_PROPAGATION_MAX_WEIGHT");
+}
+
+CUDAQ_TEST(CpuPauliPropagationTester, checkUnsupportedOperations) {
+  CpuPauliPropagationSimulator sim;
+  auto qubits = sim.allocateQubits(6);
+  sim.x({qubits[0], qubits[1], qubits[2], qubits[3], qubits[4]}, qubits[5]);
+  EXPECT_THROW(sim.observe(cudaq::spin::z(5)), std::runtime_error);
+
+  // The state is never computed, so it cannot be initialized from data.
+  std::vector<std::complex<double>> plus(2, M_SQRT1_2);
+  EXPECT_THROW(
+      sim.allocateQubits(1, plus.data(), cudaq::simulation_precision::fp64),
+      std::runtime_error);
+  sim.deallocateQubits(qubits);
+}
+
+CUDAQ_TEST(CpuPauliPropagationTester, checkSamplingThrows) {
+  CpuPauliPropagationSimulator sim;
+  auto qubits = sim.allocateQubits(2);
+  sim.h(qubits[0]);
+  EXPECT_ANY_THROW(sim.mz(qubits[0]));
+
+  cudaq::ExecutionContext ctx("sample", 100);
+  sim.setExecutionContext(&ctx);
+  sim.mz(qubits[0]);
+  EXPECT_ANY_THROW(sim.resetExecutionContext());
+}
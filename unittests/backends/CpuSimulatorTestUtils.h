@@ -0,0 +1,55 @@
+/****************************************************************-*- C++ -*-****
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#pragma once
+
+#include <complex>
+#include <gtest/gtest.h>
+#include <vector>
+
+/// Helpers for the tests of the CPU simulators, which check the state of a
+/// simulator against the state of a reference simulator. The sampling and
+/// kernel level behavior is covered by the runtime tests of each backend.
+namespace nvqir::test {
+
+/// @brief Expect the amplitudes of \p got and \p want to be equal up to
+/// \p tolerance.
+template <typename ScalarTypeA, typename ScalarTypeB>
+void expectStateNear(const std::vector<std::complex<ScalarTypeA>> &got,
+                     const std::vector<std::complex<ScalarTypeB>> &want,
+                     double tolerance) {
+  ASSERT_EQ(got.size(), want.size());
+  for (std::size_t i = 0; i < want.size(); ++i) {
+    EXPECT_NEAR(got[i].real(), want[i].real(), tolerance) << "at " << i;
+    EXPECT_NEAR(got[i].imag(), want[i].imag(), tolerance) << "at " << i;
+  }
+}
+
+/// @brief Apply a circuit on at least 5 \p qubits, with single qubit
+/// rotations on all of them, controlled gates between distant qubits and
+/// multi-target gates.
+template <typename Simulator>
+void applyTestCircuit(Simulator &sim, const std::vector<std::size_t> &qubits) {
+  const std::size_t n = qubits.size();
+  for (std::size_t i = 0; i < n; ++i) {
+    sim.ry(0.1 + 0.2 * i, qubits[i]);
+    sim.rz(0.3 * i, qubits[i]);
+  }
+  sim.h(qubits[n - 1]);
+  sim.x({qubits[n - 1]}, qubits[0]);
+  sim.x({qubits[1]}, qubits[n - 1]);
+  sim.rx(0.4, qubits[2]);
+  sim.swap({qubits[2]}, qubits[n - 1], qubits[n - 2]);
+  sim.x({qubits[n - 1], qubits[n - 2]}, qubits[1]);
+  sim.r1(0.7, qubits[n - 3]);
+  sim.swap(qubits[0], qubits[n - 1]);
+  sim.h(qubits[n - 2]);
+  sim.t(qubits[0]);
+}
+
+} // namespace nvqir::test
@@ -0,0 +1,188 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <math.h>
+
+#include "CUDAQTestUtils.h"
+#include "CpuCircuitSimulator.h"
+#include "CpuSparseCircuitSimulator.h"
+#include "backends/CpuSimulatorTestUtils.h"
+
+using namespace nvqir;
+
+namespace {
+constexpr double tolerance = 1e-10;
+
+/// Create a simulator switching to a dense state vector past \p maxDensity.
+std::unique_ptr<CpuSparseCircuitSimulator>
+createSimulator(const std::string &maxDensity) {
+  setenv("CUDAQ_SPARSE_MAX_DENSITY", maxDensity.c_str(), 1);
+  auto sim = std::make_unique<CpuSparseCircuitSimulator>();
+  unsetenv("CUDAQ_SPARSE_MAX_DENSITY");
+  return sim;
+}
+} // namespace
+
+CUDAQ_TEST(CpuSparseTester, checkMatchesReference) {
+  // The state stays sparse with a max density of 1, and is converted to a
+  // dense state vector midway with the default one.
+  for (const std::string maxDensity : {"1", "0.125"}) {
+    auto sim = createSimulator(maxDensity);
+    CpuCircuitSimulator<double> reference;
+    auto qubits = sim->allocateQubits(8);
+    reference.allocateQubits(8);
+    test::applyTestCircuit(*sim, qubits);
+    test::applyTestCircuit(reference, qubits);
+    test::expectStateNear(sim->getStateVector(), reference.getStateVector(),
+                          tolerance);
+
+    using cudaq::spin::x, cudaq::spin::y, cudaq::spin::z;
+    const auto op = x(7) * z(0) + 0.5 * y(1) * z(6) * x(7) - 2.0 * y(5);
+    EXPECT_NEAR(sim->observe(op).expectation(),
+                reference.observe(op).expectation(), tolerance);
+    sim->deallocateQubits(qubits);
+    reference.deallocateQubits(qubits);
+  }
+}
+
+CUDAQ_TEST(CpuSparseTester, checkReversibleOnManyQubits) {
+  CpuSparseCircuitSimulator sim;
+  const std::size_t numQubits = 60;
+  auto qubits = sim.allocateQubits(numQubits);
+  // Increment the 59 bit register by 3, from 1, with a ripple of Toffoli
+  // and CNOT gates on the carry.
+  sim.x(qubits[0]);
+  for (std::size_t rep = 0; rep < 3; ++rep) {
+    for (std::size_t q = numQubits - 2; q > 0; --q) {
+      std::vector<std::size_t> controls(qubits.begin(), qubits.begin() + q);
+      sim.x(controls, qubits[q]);
+    }
+    sim.x(qubits[0]);
+  }
+  sim.x({qubits[2]}, qubits[numQubits - 1]);
+  EXPECT_EQ(sim.getNumAmplitudes(), 1);
+
+  // 1 + 3 = 4, and the last qubit copies bit 2.
+  for (std::size_t q = 0; q < numQubits; ++q)
+    EXPECT_EQ(sim.mz(qubits[q]), q == 2 || q == numQubits - 1);
+  sim.deallocateQubits(qubits);
+}
+
+CUDAQ_TEST(CpuSparseTester, checkBranchingAndPruning) {
+  CpuSparseCircuitSimulator sim;
+  auto qubits = sim.allocateQubits(50);
+  for (std::size_t q = 0; q < 10; ++q)
+    sim.h(qubits[q]);
+  std::vector<std::size_t> controls(qubits.begin(), qubits.begin() + 10);
+  sim.x(controls, qubits[49]);
+  EXPECT_EQ(sim.getNumAmplitudes(), 1024);
+  using cudaq::spin::x, cudaq::spin::z;
+  EXPECT_NEAR(sim.observe(z(49)).expectation(), 1.0 - 2.0 / 1024, tolerance);
+  EXPECT_NEAR(sim.observe(x(0)).expectation(), 1.0 - 2.0 / 1024, tolerance);
+
+  // Undo the oracle, the Hadamard gates then interfere back to |0>.
+  sim.x(controls, qubits[49]);
+  for (std::size_t q = 0; q < 10; ++q)
+    sim.h(qubits[q]);
+  EXPECT_EQ(sim.getNumAmplitudes(), 1);
+  EXPECT_NEAR(sim.observe(z(0) * z(9)).expectation(), 1.0, tolerance);
+  sim.deallocateQubits(qubits);
+}
+
+CUDAQ_TEST(CpuSparseTester, checkDenseFallback) {
+  CpuSparseCircuitSimulator sim;
+  const std::size_t numQubits = 14;
+  auto qubits = sim.allocateQubits(numQubits);
+  for (std::size_t q = 0; q < numQubits - 1; ++q)
+    sim.h(qubits[q]);
+  // The state is dense past 1/8 of non-zero amplitudes.
+  EXPECT_EQ(sim.getNumAmplitudes(), 1ULL << numQubits);
+  auto state = sim.getStateVector();
+  const double amplitude = 1.0 / std::sqrt(state.size() / 2);
+  for (std::size_t i = 0; i < state.size(); ++i)
+    EXPECT_NEAR(std::abs(state[i]), i < state.size() / 2 ? amplitude : 0.0,
+                tolerance);
+
+  // Measuring most of the qubits makes it sparse again.
+  for (std::size_t q = 0; q < numQubits - 2; ++q)
+    sim.mz(qubits[q]);
+  EXPECT_EQ(sim.getNumAmplitudes(), 2);
+  using cudaq::spin::x;
+  EXPECT_NEAR(sim.observe(x(numQubits - 2)).expectation(), 1.0, tolerance);
+  sim.deallocateQubits(qubits);
+}
+
+CUDAQ_TEST(CpuSparseTester, checkMaxAmplitudes) {
+  setenv("CUDAQ_SPARSE_MAX_AMPLITUDES", "100", 1);
+  CpuSparseCircuitSimulator sim;
+  unsetenv("CUDAQ_SPARSE_MAX_AMPLITUDES");
+  auto qubits = sim.allocateQubits(40);
+  for (std::size_t q = 0; q < 6; ++q)
+    sim.h(qubits[q]);
+  EXPECT_EQ(sim.getNumAmplitudes(), 64);
+  // Like the gate itself, the error is deferred until the gate queue is
+  // flushed.
+  sim.h(qubits[6]);
+  EXPECT_THROW(sim.getNumAmplitudes(), std::runtime_error);
+}
+
+CUDAQ_TEST(CpuSparseTester, checkMaxQubits) {
+  // The all ones index of 64 qubits is the empty key of the table, but the
+  // one of 63 qubits is a valid basis state.
+  CpuSparseCircuitSimulator sim;
+  auto qubits = sim.allocateQubits(63);
+  for (auto q : qubits)
+    sim.x(q);
+  sim.h(qubits[62]);
+  EXPECT_EQ(sim.getNumAmplitudes(), 2);
+  sim.h(qubits[62]);
+  EXPECT_EQ(sim.getNumAmplitudes(), 1);
+  for (auto q : qubits)
+    EXPECT_TRUE(sim.mz(q));
+  EXPECT_THROW(sim.allocateQubit(), std::runtime_error);
+  sim.deallocateQubits(qubits);
+}
+
+CUDAQ_TEST(CpuSparseTester, checkInvalidSettings) {
+  for (const char *value : {"-0.1", "1.0", "tiny", ""}) {
+    setenv("CUDAQ_SPARSE_TOLERANCE", value, 1);
+    EXPECT_THROW(CpuSparseCircuitSimulator(), std::runtime_error) << value;
+  }
+  unsetenv("CUDAQ_SPARSE_TOLERANCE");
+  for (const char *value : {"0", "1.5", "dense", ""}) {
+    setenv("CUDAQ_SPARSE_MAX_DENSITY", value, 1);
+    EXPECT_THROW(CpuSparseCircuitSimulator(), std::runtime_error) << value;
+  }
+  unsetenv("CUDAQ_SPARSE_MAX_DENSITY");
+  setenv("CUDAQ_SPARSE_MAX_AMPLITUDES", "0", 1);
+  EXPECT_THROW(CpuSparseCircuitSimulator(), std::runtime_error);
+  unsetenv("CUDAQ_SPARSE_MAX_AMPLITUDES");
+}
+
+CUDAQ_TEST(CpuSparseTester, checkSample) {
+  CpuSparseCircuitSimulator sim;
+  sim.setRandomSeed(13);
+  const std::size_t numQubits = 50;
+  auto qubits = sim.allocateQubits(numQubits);
+  sim.rx(0.6, qubits[0]);
+  for (std::size_t q = 0; q + 1 < numQubits; ++q)
+    sim.x({qubits[q]}, qubits[q + 1]);
+
+  cudaq::ExecutionContext ctx("sample", 10000);
+  sim.setExecutionContext(&ctx);
+  for (auto q : {0, 49})
+    sim.mz(q);
+  sim.resetExecutionContext();
+  auto counts = ctx.result;
+  EXPECT_EQ(counts.size(), 2);
+  EXPECT_EQ(counts.count("00") + counts.count("11"), 10000);
+  EXPECT_NEAR(counts.count("11") / 10000.0, std::pow(std::sin(0.3), 2),
+              0.02);
+  sim.deallocateQubits(qubits);
+}
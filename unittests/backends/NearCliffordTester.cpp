@@ -0,0 +1,197 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <math.h>
+
+#include "CUDAQTestUtils.h"
+#include "CpuCircuitSimulator.h"
+#include "NearCliffordCircuitSimulator.h"
+#include "backends/CpuSimulatorTestUtils.h"
+
+using namespace nvqir;
+
+namespace {
+constexpr double tolerance = 1e-10;
+
+/// Apply T, rotation and Toffoli gates after a mid-circuit measurement.
+void applyAfterMeasurement(CircuitSimulator &sim,
+                           const std::vector<std::size_t> &qubits) {
+  sim.t(qubits[2]);
+  sim.x({qubits[2], qubits[0]}, qubits[5]);
+  sim.rx(0.3, qubits[2]);
+  sim.ry(0.8, qubits[4]);
+  sim.rz(1.1, qubits[5]);
+  sim.h(qubits[3]);
+  sim.x({qubits[3]}, qubits[2]);
+}
+} // namespace
+
+CUDAQ_TEST(NearCliffordTester, checkMatchesReference) {
+  NearCliffordCircuitSimulator sim;
+  CpuCircuitSimulator<double> reference;
+  sim.setRandomSeed(13);
+  auto qubits = sim.allocateQubits(6);
+  reference.allocateQubits(6);
+  test::applyTestCircuit(sim, qubits);
+  test::applyTestCircuit(reference, qubits);
+
+  // Project the reference on the outcome of the mid-circuit measurement.
+  const bool result = sim.mz(qubits[2]);
+  auto projected = reference.getStateVector();
+  double norm = 0.0;
+  for (std::size_t i = 0; i < projected.size(); ++i) {
+    if (static_cast<bool>((i >> qubits[2]) & 1) != result)
+      projected[i] = 0.0;
+    norm += std::norm(projected[i]);
+  }
+  ASSERT_GT(norm, tolerance);
+  for (auto &amplitude : projected)
+    amplitude /= std::sqrt(norm);
+  reference.deallocateQubits(qubits);
+  reference.allocateQubits(6, projected.data(),
+                           cudaq::simulation_precision::fp64);
+  applyAfterMeasurement(sim, qubits);
+  applyAfterMeasurement(reference, qubits);
+
+  using cudaq::spin::x, cudaq::spin::y, cudaq::spin::z;
+  const auto op = x(5) * z(0) + 0.5 * y(1) * z(2) * x(3) - 2.0 * y(2) +
+                  1.5 * z(1) * z(4);
+  EXPECT_NEAR(sim.observe(op).expectation(),
+              reference.observe(op).expectation(), tolerance);
+
+  // The frequencies of the outcomes match the reference probabilities.
+  const std::size_t shots = 10000;
+  const std::vector<std::size_t> measured{qubits[5], qubits[2], qubits[0]};
+  cudaq::ExecutionContext ctx("sample", shots);
+  sim.setExecutionContext(&ctx);
+  for (auto q : measured)
+    sim.mz(q);
+  sim.resetExecutionContext();
+  std::vector<double> want(1ULL << measured.size(), 0.0);
+  const auto state = reference.getStateVector();
+  for (std::size_t i = 0; i < state.size(); ++i) {
+    std::size_t outcome = 0;
+    for (std::size_t k = 0; k < measured.size(); ++k)
+      outcome |= ((i >> measured[k]) & 1) << k;
+    want[outcome] += std::norm(state[i]);
+  }
+  const auto counts = ctx.result.to_map();
+  for (std::size_t outcome = 0; outcome < want.size(); ++outcome) {
+    std::string bits;
+    for (std::size_t k = 0; k < measured.size(); ++k)
+      bits += (outcome >> k) & 1 ? '1' : '0';
+    const auto iter = counts.find(bits);
+    const double frequency =
+        iter == counts.end() ? 0.0 : static_cast<double>(iter->second) / shots;
+    EXPECT_NEAR(frequency, want[outcome], 0.02) << bits;
+  }
+  sim.deallocateQubits(qubits);
+  reference.deallocateQubits(qubits);
+}
+
+CUDAQ_TEST(NearCliffordTester, checkTGateOnManyQubits) {
+  NearCliffordCircuitSimulator sim;
+  const std::size_t numQubits = 200;
+  auto qubits = sim.allocateQubits(numQubits);
+  // <Z> of H T H |0> is cos(pi / 4).
+  sim.h(qubits[0]);
+  sim.t(qubits[0]);
+  sim.h(qubits[0]);
+  for (std::size_t q = 0; q + 1 < numQubits; ++q)
+    sim.x({qubits[q]}, qubits[q + 1]);
+
+  using cudaq::spin::x, cudaq::spin::z;
+  EXPECT_NEAR(sim.observe(z(numQubits - 1)).expectation(), M_SQRT1_2,
+              tolerance);
+  EXPECT_NEAR(sim.observe(z(0) * z(numQubits - 1)).expectation(), 1.0,
+              tolerance);
+  EXPECT_NEAR(sim.observe(x(numQubits / 2)).expectation(), 0.0, tolerance);
+  EXPECT_EQ(sim.getNumTerms(), 2);
+
+  // Rotations by multiples of pi/2 are Clifford gates.
+  sim.rx(M_PI_2, qubits[3]);
+  sim.rz(-M_PI, qubits[3]);
+  EXPECT_EQ(sim.getNumTerms(), 2);
+  sim.deallocateQubits(qubits);
+}
+
+CUDAQ_TEST(NearCliffordTester, checkToffoli) {
+  NearCliffordCircuitSimulator sim;
+  auto qubits = sim.allocateQubits(80);
+  sim.x(qubits[0]);
+  sim.h(qubits[70]);
+  sim.x({qubits[70]}, qubits[40]);
+  sim.x({qubits[0], qubits[40]}, qubits[79]);
+  using cudaq::spin::z;
+  EXPECT_NEAR(sim.observe(z(70) * z(79)).expectation(), 1.0, tolerance);
+  EXPECT_NEAR(sim.observe(z(79)).expectation(), 0.0, tolerance);
+
+  const bool result = sim.mz(qubits[79]);
+  EXPECT_EQ(sim.mz(qubits[70]), result);
+  EXPECT_EQ(sim.mz(qubits[40]), result);
+  sim.resetQubit(qubits[79]);
+  EXPECT_FALSE(sim.mz(qubits[79]));
+  EXPECT_TRUE(sim.mz(qubits[0]));
+  sim.deallocateQubits(qubits);
+}
+
+CUDAQ_TEST(NearCliffordTester, checkSample) {
+  NearCliffordCircuitSimulator sim;
+  sim.setRandomSeed(13);
+  const std::size_t numQubits = 100;
+  auto qubits = sim.allocateQubits(numQubits);
+  sim.rx(0.6, qubits[0]);
+  for (std::size_t q = 0; q + 1 < numQubits; ++q)
+    sim.x({qubits[q]}, qubits[q + 1]);
+  sim.h(qubits[50]);
+  sim.t(qubits[50]);
+
+  cudaq::ExecutionContext ctx("sample", 10000);
+  sim.setExecutionContext(&ctx);
+  for (auto q : {0, 99})
+    sim.mz(q);
+  sim.resetExecutionContext();
+  auto counts = ctx.result;
+  EXPECT_EQ(counts.size(), 2);
+  EXPECT_EQ(counts.count("00") + counts.count("11"), 10000);
+  EXPECT_NEAR(counts.count("11") / 10000.0, std::pow(std::sin(0.3), 2),
+              0.02);
+  sim.deallocateQubits(qubits);
+}
+
+CUDAQ_TEST(NearCliffordTester, checkMaxTerms) {
+  setenv("CUDAQ_NEAR_CLIFFORD_MAX_TERMS", "4", 1);
+  NearCliffordCircuitSimulator sim;
+  unsetenv("CUDAQ_NEAR_CLIFFORD_MAX_TERMS");
+  auto qubits = sim.allocateQubits(3);
+  for (auto q : qubits)
+    sim.h(q);
+  sim.t(qubits[0]);
+  sim.t(qubits[1]);
+  EXPECT_EQ(sim.getNumTerms(), 4);
+
+  // The error names the setting to raise.
+  sim.t(qubits[2]);
+  try {
+    sim.observe(cudaq::spin::z(0));
+    ADD_FAILURE() << "Expected the term budget to be exceeded.";
+  } catch (const std::runtime_error &e) {
+    EXPECT_NE(std::string(e.what()).find("CUDAQ_NEAR_CLIFFORD_MAX_TERMS"),
+              std::string::npos)
+        << e.what();
+  }
+}
+
+CUDAQ_TEST(NearCliffordTester, checkInvalidSettings) {
+  for (const char *value : {"0", "-3", "many", ""}) {
+    setenv("CUDAQ_NEAR_CLIFFORD_MAX_TERMS", value, 1);
+    EXPECT_THROW(NearCliffordCircuitSimulator(), std::runtime_error) << value;
+  }
+  unsetenv("CUDAQ_NEAR_CLIFFORD_MAX_TERMS");
+}
@@ -1236,3 +1236,89 @@ CUDAQ_TEST(QPPTester, checkReset) {
     EXPECT_EQ(1, qppBackend.mz(q1));
   }
 }
+
+CUDAQ_TEST(QPPTester, checkExpPauli) {
+  // Compare with the decomposition of the base class, with and without
+  // controls, and for a diagonal Pauli product.
+  using cudaq::spin::x, cudaq::spin::y, cudaq::spin::z;
+  const cudaq::spin_op ops[] = {x(0) * y(1) * z(2), y(0) * x(2), z(0) * z(1)};
+  for (const auto &op : ops) {
+    for (bool controlled : {false, true}) {
+      qpp::ket states[2];
+      for (int decompose = 0; decompose < 2; ++decompose) {
+        QppCircuitSimulator<qpp::ket> qppBackend;
+        auto qubits = qppBackend.allocateQubits(4);
+        for (auto q : qubits)
+          qppBackend.ry(0.3 + 0.2 * q, q);
+        std::vector<std::size_t> controls;
+        if (controlled)
+          controls.push_back(qubits[0]);
+        const std::vector<std::size_t> targets{qubits[3], qubits[1],
+                                               qubits[2]};
+        if (decompose)
+          qppBackend.CircuitSimulator::applyExpPauli(0.41, controls, targets,
+                                                     op);
+        else
+          qppBackend.applyExpPauli(0.41, controls, targets, op);
+        states[decompose] = qppBackend.getStateVector();
+        qppBackend.deallocateQubits(qubits);
+      }
+      EXPECT_NEAR((states[0] - states[1]).norm(), 0.0, 1e-12);
+    }
+  }
+}
+
+CUDAQ_TEST(QPPTester, checkMeasureAndSampleMatchQpp) {
+  QppCircuitSimulator<qpp::ket> qppBackend;
+  auto qubits = qppBackend.allocateQubits(4);
+  for (auto q : qubits)
+    qppBackend.ry(0.3 + 0.4 * q, q);
+  qppBackend.x({qubits[0]}, qubits[2]);
+  const qpp::ket prepared = qppBackend.getStateVector();
+  const auto toQppIndex = [&](std::size_t q) { return qubits.size() - 1 - q; };
+
+  // The frequencies of the fast path match the ones of `qpp::sample`.
+  const std::size_t shots = 10000;
+  const std::vector<std::size_t> measured{qubits[2], qubits[0], qubits[3]};
+  cudaq::ExecutionContext ctx("sample", shots);
+  qppBackend.setExecutionContext(&ctx);
+  for (auto q : measured)
+    qppBackend.mz(q);
+  qppBackend.resetExecutionContext();
+  std::vector<qpp::idx> measuredBits;
+  for (auto q : measured)
+    measuredBits.push_back(toQppIndex(q));
+  std::map<std::string, double> want;
+  for (const auto &[result, count] :
+       qpp::sample(shots, prepared, measuredBits, 2)) {
+    std::string bits;
+    for (auto bit : result)
+      bits += bit ? '1' : '0';
+    want[bits] = static_cast<double>(count) / shots;
+  }
+  const auto got = ctx.result.to_map();
+  for (std::size_t i = 0; i < (1ULL << measured.size()); ++i) {
+    std::string bits;
+    for (std::size_t k = 0; k < measured.size(); ++k)
+      bits += (i >> k) & 1 ? '1' : '0';
+    const auto iter = got.find(bits);
+    const double frequency =
+        iter == got.end() ? 0.0 : static_cast<double>(iter->second) / shots;
+    EXPECT_NEAR(frequency, want[bits], 0.03) << bits;
+  }
+
+  // The in-place collapse gives the post-measurement state of `qpp::measure`.
+  for (auto q : qubits) {
+    const qpp::ket before = qppBackend.getStateVector();
+    const auto measurement_tuple =
+        qpp::measure(before, qpp::cmat::Identity(2, 2), {toQppIndex(q)},
+                     /*qudit dimension=*/2, /*destructive measmt=*/false);
+    const bool result = qppBackend.mz(q);
+    EXPECT_GT(std::get<qpp::PROB>(measurement_tuple)[result], 0.0);
+    const auto &collapsed = std::get<qpp::ST>(measurement_tuple)[result];
+    const qpp::ket expected =
+        Eigen::Map<const qpp::ket>(collapsed.data(), collapsed.size());
+    EXPECT_NEAR((qppBackend.getStateVector() - expected).norm(), 0.0, 1e-12);
+  }
+  qppBackend.deallocateQubits(qubits);
+}
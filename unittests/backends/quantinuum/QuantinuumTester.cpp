@@ -8,6 +8,7 @@
 
 #include "CUDAQTestUtils.h"
 #include "common/FmtCore.h"
+#include "common/LateBinding.h"
 #include "cudaq/algorithm.h"
 #include <fstream>
 #include <gtest/gtest.h>
@@ -192,6 +193,40 @@ CUDAQ_TEST(QuantinuumTester, checkObserveSyncEmulate) {
   EXPECT_TRUE(isValidExpVal(result.expectation()));
 }
 
+CUDAQ_TEST(QuantinuumTester, checkObserveSyncEmulateLateBinding) {
+  std::string home = std::getenv("HOME");
+  std::string fileName = home + "/FakeCppQuantinuum.config";
+  auto backendString =
+      fmt::format(fmt::runtime(backendStringTemplate), mockPort, fileName);
+  backendString =
+      std::regex_replace(backendString, std::regex("false"), "true");
+  backendString += ";late_binding;true";
+
+  auto &platform = cudaq::get_platform();
+  platform.setTargetBackend(backendString);
+
+  auto [kernel, theta] = cudaq::make_kernel<double>();
+  auto qubit = kernel.qalloc(2);
+  kernel.x(qubit[0]);
+  kernel.ry(theta, qubit[1]);
+  kernel.x<cudaq::ctrl>(qubit[1], qubit[0]);
+
+  using namespace cudaq::spin;
+  cudaq::spin_op h = 5.907 - 2.1433 * x(0) * x(1) - 2.1433 * y(0) * y(1) +
+                     .21829 * z(0) - 6.125 * z(1);
+  auto compileCount = cudaq::opt::getStructuralCompileCount();
+  auto result = cudaq::observe(100000, kernel, h, .59);
+  printf("ENERGY: %lf\n", result.expectation());
+  EXPECT_TRUE(isValidExpVal(result.expectation()));
+  EXPECT_EQ(cudaq::opt::getStructuralCompileCount(), compileCount + 1);
+
+  // The second launch reuses the lowered code and only binds the new angle.
+  result = cudaq::observe(100000, kernel, h, 0.);
+  printf("ENERGY: %lf\n", result.expectation());
+  EXPECT_NEAR(result.expectation(), 5.907 - .21829 - 6.125, 0.1);
+  EXPECT_EQ(cudaq::opt::getStructuralCompileCount(), compileCount + 1);
+}
+
 CUDAQ_TEST(QuantinuumTester, checkObserveAsync) {
   std::string home = std::getenv("HOME");
   std::string fileName = home + "/FakeCppQuantinuum.config";
@@ -0,0 +1,114 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "common/Executor.h"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+
+namespace {
+/// Server helper that creates one job message per kernel execution.
+class MockServerHelper : public cudaq::ServerHelper {
+public:
+  const std::string name() const override { return "mock"; }
+  void initialize(cudaq::BackendConfig config) override {
+    backendConfig = config;
+  }
+  cudaq::RestHeaders getHeaders() override { return {}; }
+  cudaq::ServerJobPayload
+  createJob(std::vector<cudaq::KernelExecution> &circuitCodes) override {
+    std::vector<cudaq::ServerMessage> jobs;
+    for (auto &code : circuitCodes)
+      jobs.push_back({{"name", code.name}});
+    return {"jobs", {}, jobs};
+  }
+  std::string extractJobId(cudaq::ServerMessage &postResponse) override {
+    return postResponse.at("id");
+  }
+  std::string constructGetJobPath(std::string &jobId) override { return jobId; }
+  std::string constructGetJobPath(cudaq::ServerMessage &) override {
+    return "";
+  }
+  bool jobIsDone(cudaq::ServerMessage &) override { return true; }
+  cudaq::sample_result processResults(cudaq::ServerMessage &,
+                                      std::string &) override {
+    return {};
+  }
+};
+
+/// Executor that records how many jobs are posted at the same time, instead
+/// of posting them to a server.
+class MockExecutor : public cudaq::Executor {
+public:
+  std::atomic<std::size_t> inFlight = 0;
+  std::atomic<std::size_t> maxInFlight = 0;
+
+protected:
+  cudaq::ServerMessage postJob(const std::string &, cudaq::ServerMessage &job,
+                               cudaq::RestHeaders &) override {
+    auto current = ++inFlight;
+    auto max = maxInFlight.load();
+    while (current > max && !maxInFlight.compare_exchange_weak(max, current))
+      ;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    --inFlight;
+    return {{"id", "id_" + job.at("name").get<std::string>()}};
+  }
+};
+
+/// Execute \p numJobs jobs with \p executor and return the ids of the jobs of
+/// the resulting future, in order.
+std::vector<std::string> execute(MockExecutor &executor, std::size_t numJobs) {
+  MockServerHelper serverHelper;
+  executor.setServerHelper(&serverHelper);
+  std::vector<cudaq::KernelExecution> codes;
+  for (std::size_t i = 0; i < numJobs; ++i) {
+    std::string name = std::to_string(i);
+    std::string code;
+    nlohmann::json outputNames;
+    std::vector<std::size_t> mapping;
+    codes.emplace_back(name, code, outputNames, mapping);
+  }
+  auto future = executor.execute(codes);
+  std::stringstream ss;
+  ss << future;
+  auto persisted = nlohmann::json::parse(ss.str());
+  std::vector<std::string> ids;
+  for (auto &job : persisted["jobs"])
+    ids.push_back(job[0]);
+  return ids;
+}
+} // namespace
+
+TEST(ExecutorTester, checkDefaultConcurrentSubmissions) {
+  MockExecutor executor;
+  auto ids = execute(executor, 32);
+  EXPECT_GT(executor.maxInFlight, 1);
+  EXPECT_LE(executor.maxInFlight, 8);
+  // The jobs are in the order of the kernel executions.
+  ASSERT_EQ(ids.size(), 32);
+  for (std::size_t i = 0; i < ids.size(); ++i)
+    EXPECT_EQ(ids[i], "id_" + std::to_string(i));
+}
+
+TEST(ExecutorTester, checkMaxConcurrentSubmissions) {
+  MockExecutor executor;
+  executor.setMaxConcurrentSubmissions(2);
+  auto ids = execute(executor, 16);
+  EXPECT_LE(executor.maxInFlight, 2);
+  EXPECT_EQ(ids.size(), 16);
+}
+
+TEST(ExecutorTester, checkSequentialSubmissions) {
+  MockExecutor executor;
+  executor.setMaxConcurrentSubmissions(1);
+  auto ids = execute(executor, 4);
+  EXPECT_EQ(executor.maxInFlight, 1);
+  EXPECT_EQ(ids.size(), 4);
+}
@@ -0,0 +1,141 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "common/JIT.h"
+#include "llvm/ExecutionEngine/Orc/CompileUtils.h"
+#include "llvm/IRReader/IRReader.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetSelect.h"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+
+namespace {
+const char *addIr = R"#(
+define i32 @add(i32 %a, i32 %b) {
+  %r = add i32 %a, %b
+  ret i32 %r
+}
+)#";
+
+/// Object cache that counts its hits and stores.
+class CountingObjectCache : public cudaq::JITObjectCache {
+public:
+  using cudaq::JITObjectCache::JITObjectCache;
+
+  void notifyObjectCompiled(const llvm::Module *module,
+                            llvm::MemoryBufferRef object) override {
+    ++stores;
+    cudaq::JITObjectCache::notifyObjectCompiled(module, object);
+  }
+
+  std::unique_ptr<llvm::MemoryBuffer>
+  getObject(const llvm::Module *module) override {
+    auto object = cudaq::JITObjectCache::getObject(module);
+    if (object)
+      ++hits;
+    return object;
+  }
+
+  int stores = 0;
+  int hits = 0;
+};
+
+/// JIT compile `addIr` with \p cache and return `add(a, b)`.
+int jitAndAdd(CountingObjectCache &cache, int a, int b) {
+  auto ctx = std::make_unique<llvm::LLVMContext>();
+  llvm::SMDiagnostic err;
+  auto module = llvm::parseIR(llvm::MemoryBufferRef(addIr, "add"), err, *ctx);
+  EXPECT_TRUE(module);
+  llvm::orc::LLJITBuilder jitBuilder;
+  jitBuilder.setCompileFunctionCreator(
+      [&cache](llvm::orc::JITTargetMachineBuilder jtmb)
+          -> llvm::Expected<
+              std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
+        auto tm = jtmb.createTargetMachine();
+        if (!tm)
+          return tm.takeError();
+        return std::make_unique<llvm::orc::TMOwningSimpleCompiler>(
+            std::move(*tm), &cache);
+      });
+  auto jit = llvm::cantFail(jitBuilder.create());
+  llvm::cantFail(jit->addIRModule(
+      llvm::orc::ThreadSafeModule(std::move(module), std::move(ctx))));
+  auto symbol = llvm::cantFail(jit->lookup("add"));
+  return symbol.toPtr<int (*)(int, int)>()(a, b);
+}
+} // namespace
+
+TEST(JITObjectCacheTester, checkReuse) {
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+
+  llvm::SmallString<128> cacheDir;
+  ASSERT_FALSE(
+      llvm::sys::fs::createUniqueDirectory("cudaq-jit-cache", cacheDir));
+  CountingObjectCache cache(cacheDir.str().str());
+
+  // The first JIT compiles the module and stores its object.
+  EXPECT_EQ(jitAndAdd(cache, 1, 2), 3);
+  EXPECT_EQ(cache.hits, 0);
+  EXPECT_EQ(cache.stores, 1);
+
+  // The second JIT of the same module is served from the cache.
+  EXPECT_EQ(jitAndAdd(cache, 3, 4), 7);
+  EXPECT_EQ(cache.hits, 1);
+  EXPECT_EQ(cache.stores, 1);
+
+  // So is a JIT through another cache on the same directory, as in another
+  // process.
+  CountingObjectCache otherCache(cacheDir.str().str());
+  EXPECT_EQ(jitAndAdd(otherCache, 5, 6), 11);
+  EXPECT_EQ(otherCache.hits, 1);
+  EXPECT_EQ(otherCache.stores, 0);
+
+  llvm::sys::fs::remove_directories(cacheDir);
+}
+
+TEST(JITObjectCacheTester, checkPrune) {
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+
+  llvm::SmallString<128> cacheDir;
+  ASSERT_FALSE(
+      llvm::sys::fs::createUniqueDirectory("cudaq-jit-cache", cacheDir));
+  const std::filesystem::path dir(cacheDir.str().str());
+  auto writeObject = [&](const std::string &name, std::size_t size) {
+    std::ofstream(dir / name) << std::string(size, 'x');
+    return dir / name;
+  };
+  // An object that was not used for longer than the maximum age, and a recent
+  // one that does not fit in the size bound along with the new object.
+  const auto stale = writeObject("stale.o", 16);
+  std::filesystem::last_write_time(
+      stale, std::filesystem::file_time_type::clock::now() -
+                 cudaq::JITObjectCache::maxAge - std::chrono::hours(1));
+  const auto large = writeObject("large.o", 1 << 20);
+  std::filesystem::last_write_time(
+      large,
+      std::filesystem::file_time_type::clock::now() - std::chrono::hours(1));
+  const auto other = writeObject("other.txt", 1 << 20);
+
+  CountingObjectCache cache(dir.string(), /*maxSize=*/1 << 19);
+  EXPECT_EQ(jitAndAdd(cache, 1, 2), 3);
+  EXPECT_EQ(cache.stores, 1);
+  EXPECT_FALSE(std::filesystem::exists(stale));
+  EXPECT_FALSE(std::filesystem::exists(large));
+  EXPECT_TRUE(std::filesystem::exists(other));
+
+  // The new object is kept, and reused.
+  EXPECT_EQ(jitAndAdd(cache, 3, 4), 7);
+  EXPECT_EQ(cache.hits, 1);
+  EXPECT_EQ(cache.stores, 1);
+
+  llvm::sys::fs::remove_directories(cacheDir);
+}
@@ -0,0 +1,81 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "common/JobPoller.h"
+#include <atomic>
+#include <gtest/gtest.h>
+
+using cudaq::details::JobPoller;
+
+namespace {
+/// Return a poll function for a job that is done on its \p numPolls-th poll,
+/// counting the polls in \p counter.
+JobPoller::PollFunction makeJob(int numPolls, std::atomic<int> &counter,
+                                std::chrono::microseconds interval) {
+  return [numPolls, &counter, interval]() {
+    JobPoller::PollResult result;
+    result.done = ++counter >= numPolls;
+    result.response = {{"polls", counter.load()}};
+    result.interval = interval;
+    return result;
+  };
+}
+} // namespace
+
+TEST(JobPollerTester, checkJobsFinishOutOfOrder) {
+  std::atomic<int> slowPolls = 0;
+  std::atomic<int> fastPolls = 0;
+  JobPoller poller;
+  auto slow =
+      poller.submit(makeJob(5, slowPolls, std::chrono::milliseconds(10)));
+  auto fast =
+      poller.submit(makeJob(1, fastPolls, std::chrono::milliseconds(10)));
+
+  // The second job is done while the first one is still being polled.
+  EXPECT_EQ(fast.get()["polls"], 1);
+  EXPECT_LT(slowPolls, 5);
+  EXPECT_EQ(slow.get()["polls"], 5);
+  EXPECT_EQ(slowPolls, 5);
+  EXPECT_EQ(fastPolls, 1);
+}
+
+TEST(JobPollerTester, checkZeroIntervalDoesNotSpin) {
+  std::atomic<int> polls = 0;
+  JobPoller poller;
+  auto job = poller.submit(makeJob(1000000, polls, {}));
+
+  // With the minimum interval and the exponential backoff, a job is polled
+  // only a handful of times in this period, instead of continuously.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_GT(polls, 1);
+  EXPECT_LT(polls, 20);
+}
+
+TEST(JobPollerTester, checkBackoff) {
+  std::atomic<int> polls = 0;
+  JobPoller poller;
+  auto start = JobPoller::Clock::now();
+  auto job = poller.submit(makeJob(4, polls, std::chrono::milliseconds(10)));
+  job.wait();
+
+  // The job is polled again after 10, 20 and 40 ms.
+  EXPECT_GE(JobPoller::Clock::now() - start, std::chrono::milliseconds(70));
+}
+
+TEST(JobPollerTester, checkPollException) {
+  std::atomic<int> polls = 0;
+  JobPoller poller;
+  auto failing = poller.submit([]() -> JobPoller::PollResult {
+    throw std::runtime_error("Job failed.");
+  });
+  auto job = poller.submit(makeJob(2, polls, std::chrono::milliseconds(1)));
+
+  // A failing poll only fails its own job.
+  EXPECT_THROW(failing.get(), std::runtime_error);
+  EXPECT_EQ(job.get()["polls"], 2);
+}
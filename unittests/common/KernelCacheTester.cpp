@@ -0,0 +1,61 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+#include "common/KernelCache.h"
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+TEST(KernelCacheTester, checkReuse) {
+  cudaq::KernelCache<int> cache(4);
+  int numCompiles = 0;
+  auto compile = [&]() { return ++numCompiles; };
+  EXPECT_EQ(cache.get("a", compile), 1);
+  EXPECT_EQ(cache.get("b", compile), 2);
+  EXPECT_EQ(cache.get("a", compile), 1);
+  EXPECT_EQ(numCompiles, 2);
+  EXPECT_EQ(cache.size(), 2);
+}
+
+TEST(KernelCacheTester, checkEviction) {
+  std::vector<int> evicted;
+  auto onEvict = [&](int &kernel) { evicted.push_back(kernel); };
+  cudaq::KernelCache<int> cache(2, onEvict);
+  int numCompiles = 0;
+  auto compile = [&]() { return ++numCompiles; };
+  cache.get("a", compile);
+  cache.get("b", compile);
+  cache.get("c", compile);
+  EXPECT_EQ(evicted, std::vector<int>{1});
+  EXPECT_EQ(cache.size(), 2);
+  // "a" was evicted, so it is compiled again, which evicts "b".
+  EXPECT_EQ(cache.get("a", compile), 4);
+  EXPECT_EQ(evicted, (std::vector<int>{1, 2}));
+}
+
+TEST(KernelCacheTester, checkFailedCompilation) {
+  std::vector<int> evicted;
+  auto onEvict = [&](int &kernel) { evicted.push_back(kernel); };
+  cudaq::KernelCache<int> cache(2, onEvict);
+  int numCompiles = 0;
+  auto compile = [&]() { return ++numCompiles; };
+  auto fail = []() -> int { throw std::runtime_error("Failed to compile"); };
+  cache.get("a", compile);
+  cache.get("b", compile);
+
+  // A failed compilation neither evicts a kernel nor caches anything.
+  EXPECT_THROW(cache.get("c", fail), std::runtime_error);
+  EXPECT_TRUE(evicted.empty());
+  EXPECT_EQ(cache.size(), 2);
+
+  // Later requests still work, including ones that evict kernels.
+  EXPECT_EQ(cache.get("c", compile), 3);
+  EXPECT_EQ(cache.get("d", compile), 4);
+  EXPECT_EQ(evicted, (std::vector<int>{1, 2}));
+  EXPECT_EQ(cache.get("d", compile), 4);
+  EXPECT_EQ(cache.size(), 2);
+}
@@ -1493,3 +1493,16 @@ CUDAQ_TEST(BuilderTester, checkMidCircuitMeasureWithReset) {
       match = false;
   EXPECT_EQ(match, false);
 }
+
+CUDAQ_TEST(BuilderTester, checkTieredJitIsOptIn) {
+  if (std::getenv("CUDAQ_BUILDER_JIT_TIER_UP"))
+    GTEST_SKIP() << "Tiered compilation is enabled in the environment.";
+  auto kernel = cudaq::make_kernel();
+  auto q = kernel.qalloc();
+  kernel.x(q);
+  kernel.mz(q);
+  for (int i = 0; i < 3; ++i)
+    EXPECT_EQ(cudaq::sample(10, kernel).count("1"), 10);
+  EXPECT_EQ(kernel.getTieredJitStatus(),
+            cudaq::details::TieredJitStatus::Disabled);
+}
@@ -0,0 +1,77 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+
+// These tests are run with CUDAQ_BUILDER_JIT_TIER_UP=2, so that kernels are
+// recompiled with optimizations on their second invocation.
+
+#include "CUDAQTestUtils.h"
+#include <chrono>
+#include <cudaq/algorithm.h>
+#include <cudaq/builder.h>
+#include <cudaq/builder/kernel_builder_testing.h>
+#include <thread>
+
+namespace {
+/// Wait for the optimized recompilation of \p kernel to finish.
+template <typename KernelT>
+cudaq::details::TieredJitStatus waitForTierUp(KernelT &kernel) {
+  using cudaq::details::TieredJitStatus;
+  auto status = kernel.getTieredJitStatus();
+  for (int i = 0; i < 600 && status == TieredJitStatus::Compiling; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    status = kernel.getTieredJitStatus();
+  }
+  return status;
+}
+
+/// Check that \p kernel flips its qubit for an angle of pi.
+template <typename KernelT>
+void expectFlip(KernelT &kernel) {
+  auto counts = cudaq::sample(100, kernel, M_PI);
+  EXPECT_EQ(counts.count("1"), 100);
+}
+} // namespace
+
+CUDAQ_TEST(BuilderTieredJitTester, checkTierUp) {
+  auto [kernel, theta] = cudaq::make_kernel<double>();
+  auto q = kernel.qalloc();
+  kernel.ry(theta, q);
+  kernel.mz(q);
+
+  expectFlip(kernel);
+  EXPECT_EQ(kernel.getTieredJitStatus(),
+            cudaq::details::TieredJitStatus::Unoptimized);
+
+  // The second invocation starts the optimized recompilation.
+  expectFlip(kernel);
+  EXPECT_EQ(waitForTierUp(kernel), cudaq::details::TieredJitStatus::Optimized);
+
+  // Subsequent invocations run the optimized code.
+  expectFlip(kernel);
+  auto counts = cudaq::sample(100, kernel, 0.);
+  EXPECT_EQ(counts.count("0"), 100);
+}
+
+CUDAQ_TEST(BuilderTieredJitTester, checkTierUpFailure) {
+  cudaq::details::setTieredJitFailureForTesting(true);
+  auto [kernel, theta] = cudaq::make_kernel<double>();
+  auto q = kernel.qalloc();
+  kernel.ry(theta, q);
+  kernel.mz(q);
+
+  expectFlip(kernel);
+  expectFlip(kernel);
+  EXPECT_EQ(waitForTierUp(kernel), cudaq::details::TieredJitStatus::Failed);
+  cudaq::details::setTieredJitFailureForTesting(false);
+
+  // The kernel keeps running the unoptimized code, without retrying.
+  for (int i = 0; i < 3; ++i)
+    expectFlip(kernel);
+  EXPECT_EQ(kernel.getTieredJitStatus(),
+            cudaq::details::TieredJitStatus::Failed);
+}
@@ -104,4 +104,43 @@ CUDAQ_TEST(D2VariationalTester, checkBroadcast) {
   });
 }
 
+CUDAQ_TEST(D2VariationalTester, checkSweep) {
+
+  using namespace cudaq::spin;
+
+  cudaq::spin_op h = 5.907 - 2.1433 * x(0) * x(1) - 2.1433 * y(0) * y(1) +
+                     .21829 * z(0) - 6.125 * z(1);
+
+  auto ansatz = [](std::vector<double> thetas) __qpu__ {
+    cudaq::qvector q(2);
+    x(q[0]);
+    ry(thetas[0], q[1]);
+    x<cudaq::ctrl>(q[1], q[0]);
+    rz(thetas[1], q[1]);
+  };
+
+  // Row-major matrix of 2 parameters per row.
+  constexpr std::size_t numParams = 2;
+  const auto thetas = cudaq::linspace(-M_PI, M_PI, 5);
+  std::vector<double> params;
+  for (auto theta0 : thetas)
+    for (auto theta1 : thetas) {
+      params.push_back(theta0);
+      params.push_back(theta1);
+    }
+
+  auto results = cudaq::observe_sweep(ansatz, h, params, numParams);
+  ASSERT_EQ(results.size(), params.size() / numParams);
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    std::vector<double> row(params.begin() + i * numParams,
+                            params.begin() + (i + 1) * numParams);
+    EXPECT_NEAR(results[i], cudaq::observe(ansatz, h, row).expectation(),
+                1e-6);
+  }
+
+  // The parameters must form a matrix with `numParams` columns.
+  EXPECT_ANY_THROW(cudaq::observe_sweep(ansatz, h, params, 3));
+  EXPECT_ANY_THROW(cudaq::observe_sweep(ansatz, h, params, 0));
+}
+
 #endif
@@ -9,6 +9,8 @@
 #include "CUDAQTestUtils.h"
 #include <cudaq/algorithm.h>
 #include <cudaq/algorithms/gradients/central_difference.h>
+#include <cudaq/algorithms/gradients/forward_difference.h>
+#include <cudaq/algorithms/gradients/parameter_shift.h>
 #include <cudaq/optimizers.h>
 
 #ifndef CUDAQ_BACKEND_STIM
@@ -75,6 +77,37 @@ CUDAQ_TEST(GradientTester, checkSimple) {
   EXPECT_NEAR(-2.0453, opt_val, 1e-3);
 }
 
+CUDAQ_TEST(GradientTester, checkBatched) {
+  using namespace cudaq::spin;
+
+  cudaq::spin_op h = 5.907 - 2.1433 * x(0) * x(1) - 2.1433 * y(0) * y(1) +
+                     .21829 * z(0) - 6.125 * z(1);
+  cudaq::spin_op h3 = h + 9.625 - 9.625 * z(2) - 3.913119 * x(1) * x(2) -
+                      3.913119 * y(1) * y(2);
+  auto argMapper = [](std::vector<double> x) {
+    return std::make_tuple(x[0], x[1]);
+  };
+  const std::vector<double> x{.3, -.2};
+  const double e = cudaq::observe(deuteron_n3_ansatz{}, h3, x[0], x[1]);
+
+  auto check = [&](cudaq::gradient &gradient) {
+    std::vector<double> expected(2), batched(2);
+    gradient.compute(x, expected, h3, e);
+    gradient.batched = true;
+    gradient.compute(x, batched, h3, e);
+    for (std::size_t i = 0; i < x.size(); i++)
+      EXPECT_NEAR(expected[i], batched[i], 1e-6);
+  };
+  cudaq::gradients::central_difference central(deuteron_n3_ansatz{},
+                                               argMapper);
+  check(central);
+  cudaq::gradients::forward_difference forward(deuteron_n3_ansatz{},
+                                               argMapper);
+  check(forward);
+  cudaq::gradients::parameter_shift shift(deuteron_n3_ansatz{}, argMapper);
+  check(shift);
+}
+
 #endif
 
 #endif
@@ -12,6 +12,7 @@
 
 #include <cudaq/algorithms/gradients/central_difference.h>
 #include <cudaq/optimizers.h>
+#include <cudaq/platform/qpu.h>
 
 // Stim does not support rotational gates
 #ifndef CUDAQ_BACKEND_STIM
@@ -127,6 +128,68 @@ CUDAQ_TEST_F(VQETester, checkSpsa) {
   EXPECT_NEAR(opt_val, -1.1371, 1e-3);
 }
 
+CUDAQ_TEST(OptimizerTester, checkBatchedSpsa) {
+  // Quadratic objective with its minimum 0 at (0.5, -0.3).
+  auto objective = [](const std::vector<double> &x) {
+    return (x[0] - 0.5) * (x[0] - 0.5) + 2. * (x[1] + 0.3) * (x[1] + 0.3);
+  };
+
+  cudaq::optimizers::spsa opt;
+  auto [opt_val, opt_params] =
+      opt.optimize(2, [&](const std::vector<double> &x, std::vector<double> &) {
+        return objective(x);
+      });
+
+  cudaq::optimizers::batched_spsa batched;
+  batched.seed = 13;
+  batched.max_eval = 400;
+  auto [batched_val, batched_params] = batched.optimize_batch(
+      2, [&](const std::vector<std::vector<double>> &points) {
+        std::vector<double> values;
+        for (auto &x : points)
+          values.push_back(objective(x));
+        return values;
+      });
+
+  // Both optimizers find the minimum.
+  EXPECT_NEAR(batched_val, opt_val, 1e-2);
+  EXPECT_NEAR(batched_params[0], opt_params[0], 0.1);
+  EXPECT_NEAR(batched_params[1], opt_params[1], 0.1);
+  EXPECT_NEAR(batched_params[0], 0.5, 0.1);
+  EXPECT_NEAR(batched_params[1], -0.3, 0.1);
+
+  // Evaluating the points one by one gives the same optimization.
+  cudaq::optimizers::batched_spsa sequential;
+  sequential.seed = 13;
+  sequential.max_eval = 400;
+  auto [sequential_val, sequential_params] = sequential.optimize(
+      2, [&](const std::vector<double> &x, std::vector<double> &) {
+        return objective(x);
+      });
+  EXPECT_EQ(sequential_val, batched_val);
+  EXPECT_EQ(sequential_params, batched_params);
+}
+
+CUDAQ_TEST_F(VQETester, checkPopulationOptimizers) {
+  cudaq::optimizers::differential_evolution de;
+  de.seed = 13;
+  de.max_eval = 200;
+  auto [de_val, de_params] = cudaq::vqe(ansatz_compute_action{}, *H, de, 1);
+  EXPECT_NEAR(de_val, -1.1371, 1e-3);
+
+  cudaq::optimizers::cmaes cma;
+  cma.seed = 13;
+  cma.max_eval = 200;
+  auto [cma_val, cma_params] = cudaq::vqe(ansatz_compute_action{}, *H, cma, 1);
+  EXPECT_NEAR(cma_val, -1.1371, 1e-3);
+
+  cudaq::optimizers::multistart_lbfgs lbfgs;
+  lbfgs.seed = 13;
+  auto [lbfgs_val, lbfgs_params] =
+      cudaq::vqe(ansatz_compute_action{}, *H, lbfgs, 1);
+  EXPECT_NEAR(lbfgs_val, -1.1371, 1e-3);
+}
+
 CUDAQ_TEST_F(VQETester, checkDifferentArgStructure) {
   cudaq::optimizers::cobyla c_opt;
   auto argMapper = [](std::vector<double> x) { return std::make_tuple(x[0]); };
@@ -155,6 +218,154 @@ CUDAQ_TEST_F(VQETester, checkGradientBased) {
   EXPECT_NEAR(opt_val2, -1.1371, 1e-3);
 }
 
+namespace {
+/// A QPU that runs its tasks in order on its own thread, and counts them.
+class CountingQpu : public cudaq::QPU {
+public:
+  explicit CountingQpu(std::size_t id) : QPU(id) {}
+
+  void enqueue(cudaq::QuantumTask &task) override {
+    ++launches;
+    execution_queue->enqueue(task);
+  }
+
+  void launchKernel(const std::string &, void (*)(void *), void *,
+                    std::uint64_t, std::uint64_t,
+                    const std::vector<void *> &) override {}
+
+  void setExecutionContext(cudaq::ExecutionContext *context) override {
+    currentContext = context;
+    currentQpu = qpu_id;
+  }
+
+  void resetExecutionContext() override { currentContext = nullptr; }
+
+  std::atomic<std::size_t> launches = 0;
+  /// The context and the QPU of the evaluation running on this thread.
+  static inline thread_local cudaq::ExecutionContext *currentContext = nullptr;
+  static inline thread_local std::size_t currentQpu = 0;
+};
+
+/// A platform of counting QPUs.
+class CountingPlatform : public cudaq::quantum_platform {
+public:
+  explicit CountingPlatform(std::size_t numQpus) {
+    for (std::size_t i = 0; i < numQpus; ++i)
+      platformQPUs.emplace_back(std::make_unique<CountingQpu>(i));
+    platformNumQPUs = numQpus;
+  }
+
+  std::size_t getLaunches(std::size_t qpuId) const {
+    return static_cast<CountingQpu &>(*platformQPUs[qpuId]).launches;
+  }
+};
+
+/// Records the invocations of the ansatz, whose energy is computed on the host
+/// from the parameters.
+struct InvocationRecorder {
+  std::function<double(const std::vector<double> &)> energy;
+  std::mutex mutex;
+  std::vector<std::pair<std::vector<double>, std::size_t>> invocations;
+
+  cudaq::details::PipelinedEvaluator::KernelInvoker invoker() {
+    return [this](const std::vector<double> &x) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        invocations.emplace_back(x, CountingQpu::currentQpu);
+      }
+      CountingQpu::currentContext->expectationValue = energy(x);
+    };
+  }
+};
+} // namespace
+
+CUDAQ_TEST(PipelinedVqeTester, checkSpeculation) {
+  // The first step overshoots the minimum at 1, so that the first line search
+  // candidate, and the gradient speculatively launched there, are discarded.
+  cudaq::gradients::central_difference gradient;
+  auto H = cudaq::spin::z(0);
+  cudaq::pipelined_vqe_options options;
+  options.initial_step = 5.0;
+  std::map<bool, std::size_t> launches;
+  for (const bool speculate : {false, true}) {
+    CountingPlatform platform(1);
+    InvocationRecorder recorder;
+    recorder.energy = [](const std::vector<double> &x) {
+      return 10.0 * (x[0] - 1.0) * (x[0] - 1.0);
+    };
+    options.speculate = speculate;
+    auto [opt_val, opt_params] = cudaq::details::runPipelinedVqe(
+        recorder.invoker(), "ansatz", platform, gradient, H, 1, options);
+    EXPECT_NEAR(opt_val, 0.0, 1e-6);
+    EXPECT_NEAR(opt_params[0], 1.0, 1e-3);
+    launches[speculate] = platform.getLaunches(0);
+    // Cancelled evaluations are launched but not invoked.
+    EXPECT_LE(recorder.invocations.size(), launches[speculate]);
+  }
+  // The speculative gradient at the first candidate, two points with central
+  // differences, is launched on top of the same evaluations.
+  EXPECT_GE(launches[true], launches[false] + 2);
+}
+
+CUDAQ_TEST(PipelinedVqeTester, checkRetainCancelsPending) {
+  CountingPlatform platform(1);
+  InvocationRecorder recorder;
+  std::promise<void> gate;
+  auto gateFuture = gate.get_future().share();
+  recorder.energy = [&](const std::vector<double> &x) {
+    // Keep the QPU busy, so that the next evaluations stay pending.
+    if (x[0] == 0.0)
+      gateFuture.wait();
+    return x[0];
+  };
+  auto H = cudaq::spin::z(0);
+  cudaq::details::PipelinedEvaluator evaluator(recorder.invoker(), H, platform,
+                                               -1, "ansatz");
+  for (double x : {0.0, 1.0, 2.0})
+    evaluator.prefetch({x});
+  evaluator.retain({{0.0}});
+  gate.set_value();
+  EXPECT_EQ(evaluator.get({0.0}), 0.0);
+
+  // The cancelled tasks are skipped, and never invoke the kernel.
+  EXPECT_EQ(evaluator.get({3.0}), 3.0);
+  EXPECT_EQ(platform.getLaunches(0), 4);
+  ASSERT_EQ(recorder.invocations.size(), 2);
+  EXPECT_EQ(recorder.invocations[0].first, std::vector<double>{0.0});
+  EXPECT_EQ(recorder.invocations[1].first, std::vector<double>{3.0});
+}
+
+CUDAQ_TEST(PipelinedVqeTester, checkRoundRobin) {
+  CountingPlatform platform(3);
+  InvocationRecorder recorder;
+  recorder.energy = [](const std::vector<double> &x) { return x[0]; };
+  auto H = cudaq::spin::z(0);
+  cudaq::details::PipelinedEvaluator evaluator(recorder.invoker(), H, platform,
+                                               -1, "ansatz");
+  for (int i = 0; i < 6; ++i)
+    evaluator.prefetch({double(i)});
+  for (int i = 0; i < 6; ++i)
+    EXPECT_EQ(evaluator.get({double(i)}), i);
+  for (std::size_t qpuId = 0; qpuId < 3; ++qpuId)
+    EXPECT_EQ(platform.getLaunches(qpuId), 2);
+  for (const auto &[x, qpuId] : recorder.invocations)
+    EXPECT_EQ(qpuId, static_cast<std::size_t>(x[0]) % 3);
+}
+
+CUDAQ_TEST_F(VQETester, checkPipelined) {
+  cudaq::gradients::central_difference gradient;
+  auto [opt_val, opt_params] =
+      cudaq::pipelined_vqe(ansatz_compute_action{}, gradient, *H, 1, {});
+  EXPECT_NEAR(opt_val, -1.1371, 1e-3);
+
+  cudaq::pipelined_vqe_options options;
+  options.speculate = false;
+  options.line_search_candidates = 1;
+  auto [opt_val2, opt_params2] =
+      cudaq::pipelined_vqe(ansatz_compute_action{}, gradient, *H, 1, options);
+  EXPECT_NEAR(opt_val2, -1.1371, 1e-3);
+}
+
 CUDAQ_TEST_F(VQETester, checkBuilderVqe) {
   cudaq::optimizers::lbfgs l_opt;
 
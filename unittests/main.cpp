@@ -6,9 +6,16 @@
  * the terms of the Apache License 2.0 which accompanies this distribution.    *
  ******************************************************************************/
 
+#include <cstdlib>
 #include <gtest/gtest.h>
 
 int main(int argc, char **argv) {
+#ifdef CUDAQ_BACKEND_CPU_MPS
+  // The tests compare with exact results, so the matrix product states are
+  // only truncated to the maximum bond dimension, not by the cutoffs.
+  setenv("CUDAQ_MPS_ABS_CUTOFF", "1e-12", 0);
+  setenv("CUDAQ_MPS_RELATIVE_CUTOFF", "1e-12", 0);
+#endif
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
 }
@@ -0,0 +1,118 @@
+/*******************************************************************************
+ * Copyright (c) 2022 - 2024 NVIDIA Corporation & Affiliates.                  *
+ * All rights reserved.                                                        *
+ *                                                                             *
+ * This source code and the accompanying materials are made available under    *
+ * the terms of the Apache License 2.0 which accompanies this distribution.    *
+ ******************************************************************************/
+#include "CpuMpiCircuitSimulator.h"
+#include "backends/CpuSimulatorTestUtils.h"
+#include <cudaq.h>
+#include <gtest/gtest.h>
+
+// The state is distributed from this many qubits, see `main`.
+constexpr std::size_t numQubits = 9;
+
+namespace {
+constexpr double tolerance = 1e-10;
+} // namespace
+
+TEST(CpuMpiTester, checkDistributedGates) {
+  nvqir::CpuMpiCircuitSimulator<double> sim;
+  nvqir::CpuCircuitSimulator<double> reference;
+  // The state is distributed when its qubit count reaches the threshold.
+  auto qubits = sim.allocateQubits(numQubits - 2);
+  reference.allocateQubits(numQubits - 2);
+  sim.h(qubits[0]);
+  reference.h(qubits[0]);
+  EXPECT_FALSE(sim.isStateDistributed());
+  auto added = sim.allocateQubits(2);
+  reference.allocateQubits(2);
+  qubits.insert(qubits.end(), added.begin(), added.end());
+  EXPECT_EQ(sim.isStateDistributed(), cudaq::mpi::num_ranks() > 1);
+  nvqir::test::applyTestCircuit(sim, qubits);
+  nvqir::test::applyTestCircuit(reference, qubits);
+  nvqir::test::expectStateNear(sim.getStateVector(),
+                               reference.getStateVector(), tolerance);
+
+  // Qubits added to a distributed state are local.
+  auto more = sim.allocateQubits(2);
+  reference.allocateQubits(2);
+  sim.h(more[1]);
+  reference.h(more[1]);
+  sim.x({more[1]}, qubits.back());
+  reference.x({more[1]}, qubits.back());
+  nvqir::test::expectStateNear(sim.getStateVector(),
+                               reference.getStateVector(), tolerance);
+  sim.deallocateQubits(more);
+  sim.deallocateQubits(qubits);
+}
+
+TEST(CpuMpiTester, checkMeasureAndSample) {
+  nvqir::CpuMpiCircuitSimulator<double> sim;
+  EXPECT_EQ(sim.name(), "cpu-mpi");
+  auto qubits = sim.allocateQubits(numQubits);
+  nvqir::test::applyTestCircuit(sim, qubits);
+
+  cudaq::ExecutionContext ctx("sample", 1000);
+  sim.setExecutionContext(&ctx);
+  for (auto q : qubits)
+    sim.mz(q);
+  sim.resetExecutionContext();
+  // The shots are sampled on every rank, with the seed of rank 0.
+  const auto counts = ctx.result.to_map();
+  std::size_t numShots = 0;
+  for (auto &[bits, count] : counts)
+    numShots += count;
+  EXPECT_EQ(numShots, 1000);
+  const auto &[bits, count] = *counts.begin();
+  EXPECT_EQ(cudaq::mpi::all_reduce(static_cast<double>(count),
+                                   std::plus<double>()),
+            count * cudaq::mpi::num_ranks());
+
+  // The results agree across ranks.
+  const bool result = sim.mz(qubits.back());
+  EXPECT_EQ(cudaq::mpi::all_reduce(result ? 1.0 : 0.0, std::plus<double>()),
+            result ? cudaq::mpi::num_ranks() : 0);
+  sim.resetQubit(qubits.back());
+  EXPECT_FALSE(sim.mz(qubits.back()));
+  sim.deallocateQubits(qubits);
+}
+
+TEST(CpuMpiTester, checkObserveAndExpPauli) {
+  nvqir::CpuMpiCircuitSimulator<double> sim;
+  nvqir::CpuCircuitSimulator<double> reference;
+  auto qubits = sim.allocateQubits(numQubits);
+  reference.allocateQubits(numQubits);
+  nvqir::test::applyTestCircuit(sim, qubits);
+  nvqir::test::applyTestCircuit(reference, qubits);
+
+  using cudaq::spin::x, cudaq::spin::y, cudaq::spin::z;
+  const std::size_t last = numQubits - 1;
+  const auto op = x(last) * z(0) + 0.5 * y(1) * z(last - 1) * x(last) +
+                  z(last) * z(last - 1) - 2.0 * y(last - 1);
+  EXPECT_NEAR(sim.observe(op).expectation(),
+              reference.observe(op).expectation(), tolerance);
+
+  const auto pauli = x(0) * y(1) * z(2);
+  const std::vector<std::size_t> targets{last, 2, last - 1};
+  sim.applyExpPauli(0.41, {3}, targets, pauli);
+  reference.applyExpPauli(0.41, {3}, targets, pauli);
+  sim.applyExpPauli(-0.2, {last}, {0, last - 1}, z(0) * z(1));
+  reference.applyExpPauli(-0.2, {last}, {0, last - 1}, z(0) * z(1));
+  nvqir::test::expectStateNear(sim.getStateVector(),
+                               reference.getStateVector(), tolerance);
+  sim.deallocateQubits(qubits);
+}
+
+int main(int argc, char **argv) {
+  // Distribute the states of the tests, which have at least 9 qubits, so that
+  // they are distributed on up to 8 ranks.
+  setenv("CUDAQ_CPU_MPI_NQUBITS_THRESH", std::to_string(numQubits).c_str(),
+         0);
+  ::testing::InitGoogleTest(&argc, argv);
+  cudaq::mpi::initialize();
+  const auto testResult = RUN_ALL_TESTS();
+  cudaq::mpi::finalize();
+  return testResult;
+}
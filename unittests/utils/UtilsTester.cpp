@@ -209,3 +209,114 @@ TEST(UtilsTester, JsonSerDesGradient) {
     EXPECT_EQ(j.dump(), j2.dump());
   }
 }
+
+namespace {
+/// Return a normalized state of \p numQubits qubits with distinct amplitudes.
+std::vector<std::complex<double>> makeAmplitudes(std::size_t numQubits) {
+  std::vector<std::complex<double>> amplitudes(1ULL << numQubits);
+  double norm = 0.0;
+  for (std::size_t i = 0; i < amplitudes.size(); ++i) {
+    amplitudes[i] = {0.1 + i, -0.3 * i};
+    norm += std::norm(amplitudes[i]);
+  }
+  for (auto &amplitude : amplitudes)
+    amplitude /= std::sqrt(norm);
+  return amplitudes;
+}
+
+/// Set the simulation state of \p context to \p amplitudes.
+void setState(cudaq::ExecutionContext &context,
+              std::vector<std::complex<double>> amplitudes) {
+  context.simulationState = cudaq::get_simulator()->createStateFromData(
+      std::make_pair(amplitudes.data(), amplitudes.size()));
+}
+
+/// Return the amplitudes of the simulation state of \p context.
+std::vector<std::complex<double>>
+getAmplitudes(const cudaq::ExecutionContext &context) {
+  const auto &state = *context.simulationState;
+  const auto *data =
+      reinterpret_cast<const std::complex<double> *>(state.getTensor().data);
+  return {data, data + state.getNumElements()};
+}
+} // namespace
+
+TEST(UtilsTester, JsonSerDesBinaryState) {
+  // The binary data of an odd and an even number of qubits ends with one and
+  // two padding characters. Since states have 2^n amplitudes of 16 bytes,
+  // base64 data without padding never occurs.
+  for (std::size_t numQubits = 1; numQubits <= 4; ++numQubits) {
+    const auto amplitudes = makeAmplitudes(numQubits);
+    cudaq::ExecutionContext context("extract-state");
+    setState(context, amplitudes);
+    const auto j = cudaq::serializeWithBinaryState(context);
+    ASSERT_TRUE(j["simulationData"].contains("binaryData"));
+    EXPECT_FALSE(j["simulationData"].contains("data"));
+    const auto binaryData =
+        j["simulationData"]["binaryData"].get<std::string>();
+    const auto padding =
+        binaryData.size() - binaryData.find_last_not_of('=') - 1;
+    EXPECT_EQ(padding, numQubits % 2 ? 1 : 2) << numQubits;
+
+    cudaq::ExecutionContext deserialized("extract-state");
+    from_json(j, deserialized);
+    EXPECT_EQ(getAmplitudes(deserialized), amplitudes) << numQubits;
+
+    // The text format gives the same amplitudes.
+    cudaq::ExecutionContext fromText("extract-state");
+    from_json(json(context), fromText);
+    EXPECT_EQ(getAmplitudes(fromText), amplitudes) << numQubits;
+  }
+}
+
+TEST(UtilsTester, JsonSerDesBinaryStateMismatch) {
+  cudaq::ExecutionContext context("extract-state");
+  setState(context, makeAmplitudes(2));
+  const auto j = cudaq::serializeWithBinaryState(context);
+  cudaq::ExecutionContext deserialized("extract-state");
+
+  // Data that is shorter or longer than the dimension.
+  auto truncated = j;
+  truncated["simulationData"]["binaryData"] =
+      j["simulationData"]["binaryData"].get<std::string>().substr(0, 80);
+  EXPECT_THROW(from_json(truncated, deserialized), std::runtime_error);
+  auto larger = j;
+  larger["simulationData"]["dim"] = std::vector<std::size_t>{2};
+  EXPECT_THROW(from_json(larger, deserialized), std::runtime_error);
+
+  // Invalid base64 data.
+  auto invalid = j;
+  invalid["simulationData"]["binaryData"] = "not base64!";
+  EXPECT_THROW(from_json(invalid, deserialized), std::runtime_error);
+
+  // Text data that does not match the dimension.
+  json text = context;
+  text["simulationData"]["dim"] = std::vector<std::size_t>{8};
+  EXPECT_THROW(from_json(text, deserialized), std::runtime_error);
+}
+
+TEST(UtilsTester, JsonSerDesResponseForOldClient) {
+  const auto amplitudes = makeAmplitudes(3);
+  cudaq::ExecutionContext context("extract-state");
+  cudaq::RestRequest request(context,
+                             cudaq::RestRequest::REST_PAYLOAD_VERSION);
+  request.format = cudaq::CodeFormat::MLIR;
+  request.seed = 0;
+  const json requestJson = request;
+  EXPECT_TRUE(requestJson["acceptsBinaryData"].get<bool>());
+
+  // Older clients do not advertise binary data, and get a JSON array.
+  for (const bool oldClient : {true, false}) {
+    auto sent = requestJson;
+    if (oldClient)
+      sent.erase("acceptsBinaryData");
+    cudaq::RestRequest received(sent);
+    setState(received.executionContext, amplitudes);
+    const auto response = cudaq::serializeResponseContext(received);
+    EXPECT_EQ(response["simulationData"].contains("data"), oldClient);
+    EXPECT_EQ(response["simulationData"].contains("binaryData"), !oldClient);
+    cudaq::ExecutionContext deserialized("extract-state");
+    from_json(response, deserialized);
+    EXPECT_EQ(getAmplitudes(deserialized), amplitudes);
+  }
+}